@@ -43,6 +43,32 @@ I2Cerror i2cReadSlaveRegister(unsigned char devAddW, unsigned char regAdd, unsig
     return OK;
 }
 
+I2Cerror i2cReadSlaveRegisters(unsigned char devAddW, unsigned char regAdd, unsigned char *data, unsigned char length)
+{
+    i2c1_driver_start();
+    if(_i2cMasterSend(devAddW) == NACK)
+        return BAD_ADDR;
+    if(_i2cMasterSend(regAdd) == NACK)
+        return BAD_REG;
+
+    i2c1_driver_restart();
+    if(_i2cMasterSend(devAddW | 1) == NACK)
+        return BAD_ADDR;
+
+    while(length--)
+    {
+        i2c1_driver_startRX();
+        i2c1_driver_waitRX();
+        *data++ = i2c1_driver_getRXData();
+        if(length)
+            i2c1_driver_sendACK();
+        else
+            i2c1_driver_sendNACK();
+    }
+    i2c1_driver_stop();
+    return OK;
+}
+
 I2Cerror i2cWriteSlave(unsigned char devAddW, unsigned char regAdd, unsigned char data)
 {
     i2c1_driver_start();
@@ -9,4 +9,5 @@ typedef enum {OK, NACK, ACK, BAD_ADDR, BAD_REG} I2Cerror;
 
 void i2c1_open(void);
 I2Cerror i2cReadSlaveRegister(unsigned char devAddW, unsigned char regAdd, unsigned char *reg);
+I2Cerror i2cReadSlaveRegisters(unsigned char devAddW, unsigned char regAdd, unsigned char *data, unsigned char length);
 I2Cerror i2cWriteSlave(unsigned char devAddW, unsigned char regAdd, unsigned char data);
@@ -0,0 +1,193 @@
+/*
+ * File: crc.c
+ * Project: Smart Watch - Final Version
+ * Description: Driver for the 32-bit programmable CRC module.
+ *
+ * The module is an augmented shift register: data enters at the low end
+ * and the result is only a standard ("direct") CRC after the message has
+ * been followed by `width` zero bits. The direct seed is therefore run
+ * backwards through `width` zero bits before it is loaded, and Finish
+ * appends the zero bits. Reflected CRCs shift data in LSb first
+ * (LENDIAN) and reflect the register at the end.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "crc.h"
+
+#define CRC_WORD_WIDTH    15   // DWIDTH: 16-bit FIFO entries
+#define CRC_BYTE_WIDTH    7    // DWIDTH: 8-bit FIFO entries
+
+static const CRC_CONFIG *activeConfig;
+static volatile bool engineBusy = false;
+static bool hasPendingByte;
+static uint8_t pendingByte;
+static bool shifting;       // data pushed since the last wait
+
+static uint32_t augmentedSeed(const CRC_CONFIG *config)
+{
+    uint32_t topBit = 1UL << (config->width - 1);
+    uint32_t value = config->seed;
+
+    for (uint8_t i = 0; i < config->width; i++)
+    {
+        bool feedback = value & 1;  // polynomial bit 0 is always set
+        if (feedback)
+            value ^= config->polynomial;
+        value >>= 1;
+        if (feedback)
+            value |= topBit;
+    }
+    return value;
+}
+
+// CRCIF is cleared before the write, so only completion after this entry
+// counts and a fast shift cannot be missed
+static void pushWord(uint16_t word)
+{
+    while (CRCCON1Lbits.CRCFUL)
+        ;
+    IFS4bits.CRCIF = 0;
+    CRCDATL = word;
+    shifting = true;
+}
+
+static void pushByte(uint8_t byte)
+{
+    while (CRCCON1Lbits.CRCFUL)
+        ;
+    IFS4bits.CRCIF = 0;
+    *((volatile uint8_t *)&CRCDATL) = byte;
+    shifting = true;
+}
+
+// With nothing pushed since the last wait CRCIF never sets again, so only
+// the FIFO is checked
+static void waitShiftComplete(void)
+{
+    while (!CRCCON1Lbits.CRCMPT)
+        ;
+    if (shifting)
+    {
+        while (!IFS4bits.CRCIF)
+            ;
+        shifting = false;
+    }
+}
+
+static void setDataWidth(uint8_t width)
+{
+    waitShiftComplete();
+    CRCCON1Lbits.CRCGO = 0;
+    CRCCON2Lbits.DWIDTH = width;
+    CRCCON1Lbits.CRCGO = 1;
+}
+
+bool CRC_Start(const CRC_CONFIG *config)
+{
+    uint32_t seed;
+
+    if (engineBusy)
+        return false;
+    engineBusy = true;
+    activeConfig = config;
+    hasPendingByte = false;
+    shifting = false;
+
+    seed = augmentedSeed(config);
+    CRCCON1L = 0;
+    CRCCON1Lbits.CRCEN = 1;
+    CRCCON1Lbits.CRCISEL = 0;           // CRCIF when shifting is complete
+    CRCCON1Lbits.LENDIAN = config->reflected;
+    CRCCON2Lbits.PLEN = config->width - 1;
+    CRCCON2Lbits.DWIDTH = CRC_WORD_WIDTH;
+    CRCXORL = (uint16_t)(config->polynomial & 0xFFFF);
+    CRCXORH = (uint16_t)(config->polynomial >> 16);
+    CRCWDATL = (uint16_t)(seed & 0xFFFF);
+    CRCWDATH = (uint16_t)(seed >> 16);
+    IFS4bits.CRCIF = 0;
+    CRCCON1Lbits.CRCGO = 1;
+    return true;
+}
+
+void CRC_Update(const uint8_t *data, uint16_t length)
+{
+    uint8_t first;
+    uint8_t second;
+
+    if (length && hasPendingByte)
+    {
+        first = pendingByte;
+        second = *data++;
+        length--;
+        hasPendingByte = false;
+        pushWord(activeConfig->reflected ? ((uint16_t)second << 8) | first
+                                         : ((uint16_t)first << 8) | second);
+    }
+
+    // MSb-first words take the first byte in the high half; LSb-first
+    // (reflected) words take it in the low half.
+    while (length >= 2)
+    {
+        first = *data++;
+        second = *data++;
+        length -= 2;
+        pushWord(activeConfig->reflected ? ((uint16_t)second << 8) | first
+                                         : ((uint16_t)first << 8) | second);
+    }
+
+    if (length)
+    {
+        pendingByte = *data;
+        hasPendingByte = true;
+    }
+}
+
+uint32_t CRC_Finish(void)
+{
+    const CRC_CONFIG *config = activeConfig;
+    uint32_t mask = (config->width >= 32) ? 0xFFFFFFFFUL : ((1UL << config->width) - 1);
+    uint32_t result;
+    uint8_t zeroUnits;
+
+    if (hasPendingByte)
+    {
+        setDataWidth(CRC_BYTE_WIDTH);
+        pushByte(pendingByte);
+        hasPendingByte = false;
+        for (zeroUnits = config->width / 8; zeroUnits > 0; zeroUnits--)
+            pushByte(0);
+    }
+    else
+    {
+        for (zeroUnits = config->width / 16; zeroUnits > 0; zeroUnits--)
+            pushWord(0);
+    }
+    waitShiftComplete();
+
+    result = (((uint32_t)CRCWDATH << 16) | CRCWDATL) & mask;
+    CRCCON1Lbits.CRCGO = 0;
+    CRCCON1Lbits.CRCEN = 0;
+    IFS4bits.CRCIF = 0;
+    engineBusy = false;
+
+    if (config->reflected)
+        result = CRC_Reflect(result, config->width);
+    return (result ^ config->finalXor) & mask;
+}
+
+uint32_t CRC_Calculate(const CRC_CONFIG *config, const uint8_t *data, uint16_t length)
+{
+    CRC_SOFT_STATE state;
+
+    if (CRC_Start(config))
+    {
+        CRC_Update(data, length);
+        return CRC_Finish();
+    }
+
+    CRC_SoftStart(&state, config);
+    CRC_SoftUpdate(&state, data, length);
+    return CRC_SoftFinish(&state);
+}
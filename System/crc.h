@@ -0,0 +1,58 @@
+/*
+ * File: crc.h
+ * Project: Smart Watch - Final Version
+ * Description: CRC-16/CRC-32 through the programmable CRC module, plus a
+ *              portable software implementation producing identical results.
+ *
+ * crc_soft.c has no device dependencies and builds on a host compiler, so
+ * records and frames produced on the watch can be checked off-target.
+ */
+
+#ifndef CRC_H
+#define	CRC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint32_t polynomial;   // normal (MSb-first) form, implicit top bit
+    uint32_t seed;         // direct initial value
+    uint32_t finalXor;
+    uint8_t width;         // 16 or 32
+    bool reflected;        // reflect input bytes and the result
+} CRC_CONFIG;
+
+extern const CRC_CONFIG CRC_CONFIG_CCITT16;  // CRC-16/CCITT-FALSE, check 0x29B1
+extern const CRC_CONFIG CRC_CONFIG_CRC32;    // CRC-32 (IEEE 802.3), check 0xCBF43926
+
+/**
+ * Hardware engine. Data is handed over in any number of chunks of any
+ * length; the CPU only stores words into the module FIFO while the shifter
+ * does the polynomial arithmetic.
+ *
+ * CRC_Start returns false if another computation owns the engine (for
+ * example main-loop code preempted by an interrupt); the caller should then
+ * fall back to the software implementation.
+ */
+bool CRC_Start(const CRC_CONFIG *config);
+void CRC_Update(const uint8_t *data, uint16_t length);
+uint32_t CRC_Finish(void);
+
+// One-shot helper: hardware when free, software otherwise.
+uint32_t CRC_Calculate(const CRC_CONFIG *config, const uint8_t *data, uint16_t length);
+
+/**
+ * Software implementation (crc_soft.c), bit-exact with the hardware path.
+ */
+typedef struct {
+    const CRC_CONFIG *config;
+    uint32_t remainder;
+} CRC_SOFT_STATE;
+
+void CRC_SoftStart(CRC_SOFT_STATE *state, const CRC_CONFIG *config);
+void CRC_SoftUpdate(CRC_SOFT_STATE *state, const uint8_t *data, uint16_t length);
+uint32_t CRC_SoftFinish(const CRC_SOFT_STATE *state);
+
+uint32_t CRC_Reflect(uint32_t value, uint8_t width);
+
+#endif	/* CRC_H */
@@ -0,0 +1,71 @@
+/*
+ * File: crc_soft.c
+ * Project: Smart Watch - Final Version
+ * Description: Portable bitwise CRC matching the hardware CRC module.
+ *              Builds without xc.h so it can run on the host.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "crc.h"
+
+const CRC_CONFIG CRC_CONFIG_CCITT16 = { 0x1021, 0xFFFF, 0x0000, 16, false };
+const CRC_CONFIG CRC_CONFIG_CRC32 = { 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, 32, true };
+
+static uint32_t widthMask(uint8_t width)
+{
+    return (width >= 32) ? 0xFFFFFFFFUL : ((1UL << width) - 1);
+}
+
+uint32_t CRC_Reflect(uint32_t value, uint8_t width)
+{
+    uint32_t result = 0;
+    for (uint8_t i = 0; i < width; i++)
+    {
+        result = (result << 1) | (value & 1);
+        value >>= 1;
+    }
+    return result;
+}
+
+void CRC_SoftStart(CRC_SOFT_STATE *state, const CRC_CONFIG *config)
+{
+    state->config = config;
+    state->remainder = config->reflected ? CRC_Reflect(config->seed, config->width) : config->seed;
+}
+
+void CRC_SoftUpdate(CRC_SOFT_STATE *state, const uint8_t *data, uint16_t length)
+{
+    const CRC_CONFIG *config = state->config;
+    uint32_t remainder = state->remainder;
+
+    if (config->reflected)
+    {
+        uint32_t polynomial = CRC_Reflect(config->polynomial, config->width);
+        while (length--)
+        {
+            remainder ^= *data++;
+            for (uint8_t bit = 0; bit < 8; bit++)
+                remainder = (remainder & 1) ? (remainder >> 1) ^ polynomial : (remainder >> 1);
+        }
+    }
+    else
+    {
+        uint32_t topBit = 1UL << (config->width - 1);
+        uint32_t mask = widthMask(config->width);
+        while (length--)
+        {
+            remainder ^= (uint32_t)(*data++) << (config->width - 8);
+            for (uint8_t bit = 0; bit < 8; bit++)
+                remainder = (remainder & topBit) ? ((remainder << 1) ^ config->polynomial) : (remainder << 1);
+            remainder &= mask;
+        }
+    }
+
+    state->remainder = remainder;
+}
+
+uint32_t CRC_SoftFinish(const CRC_SOFT_STATE *state)
+{
+    return (state->remainder ^ state->config->finalXor) & widthMask(state->config->width);
+}
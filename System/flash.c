@@ -0,0 +1,82 @@
+/*
+ * File: flash.c
+ * Project: Smart Watch - Final Version
+ * Description: Self-programming access to the PIC24FJ256GA705 program flash.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "flash.h"
+
+#define FLASH_NVMOP_DOUBLE_WORD   0x4001  // WREN | NVMOP = double-word program
+#define FLASH_NVMOP_PAGE_ERASE    0x4003  // WREN | NVMOP = page erase
+#define FLASH_WRITE_LATCH_PAGE    0xFA
+
+static bool FLASH_Execute(uint32_t address, uint16_t operation)
+{
+    bool success;
+
+    NVMADRU = (uint16_t)(address >> 16);
+    NVMADR = (uint16_t)(address & 0xFFFF);
+    NVMCON = operation;
+    __builtin_write_NVM();      // unlock sequence + WR, interrupts held off
+    while (NVMCONbits.WR)
+        ;
+    success = !NVMCONbits.WRERR;
+    NVMCONbits.WREN = 0;
+    return success;
+}
+
+bool FLASH_ErasePage(uint32_t address)
+{
+    while (NVMCONbits.WR)
+        ;
+    return FLASH_Execute(FLASH_GetErasePageAddress(address), FLASH_NVMOP_PAGE_ERASE);
+}
+
+bool FLASH_WriteDoubleWord16(uint32_t address, uint16_t data0, uint16_t data1)
+{
+    uint16_t savedIpl;
+    uint16_t savedTblpag;
+    bool success;
+
+    while (NVMCONbits.WR)
+        ;
+
+    // The write latches are shared, so an interrupt that also programs
+    // flash must not run between loading them and starting the operation.
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    savedTblpag = TBLPAG;
+    TBLPAG = FLASH_WRITE_LATCH_PAGE;
+    __builtin_tblwtl(0, data0);
+    __builtin_tblwth(0, 0xFF);
+    __builtin_tblwtl(2, data1);
+    __builtin_tblwth(2, 0xFF);
+    success = FLASH_Execute(address & ~0x3UL, FLASH_NVMOP_DOUBLE_WORD);
+    TBLPAG = savedTblpag;
+    RESTORE_CPU_IPL(savedIpl);
+
+    return success;
+}
+
+uint16_t FLASH_ReadWord16(uint32_t address)
+{
+    uint16_t savedTblpag = TBLPAG;
+    uint16_t data;
+
+    TBLPAG = (uint16_t)(address >> 16);
+    data = __builtin_tblrdl((uint16_t)(address & 0xFFFF));
+    TBLPAG = savedTblpag;
+    return data;
+}
+
+uint32_t FLASH_GetErasePageAddress(uint32_t address)
+{
+    return address & ~((uint32_t)FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS - 1);
+}
+
+uint16_t FLASH_GetErasePageOffset(uint32_t address)
+{
+    return (uint16_t)(address & (FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS - 1));
+}
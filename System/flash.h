@@ -0,0 +1,56 @@
+/*
+ * File: flash.h
+ * Project: Smart Watch - Final Version
+ * Description: Self-programming access to the PIC24FJ256GA705 program flash
+ *              (page erase, double-word program, table reads).
+ */
+
+#ifndef FLASH_H
+#define	FLASH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define FLASH_WRITE_ROW_SIZE_IN_INSTRUCTIONS     128
+#define FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS    1024
+
+#define FLASH_WRITE_ROW_SIZE_IN_PC_UNITS         (FLASH_WRITE_ROW_SIZE_IN_INSTRUCTIONS * 2)
+#define FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS        (FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS * 2)
+
+/* The GA705 flash has ECC: every double-word may be programmed only once
+ * between erases. Callers must never re-program a word that is not erased. */
+#define FLASH_HAS_ECC                            1
+
+#define FLASH_ERASED_WORD16                      0xFFFF
+
+/**
+ * @Param
+    address - any program memory address inside the page to erase
+ * @Returns
+    true if the NVM controller reported no write error
+ * @Description
+    Erases one 1024-instruction page. Takes several milliseconds during
+ *  which the CPU is stalled.
+ */
+bool FLASH_ErasePage(uint32_t address);
+
+/**
+ * @Param
+    address - double-word aligned program memory address (multiple of 4)
+    data0, data1 - lower 16 bits of each instruction word; the upper byte
+ *  is left erased
+ * @Returns
+    true if the NVM controller reported no write error
+ * @Description
+    Programs two consecutive instruction words. This is the smallest write
+ *  unit and completes in tens of microseconds, so it is safe to use from
+ *  time-critical paths.
+ */
+bool FLASH_WriteDoubleWord16(uint32_t address, uint16_t data0, uint16_t data1);
+
+uint16_t FLASH_ReadWord16(uint32_t address);
+
+uint32_t FLASH_GetErasePageAddress(uint32_t address);
+uint16_t FLASH_GetErasePageOffset(uint32_t address);
+
+#endif	/* FLASH_H */
@@ -0,0 +1,124 @@
+/*
+ * File: rtcc.c
+ * Project: Smart Watch - Final Version
+ * Description: Driver for the RTCC alarm.
+ *
+ * Time and alarm registers are BCD: TIMEH holds hours:minutes and TIMEL
+ * seconds in its upper byte. The alarm matches hours, minutes and
+ * seconds once a day (AMASK) and is not repeated (ALMRPT = 0), so it
+ * behaves as a one-shot timer.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "rtcc.h"
+
+#define RTCC_CLKSEL_LPRC    1
+#define RTCC_LPRC_DIV       15499   // 31 kHz / (2 * (DIV + 1)) = 1 Hz
+#define RTCC_AMASK_DAILY    6       // match hh:mm:ss
+
+static void (*RTCC_AlarmHandler)(void) = NULL;
+
+static uint8_t RTCC_ToBcd(uint8_t value)
+{
+    return ((value / 10) << 4) | (value % 10);
+}
+
+static uint8_t RTCC_FromBcd(uint8_t value)
+{
+    return (value >> 4) * 10 + (value & 0x0F);
+}
+
+static void RTCC_Unlock(void)
+{
+    __builtin_write_RTCC_WRLOCK();
+}
+
+static void RTCC_Lock(void)
+{
+    RTCCON1Lbits.WRLOCK = 1;
+}
+
+void RTCC_Initialize(void)
+{
+    RTCC_Unlock();
+    RTCCON1Lbits.RTCEN = 0;
+
+    RTCCON1H = 0;                   // alarm off
+    RTCCON2L = 0;
+    RTCCON2Lbits.CLKSEL = RTCC_CLKSEL_LPRC;
+    RTCCON2H = RTCC_LPRC_DIV;
+    RTCCON3L = 0;
+
+    DATEH = 0x0001;                 // 2000-01-01, only the time is used
+    DATEL = 0x0100;
+    TIMEH = 0;
+    TIMEL = 0;
+
+    RTCCON1Lbits.RTCEN = 1;
+    RTCC_Lock();
+
+    IPC15bits.RTCIP = 2;
+    IFS3bits.RTCIF = 0;
+    IEC3bits.RTCIE = 1;
+}
+
+uint32_t RTCC_GetSecondOfDay(void)
+{
+    uint16_t timeHigh, timeLow;
+
+    // The registers may roll over between the two reads
+    do
+    {
+        timeHigh = TIMEH;
+        timeLow = TIMEL;
+    } while (timeHigh != TIMEH);
+
+    return RTCC_FromBcd(timeHigh >> 8) * 3600UL +
+           RTCC_FromBcd(timeHigh & 0xFF) * 60UL +
+           RTCC_FromBcd(timeLow >> 8);
+}
+
+void RTCC_SetAlarm(uint32_t secondOfDay)
+{
+    uint8_t hours = secondOfDay / 3600;
+    uint8_t minutes = (secondOfDay / 60) % 60;
+    uint8_t seconds = secondOfDay % 60;
+
+    RTCC_Unlock();
+    RTCCON1Hbits.ALRMEN = 0;
+    ALMTIMEH = ((uint16_t)RTCC_ToBcd(hours) << 8) | RTCC_ToBcd(minutes);
+    ALMTIMEL = (uint16_t)RTCC_ToBcd(seconds) << 8;
+    RTCCON1Hbits.AMASK = RTCC_AMASK_DAILY;
+    RTCCON1Hbits.ALMRPT = 0;
+    RTCCON1Hbits.CHIME = 0;
+    IFS3bits.RTCIF = 0;
+    RTCCON1Hbits.ALRMEN = 1;
+    RTCC_Lock();
+}
+
+void RTCC_SetAlarmAfter(uint32_t seconds)
+{
+    RTCC_SetAlarm((RTCC_GetSecondOfDay() + seconds) % RTCC_SECONDS_PER_DAY);
+}
+
+void RTCC_CancelAlarm(void)
+{
+    RTCC_Unlock();
+    RTCCON1Hbits.ALRMEN = 0;
+    RTCC_Lock();
+    IFS3bits.RTCIF = 0;
+}
+
+void RTCC_SetAlarmHandler(void (*handler)(void))
+{
+    RTCC_AlarmHandler = handler;
+}
+
+void __attribute__((__interrupt__, auto_psv)) _RTCCInterrupt(void)
+{
+    IFS3bits.RTCIF = 0;
+    if (RTCC_AlarmHandler != NULL)
+        RTCC_AlarmHandler();
+}
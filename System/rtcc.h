@@ -0,0 +1,42 @@
+/*
+ * File: rtcc.h
+ * Project: Smart Watch - Final Version
+ * Description: RTCC used as a low-power time base for alarms. It runs from
+ *              the LPRC (the board has no 32 kHz crystal), independently of
+ *              the Timer1 clock shown on the face.
+ */
+
+#ifndef RTCC_H
+#define	RTCC_H
+
+#include <stdint.h>
+
+#define RTCC_SECONDS_PER_DAY    86400UL
+
+/**
+ * @Description
+    Starts the RTCC from the LPRC at 00:00:00 with the alarm disabled.
+ *  The time of day is only a reference for alarms; LPRC accuracy is a
+ *  few percent.
+ */
+void RTCC_Initialize(void);
+
+uint32_t RTCC_GetSecondOfDay(void);
+
+/**
+ * @Param
+    secondOfDay - RTCC time of day at which the alarm fires, once
+ * @Description
+    Replaces any pending alarm. The handler set with RTCC_SetAlarmHandler
+ *  runs in interrupt context when it fires.
+ */
+void RTCC_SetAlarm(uint32_t secondOfDay);
+
+// Arms the alarm `seconds` from now (less than a day)
+void RTCC_SetAlarmAfter(uint32_t seconds);
+
+void RTCC_CancelAlarm(void);
+
+void RTCC_SetAlarmHandler(void (*handler)(void));
+
+#endif	/* RTCC_H */
@@ -71,9 +71,9 @@
 #pragma config FCKSM = CSECMD    //Clock Switching Mode bits->Both Clock switching and Fail-safe Clock Monitor are disabled
 
 // FWDT
-#pragma config WDTPS = PS32768    //Watchdog Timer Postscaler bits->1:32768
+#pragma config WDTPS = PS4096    //Watchdog Timer Postscaler bits->1:4096
 #pragma config FWPSA = PR128    //Watchdog Timer Prescaler bit->1:128
-#pragma config FWDTEN = OFF    //Watchdog Timer Enable bits->WDT and SWDTEN disabled
+#pragma config FWDTEN = SWON    //Watchdog Timer Enable bits->WDT Enabled/Disabled (controlled using SWDTEN bit)
 #pragma config WINDIS = OFF    //Watchdog Timer Window Enable bit->Watchdog Timer in Non-Window mode
 #pragma config WDTWIN = WIN25    //Watchdog Timer Window Select bits->WDT Window is 25% of WDT period
 #pragma config WDTCMX = WDTCLK    //WDT MUX Source Select bits->WDT clock source is determined by the WDTCLK Configuration bits
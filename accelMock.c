@@ -0,0 +1,130 @@
+/*
+ * File: accelMock.c
+ * Project: Smart Watch - Final Version
+ * Description: Scripted accelerometer for host builds.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "accelMock.h"
+
+#define ACCEL_MOCK_INT_WATERMARK    0x02
+#define ACCEL_MOCK_INT_OVERRUN      0x01
+
+static AccelMockSample fifo[ACCEL_MOCK_FIFO_DEPTH];
+static uint8_t fifoHead;
+static uint8_t fifoCount;
+static bool streamMode;
+static uint8_t watermark;
+static uint8_t rate;
+static bool lowPower;
+static uint8_t enabledInterrupts;
+static uint8_t latchedSources;
+static AccelMockErrorCounts errorCounts;
+
+bool accelMockInit(void) {
+    fifoHead = 0;
+    fifoCount = 0;
+    streamMode = false;
+    watermark = 0;
+    rate = 0;
+    lowPower = false;
+    enabledInterrupts = 0;
+    latchedSources = 0;
+    return true;
+}
+
+bool accelMockSetRate(uint8_t newRate, bool newLowPower) {
+    rate = newRate;
+    lowPower = newLowPower;
+    return true;
+}
+
+bool accelMockSetRange(uint8_t range) {
+    (void)range;
+    return true;
+}
+
+bool accelMockReadSample(AccelMockSample *sample) {
+    if (fifoCount == 0)
+        return false;
+    *sample = fifo[fifoHead];
+    fifoHead = (fifoHead + 1) % ACCEL_MOCK_FIFO_DEPTH;
+    fifoCount--;
+    if (fifoCount < watermark || watermark == 0)
+        latchedSources &= ~ACCEL_MOCK_INT_WATERMARK;
+    return true;
+}
+
+uint8_t accelMockFifoEntries(void) {
+    return fifoCount;
+}
+
+const AccelMockErrorCounts *accelMockErrorCounts(void) {
+    return &errorCounts;
+}
+
+bool accelMockConfigureFifo(bool stream, uint8_t newWatermark) {
+    streamMode = stream;
+    watermark = newWatermark;
+    return true;
+}
+
+bool accelMockEnableInterrupts(uint8_t mask) {
+    enabledInterrupts |= mask;
+    return true;
+}
+
+bool accelMockDisableInterrupts(uint8_t mask) {
+    enabledInterrupts &= ~mask;
+    return true;
+}
+
+uint8_t accelMockEnabledInterrupts(void) {
+    return enabledInterrupts;
+}
+
+bool accelMockInterruptPending(void) {
+    return (latchedSources & enabledInterrupts) != 0;
+}
+
+uint8_t accelMockReadInterruptSource(void) {
+    uint8_t source = latchedSources;
+    // Like the ADXL345, data-driven sources stay set while the condition holds
+    latchedSources &= ACCEL_MOCK_INT_WATERMARK;
+    return source;
+}
+
+void accelMockPushSample(int16_t x, int16_t y, int16_t z) {
+    uint8_t tail;
+
+    if (!streamMode) {
+        fifoHead = 0;
+        fifoCount = 0;
+    } else if (fifoCount == ACCEL_MOCK_FIFO_DEPTH) {
+        fifoHead = (fifoHead + 1) % ACCEL_MOCK_FIFO_DEPTH;
+        fifoCount--;
+        latchedSources |= ACCEL_MOCK_INT_OVERRUN;
+    }
+
+    tail = (fifoHead + fifoCount) % ACCEL_MOCK_FIFO_DEPTH;
+    fifo[tail].x = x;
+    fifo[tail].y = y;
+    fifo[tail].z = z;
+    fifoCount++;
+
+    if (streamMode && watermark != 0 && fifoCount >= watermark)
+        latchedSources |= ACCEL_MOCK_INT_WATERMARK;
+}
+
+void accelMockRaiseInterrupt(uint8_t source) {
+    latchedSources |= source;
+}
+
+uint8_t accelMockRate(void) {
+    return rate;
+}
+
+bool accelMockLowPower(void) {
+    return lowPower;
+}
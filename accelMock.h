@@ -0,0 +1,48 @@
+/*
+ * File: accelMock.h
+ * Project: Smart Watch - Final Version
+ * Description: Host-side accelerometer backend (ACCEL_SENSOR_MOCK). Tests
+ *              script samples and interrupt sources; the pipeline reads
+ *              them through accelSensor.h exactly as it reads the ADXL345.
+ */
+
+#ifndef ACCEL_MOCK_H
+#define ACCEL_MOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ACCEL_MOCK_FIFO_DEPTH   32
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} AccelMockSample;
+
+typedef struct {
+    uint16_t transfers;
+    uint16_t operations;
+} AccelMockErrorCounts;
+
+bool accelMockInit(void);
+bool accelMockSetRate(uint8_t rate, bool lowPower);
+bool accelMockSetRange(uint8_t range);
+bool accelMockReadSample(AccelMockSample *sample);
+uint8_t accelMockFifoEntries(void);
+const AccelMockErrorCounts *accelMockErrorCounts(void);
+bool accelMockConfigureFifo(bool stream, uint8_t watermark);
+bool accelMockEnableInterrupts(uint8_t mask);
+bool accelMockDisableInterrupts(uint8_t mask);
+uint8_t accelMockEnabledInterrupts(void);
+bool accelMockInterruptPending(void);
+uint8_t accelMockReadInterruptSource(void);
+
+// Test hooks. Pushing beyond the FIFO depth drops the oldest sample, like
+// the ADXL345 in stream mode; in bypass mode only the newest is kept.
+void accelMockPushSample(int16_t x, int16_t y, int16_t z);
+void accelMockRaiseInterrupt(uint8_t source);
+uint8_t accelMockRate(void);
+bool accelMockLowPower(void);
+
+#endif // ACCEL_MOCK_H
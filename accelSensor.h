@@ -0,0 +1,208 @@
+/*
+ * File: accelSensor.h
+ * Project: Smart Watch - Final Version
+ * Description: Accelerometer interface used by the sample pipeline (steps,
+ *              activity, sleep, fall capture) and the diagnostics screen.
+ *
+ * The backend is chosen at compile time with ACCEL_SENSOR. Each entry
+ * point is a static inline forwarding to the backend, so after inlining
+ * the sample path calls the driver directly: no function pointers.
+ * To add a part, write its driver and add a block below; nothing that
+ * consumes AccelSample needs to change.
+ *
+ * The event detectors (tap, free fall, activity/inactivity) take their
+ * settings in mg and ms; each backend converts them to its own registers.
+ */
+
+#ifndef ACCEL_SENSOR_H
+#define ACCEL_SENSOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "accelTypes.h"
+
+#define ACCEL_SENSOR_ADXL345    1
+#define ACCEL_SENSOR_MOCK       2   // host builds and tests
+
+#ifndef ACCEL_SENSOR
+#define ACCEL_SENSOR            ACCEL_SENSOR_ADXL345
+#endif
+
+#if ACCEL_SENSOR == ACCEL_SENSOR_ADXL345
+
+#include "adxl345.h"
+
+typedef Adxl345Sample AccelSample;
+typedef Adxl345ErrorCounts AccelErrorCounts;
+
+#define ACCEL_MG_PER_LSB        ADXL345_MG_PER_LSB
+#define ACCEL_FIFO_DEPTH        ADXL345_FIFO_DEPTH
+
+static inline bool accelSensorInit(void) {
+    return adxl345Init();
+}
+
+static inline bool accelSensorSetRate(AccelRate rate, bool lowPower) {
+    return adxl345SetRate((lowPower ? ADXL345_BW_LOW_POWER : 0) | (ADXL345_RATE_12_5HZ + rate));
+}
+
+static inline bool accelSensorSetRange(AccelRange range) {
+    return adxl345SetRange(ADXL345_RANGE_2G + range);
+}
+
+static inline bool accelSensorReadSample(AccelSample *sample) {
+    return adxl345ReadSample(sample);
+}
+
+static inline uint8_t accelSensorFifoEntries(void) {
+    return adxl345FifoEntries();
+}
+
+static inline const AccelErrorCounts *accelSensorErrorCounts(void) {
+    return adxl345ErrorCounts();
+}
+
+static inline bool accelSensorConfigureFifo(AccelFifoMode mode, uint8_t watermark) {
+    return adxl345ConfigureFifo(mode == ACCEL_FIFO_STREAM ? ADXL345_FIFO_STREAM : ADXL345_FIFO_BYPASS,
+                                watermark);
+}
+
+// THRESH_TAP, THRESH_FF, THRESH_ACT and THRESH_INACT are 62.5 mg/LSB
+#define ACCEL_ADXL345_THRESHOLD(mg)     ((uint8_t)(((uint32_t)(mg) * 2 + 62) / 125))
+
+// Also routes single and double tap to the interrupt line
+static inline bool accelSensorConfigureTap(const AccelTapConfig *config) {
+    Adxl345TapConfig tap;
+    tap.threshold = ACCEL_ADXL345_THRESHOLD(config->thresholdMg);
+    tap.duration = (uint16_t)config->durationMs * 8 / 5;    // 625 us/LSB
+    tap.latency = (uint16_t)config->latencyMs * 4 / 5;      // 1.25 ms/LSB
+    tap.window = (uint32_t)config->windowMs * 4 / 5;        // 1.25 ms/LSB
+    tap.axes = config->axes;
+    return adxl345ConfigureTap(&tap);
+}
+
+// Free fall: all axes below thresholdMg for at least timeMs
+static inline bool accelSensorConfigureFreeFall(uint16_t thresholdMg, uint16_t timeMs) {
+    return adxl345WriteRegister(ADXL345_REG_THRESH_FF, ACCEL_ADXL345_THRESHOLD(thresholdMg)) &&
+           adxl345WriteRegister(ADXL345_REG_TIME_FF, timeMs / 5);     // 5 ms/LSB
+}
+
+// Activity above activityMg, or inactivity below inactivityMg for
+// inactivitySeconds, on any axis, AC-coupled
+static inline bool accelSensorConfigureActivity(uint16_t activityMg, uint16_t inactivityMg,
+                                                uint8_t inactivitySeconds) {
+    return adxl345WriteRegister(ADXL345_REG_THRESH_INACT, ACCEL_ADXL345_THRESHOLD(inactivityMg)) &&
+           adxl345WriteRegister(ADXL345_REG_THRESH_ACT, ACCEL_ADXL345_THRESHOLD(activityMg)) &&
+           adxl345WriteRegister(ADXL345_REG_TIME_INACT, inactivitySeconds) &&
+           adxl345WriteRegister(ADXL345_REG_ACT_INACT_CTL, ADXL345_ACT_INACT_AC_ALL_AXES);
+}
+
+static inline void accelSensorInitInterruptPin(void) {
+    adxl345InitInterruptPin();
+}
+
+static inline bool accelSensorEnableInterrupts(uint8_t mask) {
+    return adxl345EnableInterrupts(mask);
+}
+
+static inline bool accelSensorDisableInterrupts(uint8_t mask) {
+    return adxl345DisableInterrupts(mask);
+}
+
+static inline uint8_t accelSensorEnabledInterrupts(void) {
+    return adxl345EnabledInterrupts();
+}
+
+static inline bool accelSensorInterruptPending(void) {
+    return adxl345InterruptPending();
+}
+
+static inline uint8_t accelSensorReadInterruptSource(void) {
+    return adxl345ReadInterruptSource();
+}
+
+#elif ACCEL_SENSOR == ACCEL_SENSOR_MOCK
+
+#include "accelMock.h"
+
+typedef AccelMockSample AccelSample;
+typedef AccelMockErrorCounts AccelErrorCounts;
+
+#define ACCEL_MG_PER_LSB        4
+#define ACCEL_FIFO_DEPTH        ACCEL_MOCK_FIFO_DEPTH
+
+static inline bool accelSensorInit(void) {
+    return accelMockInit();
+}
+
+static inline bool accelSensorSetRate(AccelRate rate, bool lowPower) {
+    return accelMockSetRate((uint8_t)rate, lowPower);
+}
+
+static inline bool accelSensorSetRange(AccelRange range) {
+    return accelMockSetRange((uint8_t)range);
+}
+
+static inline bool accelSensorReadSample(AccelSample *sample) {
+    return accelMockReadSample(sample);
+}
+
+static inline uint8_t accelSensorFifoEntries(void) {
+    return accelMockFifoEntries();
+}
+
+static inline const AccelErrorCounts *accelSensorErrorCounts(void) {
+    return accelMockErrorCounts();
+}
+
+static inline bool accelSensorConfigureFifo(AccelFifoMode mode, uint8_t watermark) {
+    return accelMockConfigureFifo(mode == ACCEL_FIFO_STREAM, watermark);
+}
+
+static inline bool accelSensorConfigureTap(const AccelTapConfig *config) {
+    (void)config;
+    return accelMockEnableInterrupts(ACCEL_INT_SINGLE_TAP | ACCEL_INT_DOUBLE_TAP);
+}
+
+static inline bool accelSensorConfigureFreeFall(uint16_t thresholdMg, uint16_t timeMs) {
+    (void)thresholdMg;
+    (void)timeMs;
+    return true;
+}
+
+static inline bool accelSensorConfigureActivity(uint16_t activityMg, uint16_t inactivityMg,
+                                                uint8_t inactivitySeconds) {
+    (void)activityMg;
+    (void)inactivityMg;
+    (void)inactivitySeconds;
+    return true;
+}
+
+static inline void accelSensorInitInterruptPin(void) {
+}
+
+static inline bool accelSensorEnableInterrupts(uint8_t mask) {
+    return accelMockEnableInterrupts(mask);
+}
+
+static inline bool accelSensorDisableInterrupts(uint8_t mask) {
+    return accelMockDisableInterrupts(mask);
+}
+
+static inline uint8_t accelSensorEnabledInterrupts(void) {
+    return accelMockEnabledInterrupts();
+}
+
+static inline bool accelSensorInterruptPending(void) {
+    return accelMockInterruptPending();
+}
+
+static inline uint8_t accelSensorReadInterruptSource(void) {
+    return accelMockReadInterruptSource();
+}
+
+#else
+#error "Unknown ACCEL_SENSOR backend"
+#endif
+
+#endif // ACCEL_SENSOR_H
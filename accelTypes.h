@@ -0,0 +1,57 @@
+/*
+ * File: accelTypes.h
+ * Project: Smart Watch - Final Version
+ * Description: Backend-neutral accelerometer settings and event bits,
+ *              shared by accelSensor.h and host tools that describe the
+ *              sensor without building against a backend.
+ */
+
+#ifndef ACCEL_TYPES_H
+#define ACCEL_TYPES_H
+
+#include <stdint.h>
+
+typedef enum {
+    ACCEL_RATE_12_5HZ,
+    ACCEL_RATE_25HZ,
+    ACCEL_RATE_50HZ,
+    ACCEL_RATE_100HZ
+} AccelRate;
+
+typedef enum {
+    ACCEL_RANGE_2G,
+    ACCEL_RANGE_4G,
+    ACCEL_RANGE_8G,
+    ACCEL_RANGE_16G
+} AccelRange;
+
+typedef enum {
+    ACCEL_FIFO_BYPASS,
+    ACCEL_FIFO_STREAM
+} AccelFifoMode;
+
+// Interrupt sources, in the ADXL345 bit layout; other backends translate
+#define ACCEL_INT_DATA_READY    0x80
+#define ACCEL_INT_SINGLE_TAP    0x40
+#define ACCEL_INT_DOUBLE_TAP    0x20
+#define ACCEL_INT_ACTIVITY      0x10
+#define ACCEL_INT_INACTIVITY    0x08
+#define ACCEL_INT_FREE_FALL     0x04
+#define ACCEL_INT_WATERMARK     0x02
+#define ACCEL_INT_OVERRUN       0x01
+
+// Tap axes
+#define ACCEL_AXIS_X            0x04
+#define ACCEL_AXIS_Y            0x02
+#define ACCEL_AXIS_Z            0x01
+
+// Backends round to their own resolution
+typedef struct {
+    uint16_t thresholdMg;   // peak that counts as a tap
+    uint8_t durationMs;     // longest time above the threshold
+    uint8_t latencyMs;      // quiet time before a second tap
+    uint16_t windowMs;      // time allowed for the second tap
+    uint8_t axes;           // ACCEL_AXIS_*
+} AccelTapConfig;
+
+#endif // ACCEL_TYPES_H
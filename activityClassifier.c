@@ -0,0 +1,147 @@
+/*
+ * File: activityClassifier.c
+ * Project: Smart Watch - Final Version
+ * Description: Activity recognition over tumbling windows of the
+ * acceleration magnitude.
+ *
+ * Each sample updates running sums and a hysteretic crossing detector in
+ * constant time; at the end of a window the features are reduced with
+ * shifts and one division and fed to a table-driven decision tree. The
+ * table has the layout a host-side training script emits, so a retrained
+ * tree drops in without code changes.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "activityClassifier.h"
+
+#define ACTIVITY_WINDOW_SHIFT   6       // 64 samples, ~2.5 s at the main loop rate
+#define ACTIVITY_WINDOW_SIZE    (1 << ACTIVITY_WINDOW_SHIFT)
+#define ACTIVITY_CLAMP_MG       4095    // keeps the sum of squares in 32 bits
+#define ACTIVITY_HYSTERESIS_MG  50
+
+typedef enum {
+    FEATURE_MEAN,
+    FEATURE_VARIANCE,
+    FEATURE_CROSSINGS,
+    FEATURE_PERIOD
+} ActivityFeatureId;
+
+// Branches >= 0 are node indices; negative ones are leaves, -(class + 1)
+#define LEAF(activity)  (-(int8_t)(activity) - 1)
+
+typedef struct {
+    uint8_t feature;
+    int32_t threshold;
+    int8_t below;           // taken when feature < threshold
+    int8_t above;
+} ActivityTreeNode;
+
+static const ActivityTreeNode ACTIVITY_TREE[] = {
+    /* 0 */ {FEATURE_VARIANCE,  3600,   LEAF(ACTIVITY_IDLE), 1},   // sd < 60 mg
+    /* 1 */ {FEATURE_CROSSINGS, 4,      LEAF(ACTIVITY_IDLE), 2},   // isolated gestures
+    /* 2 */ {FEATURE_VARIANCE,  490000, LEAF(ACTIVITY_WALK), 3},   // sd < 700 mg
+    /* 3 */ {FEATURE_PERIOD,    11,     LEAF(ACTIVITY_RUN),  LEAF(ACTIVITY_WALK)},
+};
+
+static const char *const ACTIVITY_NAMES[ACTIVITY_CLASS_COUNT] = {"IDLE", "WALK", "RUN"};
+
+static int32_t sum;
+static uint32_t sumOfSquares;
+static uint8_t sampleCount;
+static uint8_t crossings;
+static uint8_t upCrossings;
+static uint8_t firstUpCrossing;
+static uint8_t lastUpCrossing;
+static bool aboveCenter;
+static int16_t center;
+static ActivityFeatures features;
+static ActivityClass current = ACTIVITY_IDLE;
+
+static int32_t featureValue(uint8_t feature) {
+    switch (feature) {
+        case FEATURE_MEAN:      return features.mean;
+        case FEATURE_VARIANCE:  return (int32_t)features.variance;
+        case FEATURE_CROSSINGS: return features.crossings;
+        default:                return features.period;
+    }
+}
+
+static ActivityClass classify(void) {
+    int8_t node = 0;
+    while (node >= 0) {
+        const ActivityTreeNode *n = &ACTIVITY_TREE[node];
+        node = (featureValue(n->feature) < n->threshold) ? n->below : n->above;
+    }
+    return (ActivityClass)(-node - 1);
+}
+
+static void closeWindow(void) {
+    int16_t mean = (int16_t)(sum >> ACTIVITY_WINDOW_SHIFT);
+    uint32_t meanOfSquares = sumOfSquares >> ACTIVITY_WINDOW_SHIFT;
+    uint32_t meanSquared = (uint32_t)((int32_t)mean * mean);
+
+    features.mean = mean;
+    features.variance = (meanOfSquares > meanSquared) ? meanOfSquares - meanSquared : 0;
+    features.crossings = crossings;
+    features.period = (upCrossings >= 2)
+        ? (uint8_t)((lastUpCrossing - firstUpCrossing) / (upCrossings - 1))
+        : 0;
+    current = classify();
+
+    center = mean;
+    sum = 0;
+    sumOfSquares = 0;
+    sampleCount = 0;
+    crossings = 0;
+    upCrossings = 0;
+}
+
+void activityClassifierReset(void) {
+    sum = 0;
+    sumOfSquares = 0;
+    sampleCount = 0;
+    crossings = 0;
+    upCrossings = 0;
+    aboveCenter = false;
+    center = 0;
+    current = ACTIVITY_IDLE;
+}
+
+bool activityClassifierAddSample(int16_t dynamicMg) {
+    if (dynamicMg > ACTIVITY_CLAMP_MG)
+        dynamicMg = ACTIVITY_CLAMP_MG;
+    else if (dynamicMg < -ACTIVITY_CLAMP_MG)
+        dynamicMg = -ACTIVITY_CLAMP_MG;
+
+    sum += dynamicMg;
+    sumOfSquares += (uint32_t)((int32_t)dynamicMg * dynamicMg);
+
+    if (!aboveCenter && dynamicMg > center + ACTIVITY_HYSTERESIS_MG) {
+        aboveCenter = true;
+        crossings++;
+        if (upCrossings++ == 0)
+            firstUpCrossing = sampleCount;
+        lastUpCrossing = sampleCount;
+    } else if (aboveCenter && dynamicMg < center - ACTIVITY_HYSTERESIS_MG) {
+        aboveCenter = false;
+        crossings++;
+    }
+
+    if (++sampleCount < ACTIVITY_WINDOW_SIZE)
+        return false;
+    closeWindow();
+    return true;
+}
+
+ActivityClass activityClassifierCurrent(void) {
+    return current;
+}
+
+const ActivityFeatures *activityClassifierFeatures(void) {
+    return &features;
+}
+
+const char *activityClassName(ActivityClass activity) {
+    return (activity < ACTIVITY_CLASS_COUNT) ? ACTIVITY_NAMES[activity] : "";
+}
@@ -0,0 +1,39 @@
+/*
+ * File: activityClassifier.h
+ * Project: Smart Watch - Final Version
+ * Description: Idle/walk/run recognition from windowed features of the
+ *              acceleration magnitude, in fixed point.
+ */
+
+#ifndef ACTIVITY_CLASSIFIER_H
+#define ACTIVITY_CLASSIFIER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    ACTIVITY_IDLE,
+    ACTIVITY_WALK,
+    ACTIVITY_RUN,
+    ACTIVITY_CLASS_COUNT
+} ActivityClass;
+
+// Features of one completed window, in mg and samples
+typedef struct {
+    int16_t mean;           // mean dynamic magnitude
+    uint32_t variance;      // mg^2
+    uint8_t crossings;      // crossings of the previous window's mean
+    uint8_t period;         // mean samples between upward crossings, 0 = none
+} ActivityFeatures;
+
+void activityClassifierReset(void);
+
+// Adds one sample of dynamic magnitude (|a| - 1 g, in mg). Returns true
+// when it completed a window and the classification was refreshed.
+bool activityClassifierAddSample(int16_t dynamicMg);
+
+ActivityClass activityClassifierCurrent(void);
+const ActivityFeatures *activityClassifierFeatures(void);
+const char *activityClassName(ActivityClass activity);
+
+#endif // ACTIVITY_CLASSIFIER_H
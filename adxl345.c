@@ -0,0 +1,157 @@
+/*
+ * File: adxl345.c
+ * Project: Smart Watch - Final Version
+ * Description: ADXL345 register access, event-detector configuration and
+ *              the INT1 line. The ISR only records that the line rose; the
+ *              I2C read of INT_SOURCE happens in the main loop so it never
+ *              collides with a transfer already on the bus.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "System/delay.h"
+#include "Accel_i2c.h"
+#include "adxl345.h"
+#include "latencyMonitor.h"
+
+// ADXL345 INT1 is wired to RB11 (RP11)
+#define ACCEL_INT_RP            11
+#define ACCEL_INT_TRIS          TRISBbits.TRISB11
+#define ACCEL_INT_PIN           PORTBbits.RB11
+
+#define ADXL345_RETRIES         3
+
+static volatile bool interruptPending = false;
+static uint8_t enabledInterrupts = 0;
+static Adxl345ErrorCounts errorCounts;
+
+bool adxl345WriteRegister(uint8_t reg, uint8_t value) {
+    for (uint8_t i = 0; i < ADXL345_RETRIES; i++) {
+        if (i2cWriteSlave(ADXL345_I2C_WRITE_ADDR, reg, value) == OK)
+            return true;
+        errorCounts.transfers++;
+        DELAY_milliseconds(10);
+    }
+    errorCounts.operations++;
+    return false;
+}
+
+bool adxl345ReadRegister(uint8_t reg, uint8_t *value) {
+    for (uint8_t i = 0; i < ADXL345_RETRIES; i++) {
+        if (i2cReadSlaveRegister(ADXL345_I2C_WRITE_ADDR, reg, value) == OK)
+            return true;
+        errorCounts.transfers++;
+        DELAY_milliseconds(10);
+    }
+    errorCounts.operations++;
+    return false;
+}
+
+bool adxl345Init(void) {
+    uint8_t deviceId = 0;
+    if (!adxl345ReadRegister(ADXL345_REG_DEVID, &deviceId) || deviceId != ADXL345_DEVICE_ID)
+        return false;
+    return adxl345SetRange(ADXL345_RANGE_16G) &&
+           adxl345WriteRegister(ADXL345_REG_POWER_CTL, ADXL345_MEASURE_MODE);
+}
+
+bool adxl345SetRange(uint8_t range) {
+    return adxl345WriteRegister(ADXL345_REG_DATA_FORMAT, ADXL345_FULL_RES | range);
+}
+
+bool adxl345ReadSample(Adxl345Sample *sample) {
+    uint8_t raw[6];
+    for (uint8_t i = 0; i < ADXL345_RETRIES; i++) {
+        if (i2cReadSlaveRegisters(ADXL345_I2C_WRITE_ADDR, ADXL345_REG_DATAX0, raw, sizeof(raw)) == OK) {
+            sample->x = (int16_t)(((uint16_t)raw[1] << 8) | raw[0]);
+            sample->y = (int16_t)(((uint16_t)raw[3] << 8) | raw[2]);
+            sample->z = (int16_t)(((uint16_t)raw[5] << 8) | raw[4]);
+            return true;
+        }
+        errorCounts.transfers++;
+        DELAY_milliseconds(10);
+    }
+    errorCounts.operations++;
+    return false;
+}
+
+uint8_t adxl345FifoEntries(void) {
+    uint8_t status = 0;
+    adxl345ReadRegister(ADXL345_REG_FIFO_STATUS, &status);
+    return status & ADXL345_FIFO_ENTRIES_MASK;
+}
+
+const Adxl345ErrorCounts *adxl345ErrorCounts(void) {
+    return &errorCounts;
+}
+
+bool adxl345SetRate(uint8_t bwRate) {
+    return adxl345WriteRegister(ADXL345_REG_BW_RATE, bwRate);
+}
+
+bool adxl345ConfigureFifo(uint8_t mode, uint8_t watermark) {
+    return adxl345WriteRegister(ADXL345_REG_FIFO_CTL, mode | (watermark & 0x1F));
+}
+
+bool adxl345ConfigureTap(const Adxl345TapConfig *config) {
+    if (!adxl345WriteRegister(ADXL345_REG_THRESH_TAP, config->threshold) ||
+        !adxl345WriteRegister(ADXL345_REG_DUR, config->duration) ||
+        !adxl345WriteRegister(ADXL345_REG_LATENT, config->latency) ||
+        !adxl345WriteRegister(ADXL345_REG_WINDOW, config->window) ||
+        !adxl345WriteRegister(ADXL345_REG_TAP_AXES, config->axes))
+        return false;
+    return adxl345EnableInterrupts(ADXL345_INT_SINGLE_TAP | ADXL345_INT_DOUBLE_TAP);
+}
+
+bool adxl345EnableInterrupts(uint8_t mask) {
+    enabledInterrupts |= mask;
+    return adxl345WriteRegister(ADXL345_REG_INT_MAP, 0x00) &&
+           adxl345WriteRegister(ADXL345_REG_INT_ENABLE, enabledInterrupts);
+}
+
+bool adxl345DisableInterrupts(uint8_t mask) {
+    enabledInterrupts &= ~mask;
+    return adxl345WriteRegister(ADXL345_REG_INT_ENABLE, enabledInterrupts);
+}
+
+uint8_t adxl345EnabledInterrupts(void) {
+    return enabledInterrupts;
+}
+
+void adxl345InitInterruptPin(void) {
+    ACCEL_INT_TRIS = 1;
+
+    __builtin_write_OSCCONL(OSCCON & 0xbf); // unlock PPS
+    RPINR0bits.INT1R = ACCEL_INT_RP;
+    __builtin_write_OSCCONL(OSCCON | 0x40); // lock PPS
+
+    INTCON2bits.INT1EP = 0;                 // rising edge (INT active high)
+    IPC5bits.INT1IP = 3;
+    IFS1bits.INT1IF = 0;
+    IEC1bits.INT1IE = 1;
+
+    // A line left high from before reset produces no edge; service it now
+    interruptPending = ACCEL_INT_PIN;
+}
+
+bool adxl345InterruptPending(void) {
+    return interruptPending;
+}
+
+uint8_t adxl345ReadInterruptSource(void) {
+    uint8_t source = 0;
+    interruptPending = false;
+    adxl345ReadRegister(ADXL345_REG_INT_SOURCE, &source);
+    // Another event may have latched during the read and kept INT1 high,
+    // in which case no new edge will arrive.
+    if (ACCEL_INT_PIN)
+        interruptPending = true;
+    return source;
+}
+
+void __attribute__((__interrupt__, auto_psv)) _INT1Interrupt(void) {
+    latencyMonitorAccelEntry();
+    interruptPending = true;
+    IFS1bits.INT1IF = 0;
+}
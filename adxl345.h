@@ -0,0 +1,141 @@
+/*
+ * File: adxl345.h
+ * Project: Smart Watch - Final Version
+ * Description: ADXL345 register map and configuration helpers for the
+ *              on-chip event detectors (tap) and the INT1 interrupt line.
+ *              The ADXL345 backend of accelSensor.h; application code goes
+ *              through that interface.
+ */
+
+#ifndef ADXL345_H
+#define ADXL345_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ADXL345_I2C_WRITE_ADDR    0x3A
+#define ADXL345_DEVICE_ID         0xE5
+
+// Register map
+#define ADXL345_REG_DEVID         0x00
+#define ADXL345_REG_THRESH_TAP    0x1D
+#define ADXL345_REG_DUR           0x21
+#define ADXL345_REG_LATENT        0x22
+#define ADXL345_REG_WINDOW        0x23
+#define ADXL345_REG_THRESH_ACT    0x24
+#define ADXL345_REG_THRESH_INACT  0x25
+#define ADXL345_REG_TIME_INACT    0x26
+#define ADXL345_REG_ACT_INACT_CTL 0x27
+#define ADXL345_REG_THRESH_FF     0x28
+#define ADXL345_REG_TIME_FF       0x29
+#define ADXL345_REG_TAP_AXES      0x2A
+#define ADXL345_REG_ACT_TAP_STATUS 0x2B
+#define ADXL345_REG_BW_RATE       0x2C
+#define ADXL345_REG_POWER_CTL     0x2D
+#define ADXL345_REG_INT_ENABLE    0x2E
+#define ADXL345_REG_INT_MAP       0x2F
+#define ADXL345_REG_INT_SOURCE    0x30
+#define ADXL345_REG_DATA_FORMAT   0x31
+#define ADXL345_REG_DATAX0        0x32
+#define ADXL345_REG_DATAY0        0x34
+#define ADXL345_REG_DATAZ0        0x36
+#define ADXL345_REG_FIFO_CTL      0x38
+#define ADXL345_REG_FIFO_STATUS   0x39
+
+// INT_ENABLE / INT_MAP / INT_SOURCE bits
+#define ADXL345_INT_DATA_READY    0x80
+#define ADXL345_INT_SINGLE_TAP    0x40
+#define ADXL345_INT_DOUBLE_TAP    0x20
+#define ADXL345_INT_ACTIVITY      0x10
+#define ADXL345_INT_INACTIVITY    0x08
+#define ADXL345_INT_FREE_FALL     0x04
+#define ADXL345_INT_WATERMARK     0x02
+#define ADXL345_INT_OVERRUN       0x01
+
+// ACT_INACT_CTL: AC-coupled, X/Y/Z for both detectors
+#define ADXL345_ACT_INACT_AC_ALL_AXES 0xFF
+
+// TAP_AXES bits
+#define ADXL345_TAP_SUPPRESS      0x08
+#define ADXL345_TAP_X             0x04
+#define ADXL345_TAP_Y             0x02
+#define ADXL345_TAP_Z             0x01
+
+#define ADXL345_MEASURE_MODE      0x08
+
+// DATA_FORMAT: full resolution keeps 4 mg/LSB in every range
+#define ADXL345_FULL_RES          0x08
+#define ADXL345_RANGE_2G          0x00
+#define ADXL345_RANGE_4G          0x01
+#define ADXL345_RANGE_8G          0x02
+#define ADXL345_RANGE_16G         0x03
+#define ADXL345_MG_PER_LSB        4
+
+// BW_RATE
+#define ADXL345_BW_LOW_POWER      0x10
+#define ADXL345_RATE_12_5HZ       0x07
+#define ADXL345_RATE_25HZ         0x08
+#define ADXL345_RATE_50HZ         0x09
+#define ADXL345_RATE_100HZ        0x0A
+
+// FIFO_CTL modes / FIFO_STATUS
+#define ADXL345_FIFO_BYPASS       0x00
+#define ADXL345_FIFO_FIFO         0x40
+#define ADXL345_FIFO_STREAM       0x80
+#define ADXL345_FIFO_TRIGGER      0xC0
+#define ADXL345_FIFO_ENTRIES_MASK 0x3F
+#define ADXL345_FIFO_DEPTH        32
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+} Adxl345Sample;
+
+typedef struct {
+    uint16_t transfers;  // failed I2C transfers, including retried ones
+    uint16_t operations; // register accesses that failed after all retries
+} Adxl345ErrorCounts;
+
+typedef struct {
+    uint8_t threshold;   // THRESH_TAP, 62.5 mg/LSB
+    uint8_t duration;    // DUR, 625 us/LSB: max time above threshold
+    uint8_t latency;     // LATENT, 1.25 ms/LSB: quiet time before 2nd tap
+    uint8_t window;      // WINDOW, 1.25 ms/LSB: time allowed for 2nd tap
+    uint8_t axes;        // TAP_AXES
+} Adxl345TapConfig;
+
+// Checks the device ID, selects full-resolution +/-16 g and starts
+// measuring. Returns false if the part does not answer as an ADXL345.
+bool adxl345Init(void);
+bool adxl345SetRange(uint8_t range);
+
+bool adxl345WriteRegister(uint8_t reg, uint8_t value);
+bool adxl345ReadRegister(uint8_t reg, uint8_t *value);
+
+// Reads X/Y/Z in one burst; with the FIFO enabled this pops one entry.
+bool adxl345ReadSample(Adxl345Sample *sample);
+
+uint8_t adxl345FifoEntries(void);
+const Adxl345ErrorCounts *adxl345ErrorCounts(void);
+bool adxl345SetRate(uint8_t bwRate);
+bool adxl345ConfigureFifo(uint8_t mode, uint8_t watermark);
+
+// Programs the tap detector and routes single/double tap to INT1.
+bool adxl345ConfigureTap(const Adxl345TapConfig *config);
+
+// Adds/removes sources in INT_ENABLE; all sources are mapped to INT1.
+bool adxl345EnableInterrupts(uint8_t mask);
+bool adxl345DisableInterrupts(uint8_t mask);
+uint8_t adxl345EnabledInterrupts(void);
+
+// Configures the MCU side of INT1 (PPS + external interrupt, rising edge).
+void adxl345InitInterruptPin(void);
+
+// True once INT1 has fired and INT_SOURCE has not been read since.
+bool adxl345InterruptPending(void);
+
+// Reads INT_SOURCE, which also releases the latched INT1 line.
+uint8_t adxl345ReadInterruptSource(void);
+
+#endif // ADXL345_H
@@ -0,0 +1,219 @@
+/*
+ * File: alarmScheduler.c
+ * Project: Smart Watch - Final Version
+ * Description: Min-heap of alarm deadlines multiplexed onto the RTCC alarm.
+ *
+ * Deadlines are absolute seconds on a count extended from the RTCC's time
+ * of day: each read adds the seconds since the previous one, so the count
+ * stays right as long as it is read at least once a day. The alarm is
+ * never armed more than ALARM_MAX_WAIT_SECONDS ahead for that reason; a
+ * wake-up that finds nothing due only re-arms. The heap is shared with
+ * the RTCC interrupt, so main-line changes run with interrupts masked;
+ * each is a few swaps.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "System/rtcc.h"
+#include "alarmScheduler.h"
+
+#define ALARM_MAX_WAIT_SECONDS  (12 * 3600UL)
+
+typedef struct {
+    uint32_t due;
+    AlarmId id;
+} HeapNode;
+
+static HeapNode heap[ALARM_SCHEDULER_SLOTS];
+static uint8_t heapSize;
+static int8_t heapIndex[ALARM_SCHEDULER_SLOTS];     // -1 when not pending
+static uint8_t slotCount;
+static volatile uint16_t firedMask;
+
+static uint32_t now;                // extended count at the last read
+static uint32_t lastSecondOfDay;
+
+static uint32_t readNow(void) {
+    uint32_t secondOfDay = RTCC_GetSecondOfDay();
+
+    now += (secondOfDay + RTCC_SECONDS_PER_DAY - lastSecondOfDay) % RTCC_SECONDS_PER_DAY;
+    lastSecondOfDay = secondOfDay;
+    return now;
+}
+
+static bool earlier(uint8_t a, uint8_t b) {
+    return (int32_t)(heap[a].due - heap[b].due) < 0;
+}
+
+static void place(uint8_t index, HeapNode node) {
+    heap[index] = node;
+    heapIndex[node.id] = index;
+}
+
+static void swap(uint8_t a, uint8_t b) {
+    HeapNode node = heap[a];
+    place(a, heap[b]);
+    place(b, node);
+}
+
+static void siftUp(uint8_t index) {
+    while (index > 0) {
+        uint8_t parent = (index - 1) / 2;
+        if (!earlier(index, parent))
+            break;
+        swap(index, parent);
+        index = parent;
+    }
+}
+
+static void siftDown(uint8_t index) {
+    for (;;) {
+        uint8_t child = 2 * index + 1;
+        if (child >= heapSize)
+            break;
+        if (child + 1 < heapSize && earlier(child + 1, child))
+            child++;
+        if (!earlier(child, index))
+            break;
+        swap(index, child);
+        index = child;
+    }
+}
+
+// Re-sorts a node whose deadline changed, in whichever direction
+static void restore(uint8_t index) {
+    AlarmId id = heap[index].id;
+    siftUp(index);
+    siftDown(heapIndex[id]);
+}
+
+static void removeAt(uint8_t index) {
+    heapIndex[heap[index].id] = -1;
+    heapSize--;
+    if (index == heapSize)
+        return;
+    place(index, heap[heapSize]);
+    restore(index);
+}
+
+// Programs the earliest deadline, or stops the alarm when none is pending
+static void arm(void) {
+    uint32_t wait;
+
+    if (heapSize == 0) {
+        RTCC_CancelAlarm();
+        return;
+    }
+    wait = heap[0].due - readNow();
+    if ((int32_t)wait < 1)
+        wait = 1;           // the RTCC only matches a second still to come
+    else if (wait > ALARM_MAX_WAIT_SECONDS)
+        wait = ALARM_MAX_WAIT_SECONDS;
+    RTCC_SetAlarmAfter(wait);
+}
+
+static void onAlarm(void) {
+    uint32_t time = readNow();
+
+    while (heapSize > 0 && (int32_t)(time - heap[0].due) >= 0) {
+        firedMask |= ALARM_BIT(heap[0].id);
+        removeAt(0);
+    }
+    arm();
+}
+
+void alarmSchedulerInit(void) {
+    for (uint8_t i = 0; i < ALARM_SCHEDULER_SLOTS; i++)
+        heapIndex[i] = -1;
+    heapSize = 0;
+    slotCount = 0;
+    firedMask = 0;
+    now = 0;
+    lastSecondOfDay = RTCC_GetSecondOfDay();
+    RTCC_CancelAlarm();
+    RTCC_SetAlarmHandler(onAlarm);
+}
+
+AlarmId alarmSchedulerAdd(void) {
+    if (slotCount >= ALARM_SCHEDULER_SLOTS)
+        return ALARM_NONE;
+    return slotCount++;
+}
+
+void alarmSchedulerStart(AlarmId id, uint32_t seconds) {
+    uint16_t savedIpl;
+    HeapNode node;
+    AlarmId oldRoot;
+
+    if (id < 0 || id >= slotCount)
+        return;
+    if (seconds == 0)
+        seconds = 1;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    oldRoot = (heapSize > 0) ? heap[0].id : ALARM_NONE;
+    node.id = id;
+    node.due = readNow() + seconds;
+    firedMask &= ~ALARM_BIT(id);
+    if (heapIndex[id] < 0) {
+        place(heapSize, node);
+        heapSize++;
+        siftUp(heapSize - 1);
+    } else {
+        place(heapIndex[id], node);
+        restore(heapIndex[id]);
+    }
+    // A new earliest deadline, or the old one moved later
+    if (heap[0].id != oldRoot || heap[0].id == id)
+        arm();
+    RESTORE_CPU_IPL(savedIpl);
+}
+
+void alarmSchedulerCancel(AlarmId id) {
+    uint16_t savedIpl;
+
+    if (id < 0 || id >= slotCount)
+        return;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    firedMask &= ~ALARM_BIT(id);
+    if (heapIndex[id] >= 0) {
+        bool wasRoot = (heapIndex[id] == 0);
+        removeAt(heapIndex[id]);
+        if (wasRoot)
+            arm();
+    }
+    RESTORE_CPU_IPL(savedIpl);
+}
+
+bool alarmSchedulerPending(AlarmId id) {
+    return id >= 0 && id < slotCount && heapIndex[id] >= 0;
+}
+
+uint32_t alarmSchedulerRemaining(AlarmId id) {
+    uint16_t savedIpl;
+    uint32_t remaining = 0;
+
+    if (!alarmSchedulerPending(id))
+        return 0;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    if (heapIndex[id] >= 0) {
+        int32_t left = (int32_t)(heap[heapIndex[id]].due - readNow());
+        remaining = (left > 0) ? (uint32_t)left : 0;
+    }
+    RESTORE_CPU_IPL(savedIpl);
+    return remaining;
+}
+
+uint16_t alarmSchedulerTakeFired(uint16_t mask) {
+    uint16_t savedIpl;
+    uint16_t fired;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    fired = firedMask & mask;
+    firedMask &= ~fired;
+    RESTORE_CPU_IPL(savedIpl);
+    return fired;
+}
@@ -0,0 +1,47 @@
+/*
+ * File: alarmScheduler.h
+ * Project: Smart Watch - Final Version
+ * Description: Any number of alarms and countdown timers sharing the one
+ *              RTCC alarm.
+ *
+ * A client claims an alarm slot once and then starts, restarts or cancels
+ * it. Pending deadlines are kept in a min-heap and only the earliest is
+ * programmed into the RTCC, so nothing polls them: the CPU is woken when
+ * that one is due, its bit is set in the fired mask and the next deadline
+ * is armed from the interrupt. Starting or cancelling costs O(log n).
+ * Deadlines follow the RTCC, which runs from the LPRC and may be a few
+ * percent off the clock on the face.
+ */
+
+#ifndef ALARM_SCHEDULER_H
+#define ALARM_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ALARM_SCHEDULER_SLOTS   8
+
+typedef int8_t AlarmId;
+
+#define ALARM_NONE              (-1)
+#define ALARM_BIT(id)           (1U << (id))
+
+// Takes over the RTCC alarm; RTCC_Initialize must have run
+void alarmSchedulerInit(void);
+
+// Claims a slot for good; ALARM_NONE when all are taken
+AlarmId alarmSchedulerAdd(void);
+
+// Fires `seconds` from now (at least one), replacing a pending deadline
+void alarmSchedulerStart(AlarmId id, uint32_t seconds);
+
+// Also drops a firing not yet taken
+void alarmSchedulerCancel(AlarmId id);
+
+bool alarmSchedulerPending(AlarmId id);
+uint32_t alarmSchedulerRemaining(AlarmId id);     // seconds, 0 if not pending
+
+// Returns the fired alarms among `mask` (ALARM_BIT of each) and clears them
+uint16_t alarmSchedulerTakeFired(uint16_t mask);
+
+#endif // ALARM_SCHEDULER_H
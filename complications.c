@@ -0,0 +1,105 @@
+/*
+ * File: complications.c
+ * Project: Smart Watch - Final Version
+ * Description: Watch-face complications: boxed regions of the clock face,
+ *              each repainted on its own schedule.
+ *
+ * Timed complications carry the second they are next due; the earliest of
+ * those is kept so the common case, a pass where nothing is due, returns
+ * before touching the table. A minute complication is due on the next
+ * minute boundary of the wall clock rather than sixty seconds after it was
+ * painted, so the time and date turn over with the seconds.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "oledDriver/oledC_colors.h"
+#include "oledDriver/oledC_shapes.h"
+#include "complications.h"
+
+typedef struct {
+    const Complication *complication;
+    uint32_t shownValue;
+    uint32_t dueAt;             // timed complications only
+    bool pending;               // read at the next service call
+    bool painted;               // shownValue is on screen
+} Entry;
+
+static Entry entries[COMPLICATIONS_MAX];
+static uint8_t entryCount;
+static bool anyPending;
+static uint32_t nextDue;
+
+static void refresh(Entry *entry) {
+    const Complication *complication = entry->complication;
+    uint32_t value = complication->source();
+
+    if (entry->painted && value == entry->shownValue)
+        return;
+    oledC_DrawRectangle(complication->left, complication->top,
+                        complication->right, complication->bottom, OLEDC_COLOR_BLACK);
+    complication->render(complication, value);
+    entry->shownValue = value;
+    entry->painted = true;
+}
+
+static void schedule(Entry *entry, uint32_t seconds, uint8_t secondOfMinute) {
+    switch (entry->complication->update) {
+        case COMPLICATION_PER_SECOND:
+            entry->dueAt = seconds + 1;
+            break;
+        case COMPLICATION_PER_MINUTE:
+            entry->dueAt = seconds + 60 - secondOfMinute;
+            break;
+        default:
+            break;
+    }
+}
+
+ComplicationId complicationsAdd(const Complication *complication) {
+    Entry *entry;
+
+    if (entryCount >= COMPLICATIONS_MAX)
+        return -1;
+    entry = &entries[entryCount];
+    entry->complication = complication;
+    entry->painted = false;
+    entry->pending = true;
+    anyPending = true;
+    return entryCount++;
+}
+
+void complicationsInvalidate(ComplicationId id) {
+    if (id < 0 || id >= entryCount)
+        return;
+    entries[id].pending = true;
+    anyPending = true;
+}
+
+void complicationsInvalidateAll(void) {
+    for (uint8_t i = 0; i < entryCount; i++) {
+        entries[i].painted = false;
+        entries[i].pending = true;
+    }
+    anyPending = true;
+}
+
+void complicationsService(uint32_t seconds, uint8_t secondOfMinute) {
+    if (!anyPending && (int32_t)(seconds - nextDue) < 0)
+        return;
+
+    anyPending = false;
+    nextDue = seconds + 60;
+    for (uint8_t i = 0; i < entryCount; i++) {
+        Entry *entry = &entries[i];
+        bool timed = entry->complication->update != COMPLICATION_ON_EVENT;
+
+        if (entry->pending || (timed && (int32_t)(seconds - entry->dueAt) >= 0)) {
+            entry->pending = false;
+            refresh(entry);
+            schedule(entry, seconds, secondOfMinute);
+        }
+        if (timed && (int32_t)(entry->dueAt - nextDue) < 0)
+            nextDue = entry->dueAt;
+    }
+}
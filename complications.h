@@ -0,0 +1,55 @@
+/*
+ * File: complications.h
+ * Project: Smart Watch - Final Version
+ * Description: Watch-face complications: boxed regions of the clock face,
+ *              each repainted on its own schedule.
+ *
+ * A complication names a bounding box, when its data can change (every
+ * second, every minute, or only when told), a data source returning the
+ * value to show and a renderer that draws that value inside the box. When
+ * a complication falls due its source is read; only if the value differs
+ * from the one on screen is the box cleared and handed to the renderer,
+ * so nothing outside the box is touched and an unchanged region costs no
+ * SPI traffic. Between due times a service call is a single comparison.
+ */
+
+#ifndef COMPLICATIONS_H
+#define COMPLICATIONS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define COMPLICATIONS_MAX       12
+
+typedef enum {
+    COMPLICATION_PER_SECOND,
+    COMPLICATION_PER_MINUTE,    // on the minute boundary
+    COMPLICATION_ON_EVENT       // after complicationsInvalidate
+} ComplicationUpdate;
+
+typedef struct Complication Complication;
+
+struct Complication {
+    uint8_t left, top, right, bottom;       // inclusive, in pixels
+    ComplicationUpdate update;
+    uint32_t (*source)(void);
+    // Called with the box already cleared; must draw inside it only
+    void (*render)(const Complication *complication, uint32_t value);
+};
+
+typedef int8_t ComplicationId;
+
+// Registers a complication (kept by reference); -1 when the face is full
+ComplicationId complicationsAdd(const Complication *complication);
+
+// The complication's data changed; it is read at the next service call
+void complicationsInvalidate(ComplicationId id);
+
+// The face was cleared: every box is repainted at the next service call
+void complicationsInvalidateAll(void);
+
+// seconds is a monotonic count of seconds, secondOfMinute the wall
+// clock's seconds field at the same moment
+void complicationsService(uint32_t seconds, uint8_t secondOfMinute);
+
+#endif // COMPLICATIONS_H
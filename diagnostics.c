@@ -0,0 +1,532 @@
+/*
+ * File: diagnostics.c
+ * Project: Smart Watch - Final Version
+ * Description: Diagnostics pages: accelerometer, interrupt latency, step
+ *              sampling, task supervision, display.
+ *
+ * Every value is a retained text field: the page remembers the glyphs
+ * on screen and only erases and redraws the character cells that
+ * changed, so a refresh costs a few glyphs instead of a cleared block
+ * and three full strings. Sparklines scroll the same way: a column is
+ * touched only if its point moved.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include "System/delay.h"
+#include "oledDriver/oledC.h"
+#include "oledDriver/oledC_colors.h"
+#include "oledDriver/oledC_shapes.h"
+#include "accelSensor.h"
+#include "fallDetector.h"
+#include "latencyMonitor.h"
+#include "samplingMonitor.h"
+#include "taskSupervisor.h"
+#include "timebase.h"
+#include "diagnostics.h"
+
+#define DIAG_GLYPH_WIDTH        5
+#define DIAG_GLYPH_ADVANCE      6
+#define DIAG_GLYPH_HEIGHT       8
+#define DIAG_FIELD_MAX          16
+#define DIAG_REFRESH_TICKS      (TIMER1_TICKS_PER_SECOND / 10)   // 10 Hz
+
+#define SPARK_X                 54
+#define SPARK_WIDTH             42
+#define SPARK_HEIGHT            9
+#define SPARK_FULL_SCALE_MG     2000
+
+#define AXIS_COUNT              3
+
+#define LATENCY_BLOCK_HEIGHT    42
+#define HISTOGRAM_X             6
+#define HISTOGRAM_TOP           20      // below the block's two text lines
+#define HISTOGRAM_HEIGHT        12
+#define HISTOGRAM_BAR_WIDTH     5
+#define HISTOGRAM_BAR_ADVANCE   6
+#define LEGEND_Y                86
+
+#define SAMPLING_FLAG_X         84
+#define SAMPLING_FLAG_SIZE      10
+
+#define TASK_ROW_TOP            12
+#define TASK_ROW_HEIGHT         10
+
+typedef enum {
+    DIAG_PAGE_ACCEL,
+    DIAG_PAGE_LATENCY,
+    DIAG_PAGE_SAMPLING,
+    DIAG_PAGE_TASKS,
+    DIAG_PAGE_DISPLAY,
+    DIAG_PAGE_COUNT
+} DiagPage;
+
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+    uint8_t length;
+    char shown[DIAG_FIELD_MAX];
+} TextField;
+
+typedef struct {
+    uint8_t y;
+    uint16_t color;
+    uint8_t rows[SPARK_WIDTH];
+} Sparkline;
+
+static TextField axisFields[AXIS_COUNT] = {
+    {0, 2, 8}, {0, 14, 8}, {0, 26, 8}
+};
+static TextField magnitudeField = {0, 40, 16};
+static TextField rateField = {0, 52, 16};
+static TextField fifoField = {0, 64, 16};
+static TextField errorField = {0, 76, 16};
+
+static Sparkline sparklines[AXIS_COUNT] = {
+    {2, OLEDC_COLOR_RED}, {14, OLEDC_COLOR_GREEN}, {26, OLEDC_COLOR_BLUE}
+};
+
+static const char *const LATENCY_NAMES[LATENCY_SOURCE_COUNT] = {"T1", "INT1"};
+static TextField latencyCountFields[LATENCY_SOURCE_COUNT] = {
+    {0, 2, 16}, {0, 2 + LATENCY_BLOCK_HEIGHT, 16}
+};
+static TextField latencyMaxFields[LATENCY_SOURCE_COUNT] = {
+    {0, 12, 16}, {0, 12 + LATENCY_BLOCK_HEIGHT, 16}
+};
+static uint8_t histogramShown[LATENCY_SOURCE_COUNT][LATENCY_BUCKETS];
+
+static TextField samplingCountField = {0, 14, 16};
+static TextField samplingMeanField = {0, 26, 16};
+static TextField samplingDeviationField = {0, 38, 16};
+static TextField samplingJitterField = {0, 50, 16};
+static TextField samplingViolationField = {0, 62, 16};
+static TextField samplingDropField = {0, 74, 16};
+static TextField samplingOverrunField = {0, 86, 16};
+static int8_t samplingFlagShown;        // -1 before the first refresh
+
+static const char *const TASK_NAMES[TASK_COUNT] = {"LOOP", "ACC", "I2C", "EXP", "FACE", "PAGE"};
+static TextField taskFields[TASK_COUNT] = {
+    {0, TASK_ROW_TOP, 16}, {0, TASK_ROW_TOP + TASK_ROW_HEIGHT, 16},
+    {0, TASK_ROW_TOP + 2 * TASK_ROW_HEIGHT, 16}, {0, TASK_ROW_TOP + 3 * TASK_ROW_HEIGHT, 16},
+    {0, TASK_ROW_TOP + 4 * TASK_ROW_HEIGHT, 16}, {0, TASK_ROW_TOP + 5 * TASK_ROW_HEIGHT, 16}
+};
+static TextField offenderField = {0, 76, 16};
+static TextField watchdogField = {0, 86, 16};
+
+static const char *const PANEL_PROFILE_NAMES[OLEDC_PANEL_PROFILE_COUNT] = {"perf", "balanced", "low power"};
+static TextField litNowField = {0, 14, 16};
+static TextField litAverageField = {0, 26, 16};
+static TextField litPeakField = {0, 38, 16};
+static TextField pixelsField = {0, 52, 16};
+static TextField fillsField = {0, 64, 16};
+static TextField profileField = {0, 78, 16};
+
+// Draws only the character cells whose glyph differs from what is shown
+static void fieldUpdate(TextField *field, const char *text) {
+    bool ended = false;
+
+    for (uint8_t i = 0; i < field->length; i++) {
+        char c = ended ? ' ' : text[i];
+        if (c == '\0') {
+            ended = true;
+            c = ' ';
+        }
+        if (c == field->shown[i])
+            continue;
+
+        uint8_t x = field->x + i * DIAG_GLYPH_ADVANCE;
+        oledC_DrawRectangle(x, field->y + 1, x + DIAG_GLYPH_WIDTH - 1,
+                            field->y + DIAG_GLYPH_HEIGHT, OLEDC_COLOR_BLACK);
+        if (c != ' ')
+            oledC_DrawCharacter(x, field->y, 1, 1, c, OLEDC_COLOR_WHITE);
+        field->shown[i] = c;
+    }
+}
+
+static uint8_t decimalDigits(uint32_t value) {
+    uint8_t digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        digits++;
+    }
+    return digits;
+}
+
+// Writes value in at most width characters, in thousands, millions or
+// billions (123k, 45M, 4G) when it does not fit in full. Any 32-bit value
+// fits in 4 characters and any 16-bit one in 3; one that cannot be shown
+// fills the width with '#' rather than a wrong figure. buffer holds
+// width + 1 characters.
+static const char *shortCount(char *buffer, uint8_t width, uint32_t value) {
+    static const char UNITS[] = {'k', 'M', 'G'};
+    uint32_t divisor = 1;
+
+    if (decimalDigits(value) <= width) {
+        snprintf(buffer, width + 1, "%lu", (unsigned long)value);
+        return buffer;
+    }
+    for (uint8_t unit = 0; unit < sizeof(UNITS); unit++) {
+        uint32_t scaled;
+        divisor *= 1000;
+        scaled = value / divisor;
+        if (scaled > 0 && decimalDigits(scaled) < width) {
+            snprintf(buffer, width + 1, "%lu%c", (unsigned long)scaled, UNITS[unit]);
+            return buffer;
+        }
+    }
+    for (uint8_t i = 0; i < width; i++)
+        buffer[i] = '#';
+    buffer[width] = '\0';
+    return buffer;
+}
+
+static void fieldReset(TextField *field) {
+    for (uint8_t i = 0; i < field->length; i++)
+        field->shown[i] = ' ';
+}
+
+static uint8_t sparkRow(int16_t mg) {
+    int32_t offset = (int32_t)mg * (SPARK_HEIGHT / 2) / SPARK_FULL_SCALE_MG;
+    if (offset > SPARK_HEIGHT / 2)
+        offset = SPARK_HEIGHT / 2;
+    else if (offset < -(SPARK_HEIGHT / 2))
+        offset = -(SPARK_HEIGHT / 2);
+    return (uint8_t)(SPARK_HEIGHT / 2 - offset);
+}
+
+// Scrolls one column left and appends the new value
+static void sparkPush(Sparkline *spark, int16_t mg) {
+    for (uint8_t i = 0; i < SPARK_WIDTH; i++) {
+        uint8_t next = (i + 1 < SPARK_WIDTH) ? spark->rows[i + 1] : sparkRow(mg);
+        if (next == spark->rows[i])
+            continue;
+        oledC_DrawPoint(SPARK_X + i, spark->y + spark->rows[i], OLEDC_COLOR_BLACK);
+        oledC_DrawPoint(SPARK_X + i, spark->y + next, spark->color);
+        spark->rows[i] = next;
+    }
+}
+
+static void sparkReset(Sparkline *spark) {
+    for (uint8_t i = 0; i < SPARK_WIDTH; i++) {
+        spark->rows[i] = SPARK_HEIGHT / 2;
+        oledC_DrawPoint(SPARK_X + i, spark->y + spark->rows[i], spark->color);
+    }
+}
+
+static void accelPageStart(void) {
+    for (uint8_t axis = 0; axis < AXIS_COUNT; axis++) {
+        fieldReset(&axisFields[axis]);
+        sparkReset(&sparklines[axis]);
+    }
+    fieldReset(&magnitudeField);
+    fieldReset(&rateField);
+    fieldReset(&fifoField);
+    fieldReset(&errorField);
+}
+
+static void accelPageRefresh(const AccelSample *sample, uint16_t sampleRate, uint8_t peakFifo) {
+    static const char AXIS_NAMES[AXIS_COUNT] = {'X', 'Y', 'Z'};
+    char text[DIAG_FIELD_MAX + 1];
+    char transfers[4], operations[4];
+    int16_t mg[AXIS_COUNT] = {
+        sample->x * ACCEL_MG_PER_LSB, sample->y * ACCEL_MG_PER_LSB, sample->z * ACCEL_MG_PER_LSB
+    };
+
+    for (uint8_t axis = 0; axis < AXIS_COUNT; axis++) {
+        snprintf(text, sizeof text, "%c %6d", AXIS_NAMES[axis], mg[axis]);
+        fieldUpdate(&axisFields[axis], text);
+        sparkPush(&sparklines[axis], mg[axis]);
+    }
+
+    float magnitude = sqrtf((float)mg[0] * mg[0] + (float)mg[1] * mg[1] + (float)mg[2] * mg[2]);
+    snprintf(text, sizeof text, "|a| %5u mg", (uint16_t)magnitude);
+    fieldUpdate(&magnitudeField, text);
+
+    snprintf(text, sizeof text, "Rate %3u Hz", sampleRate);
+    fieldUpdate(&rateField, text);
+
+    snprintf(text, sizeof text, "FIFO %2u/%u", peakFifo, ACCEL_FIFO_DEPTH);
+    fieldUpdate(&fifoField, text);
+
+    const AccelErrorCounts *errors = accelSensorErrorCounts();
+    snprintf(text, sizeof text, "I2C err %s/%s", shortCount(transfers, 3, errors->transfers),
+             shortCount(operations, 3, errors->operations));
+    fieldUpdate(&errorField, text);
+}
+
+static void latencyPageStart(void) {
+    char legend[DIAG_FIELD_MAX + 1];
+
+    for (uint8_t source = 0; source < LATENCY_SOURCE_COUNT; source++) {
+        fieldReset(&latencyCountFields[source]);
+        fieldReset(&latencyMaxFields[source]);
+        for (uint8_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++)
+            histogramShown[source][bucket] = 0;
+    }
+    snprintf(legend, sizeof legend, "%uus x2 .. %ums+", LATENCY_FIRST_BUCKET_US,
+            (uint16_t)(((uint32_t)LATENCY_FIRST_BUCKET_US << (LATENCY_BUCKETS - 2)) / 1000));
+    oledC_DrawString(0, LEGEND_Y, 1, 1, (uint8_t *)legend, OLEDC_COLOR_GRAY);
+}
+
+// Bars are scaled to the fullest bucket; only bars whose height changed
+// are redrawn
+static void histogramUpdate(uint8_t source, const LatencyStats *stats) {
+    uint8_t top = latencyCountFields[source].y + HISTOGRAM_TOP;
+    uint16_t peak = 1;
+
+    for (uint8_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+        if (stats->counts[bucket] > peak)
+            peak = stats->counts[bucket];
+    }
+    for (uint8_t bucket = 0; bucket < LATENCY_BUCKETS; bucket++) {
+        uint16_t count = stats->counts[bucket];
+        uint8_t height = (uint32_t)count * HISTOGRAM_HEIGHT / peak;
+        if (count > 0 && height == 0)
+            height = 1;
+        if (height == histogramShown[source][bucket])
+            continue;
+
+        uint8_t x = HISTOGRAM_X + bucket * HISTOGRAM_BAR_ADVANCE;
+        uint8_t bottom = top + HISTOGRAM_HEIGHT - 1;
+        if (height < HISTOGRAM_HEIGHT)
+            oledC_DrawRectangle(x, top, x + HISTOGRAM_BAR_WIDTH - 1, bottom - height, OLEDC_COLOR_BLACK);
+        if (height > 0)
+            oledC_DrawRectangle(x, bottom - height + 1, x + HISTOGRAM_BAR_WIDTH - 1, bottom,
+                                (stats->budgetUs != 0 &&
+                                 ((uint32_t)LATENCY_FIRST_BUCKET_US << bucket) > stats->budgetUs) ?
+                                OLEDC_COLOR_DARKRED : OLEDC_COLOR_SKYBLUE);
+        histogramShown[source][bucket] = height;
+    }
+}
+
+// Worst latency in 4 characters of us or ms, then the count over budget
+static void latencyPageRefresh(void) {
+    char text[DIAG_FIELD_MAX + 1];
+    char worst[5], over[5];
+    LatencyStats stats;
+
+    for (uint8_t source = 0; source < LATENCY_SOURCE_COUNT; source++) {
+        latencyMonitorSnapshot((LatencySource)source, &stats);
+
+        snprintf(text, sizeof text, "%-4s n %u", LATENCY_NAMES[source], stats.events);
+        fieldUpdate(&latencyCountFields[source], text);
+
+        shortCount(over, 4, stats.overBudget);
+        if (stats.maxUs < 10000)
+            snprintf(text, sizeof text, "max %4luus >%s", (unsigned long)stats.maxUs, over);
+        else
+            snprintf(text, sizeof text, "max %4sms >%s", shortCount(worst, 4, stats.maxUs / 1000), over);
+        fieldUpdate(&latencyMaxFields[source], text);
+
+        histogramUpdate(source, &stats);
+    }
+}
+
+static void samplingPageStart(void) {
+    fieldReset(&samplingCountField);
+    fieldReset(&samplingMeanField);
+    fieldReset(&samplingDeviationField);
+    fieldReset(&samplingJitterField);
+    fieldReset(&samplingViolationField);
+    fieldReset(&samplingDropField);
+    fieldReset(&samplingOverrunField);
+    samplingFlagShown = -1;
+    oledC_DrawString(0, 2, 1, 1, (uint8_t *)"Step sampling", OLEDC_COLOR_GRAY);
+}
+
+// Milliseconds with one decimal, whole ones from a second up; label is
+// four characters and text a field buffer
+static void formatMs(char *text, const char *label, uint32_t us) {
+    char ms[5];
+
+    if (us < 1000000)
+        snprintf(text, DIAG_FIELD_MAX + 1, "%s %3lu.%lums", label, (unsigned long)(us / 1000),
+                 (unsigned long)(us % 1000 / 100));
+    else
+        snprintf(text, DIAG_FIELD_MAX + 1, "%s %4sms", label, shortCount(ms, 4, us / 1000));
+}
+
+// The counters stand still while this page is open: the detector only
+// samples on the clock face
+static void samplingPageRefresh(void) {
+    char text[DIAG_FIELD_MAX + 1];
+    char count[7], nominal[5];
+    SamplingStats stats;
+
+    samplingMonitorStats(&stats);
+
+    snprintf(text, sizeof text, "n %s /%sms", shortCount(count, 6, stats.intervals),
+             shortCount(nominal, 4, stats.nominalUs / 1000));
+    fieldUpdate(&samplingCountField, text);
+    formatMs(text, "mean", stats.meanUs);
+    fieldUpdate(&samplingMeanField, text);
+    formatMs(text, "sd  ", stats.stddevUs);
+    fieldUpdate(&samplingDeviationField, text);
+    formatMs(text, "jit ", stats.maxJitterUs);
+    fieldUpdate(&samplingJitterField, text);
+    snprintf(text, sizeof text, "late %lu", (unsigned long)stats.violations);
+    fieldUpdate(&samplingViolationField, text);
+    snprintf(text, sizeof text, "drop %lu", (unsigned long)stats.dropped);
+    fieldUpdate(&samplingDropField, text);
+    snprintf(text, sizeof text, "ovf %u", stats.overruns);
+    fieldUpdate(&samplingOverrunField, text);
+
+    if (samplingFlagShown != stats.violated) {
+        oledC_DrawRectangle(SAMPLING_FLAG_X, 2, SAMPLING_FLAG_X + SAMPLING_FLAG_SIZE - 1,
+                            2 + SAMPLING_FLAG_SIZE - 1,
+                            stats.violated ? OLEDC_COLOR_DARKRED : OLEDC_COLOR_GREEN);
+        samplingFlagShown = stats.violated;
+    }
+}
+
+static const char *taskName(TaskId task) {
+    return (task < TASK_COUNT) ? TASK_NAMES[task] : "-";
+}
+
+static void tasksPageStart(void) {
+    for (uint8_t task = 0; task < TASK_COUNT; task++)
+        fieldReset(&taskFields[task]);
+    fieldReset(&offenderField);
+    fieldReset(&watchdogField);
+    oledC_DrawString(0, 0, 1, 1, (uint8_t *)"    ovr mis   ms", OLEDC_COLOR_GRAY);
+}
+
+// Split so that no product overflows 32 bits
+static uint32_t ticksToMs(uint32_t ticks) {
+    return ticks / TIMER1_TICKS_PER_SECOND * 1000 +
+           ticks % TIMER1_TICKS_PER_SECOND * 1000 / TIMER1_TICKS_PER_SECOND;
+}
+
+// Overruns, missed deadlines and the longest run of each task, in
+// columns of 3, 3 and 4 characters
+static void tasksPageRefresh(void) {
+    char text[DIAG_FIELD_MAX + 1];
+    char overruns[4], missed[4], worst[5];
+    TaskStats task;
+    SupervisorStats totals;
+
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        taskSupervisorTaskStats((TaskId)i, &task);
+        snprintf(text, sizeof text, "%-4s%3s %3s %4s", TASK_NAMES[i],
+                 shortCount(overruns, 3, task.overruns), shortCount(missed, 3, task.missedDeadlines),
+                 shortCount(worst, 4, ticksToMs(task.worstTicks)));
+        fieldUpdate(&taskFields[i], text);
+    }
+
+    taskSupervisorStats(&totals);
+    snprintf(text, sizeof text, "last %s", taskName(totals.lastOffender));
+    fieldUpdate(&offenderField, text);
+    snprintf(text, sizeof text, "WDT %u %s", totals.watchdogResets, taskName(totals.watchdogCulprit));
+    fieldUpdate(&watchdogField, text);
+}
+
+static void displayPageStart(void) {
+    fieldReset(&litNowField);
+    fieldReset(&litAverageField);
+    fieldReset(&litPeakField);
+    fieldReset(&pixelsField);
+    fieldReset(&fillsField);
+    fieldReset(&profileField);
+    oledC_DrawString(0, 2, 1, 1, (uint8_t *)"Display lit", OLEDC_COLOR_GRAY);
+}
+
+// Lit weights in percent of a full white panel. The current figure is
+// this page's own; the average covers the screens shown since start-up.
+static void displayPageRefresh(void) {
+    char text[DIAG_FIELD_MAX + 1];
+    oledc_render_stats_t stats;
+    OLEDC_PANEL_PROFILE profile = oledC_getPanelProfile();
+
+    oledC_getRenderStats(&stats);
+    snprintf(text, sizeof text, "now  %3u.%u%%", stats.litPermille / 10, stats.litPermille % 10);
+    fieldUpdate(&litNowField, text);
+    snprintf(text, sizeof text, "avg  %3u.%u%%", stats.averageLitPermille / 10, stats.averageLitPermille % 10);
+    fieldUpdate(&litAverageField, text);
+    snprintf(text, sizeof text, "peak %3u.%u%%", stats.peakLitPermille / 10, stats.peakLitPermille % 10);
+    fieldUpdate(&litPeakField, text);
+    snprintf(text, sizeof text, "px %lu", (unsigned long)stats.pixelsWritten);
+    fieldUpdate(&pixelsField, text);
+    snprintf(text, sizeof text, "fills %lu", (unsigned long)stats.fills);
+    fieldUpdate(&fillsField, text);
+    snprintf(text, sizeof text, "%s", profile < OLEDC_PANEL_PROFILE_COUNT ? PANEL_PROFILE_NAMES[profile] : "-");
+    fieldUpdate(&profileField, text);
+}
+
+static void pageStart(DiagPage page) {
+    oledC_clearScreen();
+    if (page == DIAG_PAGE_ACCEL)
+        accelPageStart();
+    else if (page == DIAG_PAGE_LATENCY)
+        latencyPageStart();
+    else if (page == DIAG_PAGE_SAMPLING)
+        samplingPageStart();
+    else if (page == DIAG_PAGE_TASKS)
+        tasksPageStart();
+    else
+        displayPageStart();
+}
+
+static bool anyButtonPressed(void) {
+    return PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0;
+}
+
+void diagnosticsRun(uint32_t (*ticks)(void)) {
+    DiagPage page = DIAG_PAGE_ACCEL;
+    AccelSample sample = {0, 0, 0};
+    uint32_t lastRefresh = ticks();
+    uint32_t rateWindowStart = lastRefresh;
+    uint16_t samplesInWindow = 0;
+    uint16_t sampleRate = 0;
+    uint8_t peakFifo = 0;
+
+    pageStart(page);
+    while (anyButtonPressed()) taskSupervisorIdleDelay(10);
+
+    while (PORTAbits.RA11 != 0) {
+        taskSupervisorCheckIn(TASK_UI_PAGE);
+        if (PORTAbits.RA12 == 0) {
+            page = (page + 1) % DIAG_PAGE_COUNT;
+            pageStart(page);
+            while (anyButtonPressed()) taskSupervisorIdleDelay(10);
+        }
+
+        // Sampling continues on every page so the rate stays meaningful
+        uint8_t entries = accelSensorFifoEntries();
+        if (entries > peakFifo)
+            peakFifo = entries;
+        while (entries-- > 0 && accelSensorReadSample(&sample)) {
+            fallDetectorAddSample(&sample);
+            samplesInWindow++;
+        }
+
+        uint32_t now = ticks();
+        if (now - rateWindowStart >= TIMER1_TICKS_PER_SECOND) {
+            sampleRate = (uint32_t)samplesInWindow * TIMER1_TICKS_PER_SECOND / (now - rateWindowStart);
+            samplesInWindow = 0;
+            rateWindowStart = now;
+        }
+        if (now - lastRefresh < DIAG_REFRESH_TICKS) {
+            DELAY_milliseconds(5);
+            continue;
+        }
+        lastRefresh = now;
+
+        if (page == DIAG_PAGE_ACCEL) {
+            accelPageRefresh(&sample, sampleRate, peakFifo);
+            peakFifo = 0;
+        } else if (page == DIAG_PAGE_LATENCY) {
+            latencyPageRefresh();
+        } else if (page == DIAG_PAGE_SAMPLING) {
+            samplingPageRefresh();
+        } else if (page == DIAG_PAGE_TASKS) {
+            tasksPageRefresh();
+        } else {
+            displayPageRefresh();
+        }
+    }
+
+    while (anyButtonPressed()) taskSupervisorIdleDelay(10);
+}
@@ -0,0 +1,20 @@
+/*
+ * File: diagnostics.h
+ * Project: Smart Watch - Final Version
+ * Description: Live diagnostics pages: accelerometer (raw axes, magnitude,
+ *              sample rate, FIFO level, I2C errors and per-axis sparklines),
+ *              interrupt latency histograms, step sampling conformance and
+ *              per-task overruns, missed deadlines and watchdog resets, and
+ *              the display's lit-pixel weight and rendering counts.
+ */
+
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <stdint.h>
+
+// Runs the pages until BUTTON1 is pressed and released; BUTTON2 shows the
+// next page. ticks returns a monotonic time in Timer1 ticks.
+void diagnosticsRun(uint32_t (*ticks)(void));
+
+#endif // DIAGNOSTICS_H
@@ -0,0 +1,110 @@
+/*
+ * File: fallDetector.c
+ * Project: Smart Watch - Final Version
+ * Description: Free-fall trigger with pre/post-trigger capture.
+ *
+ * The sensor compares every 100 Hz sample against the free-fall threshold
+ * itself and latches FREE_FALL, so even a drop shorter than one main-loop pass is
+ * seen without the CPU polling for it. Samples drained from the FIFO
+ * stream go through a ring buffer; when the interrupt is serviced the
+ * ring already holds the pre-trigger history, and the next
+ * FALL_POST_TRIGGER_SAMPLES complete the capture. A fall is confirmed
+ * when the post-trigger part contains an impact.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "accelSensor.h"
+#include "fallDetector.h"
+
+#define FALL_THRESHOLD_MG       500
+#define FALL_TIME_MS            50
+#define FALL_IMPACT_LSB         (2500 / ACCEL_MG_PER_LSB)   // 2.5 g
+
+static AccelSample ring[FALL_CAPTURE_SAMPLES];
+static AccelSample capture[FALL_CAPTURE_SAMPLES];
+static uint8_t ringHead;
+static uint8_t postRemaining;
+static bool confirmed;
+static uint16_t peakMg;
+
+static uint16_t squareRoot(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value)
+        bit >>= 2;
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint16_t)root;
+}
+
+static uint32_t magnitudeSquared(const AccelSample *sample) {
+    return (int32_t)sample->x * sample->x + (int32_t)sample->y * sample->y +
+           (int32_t)sample->z * sample->z;
+}
+
+// Unrolls the ring into capture[] and looks for the impact after the trigger
+static void evaluateCapture(void) {
+    uint32_t peak = 0;
+
+    for (uint8_t i = 0; i < FALL_CAPTURE_SAMPLES; i++)
+        capture[i] = ring[(ringHead + i) % FALL_CAPTURE_SAMPLES];
+
+    for (uint8_t i = FALL_PRE_TRIGGER_SAMPLES; i < FALL_CAPTURE_SAMPLES; i++) {
+        uint32_t magnitude = magnitudeSquared(&capture[i]);
+        if (magnitude > peak)
+            peak = magnitude;
+    }
+    if (peak < (uint32_t)FALL_IMPACT_LSB * FALL_IMPACT_LSB)
+        return;
+
+    peakMg = squareRoot(peak) * ACCEL_MG_PER_LSB;
+    confirmed = true;
+}
+
+bool fallDetectorInit(void) {
+    memset(ring, 0, sizeof(ring));
+    ringHead = 0;
+    postRemaining = 0;
+    confirmed = false;
+
+    return accelSensorConfigureFreeFall(FALL_THRESHOLD_MG, FALL_TIME_MS) &&
+           accelSensorEnableInterrupts(ACCEL_INT_FREE_FALL);
+}
+
+void fallDetectorAddSample(const AccelSample *sample) {
+    ring[ringHead] = *sample;
+    ringHead = (ringHead + 1) % FALL_CAPTURE_SAMPLES;
+
+    if (postRemaining > 0 && --postRemaining == 0)
+        evaluateCapture();
+}
+
+void fallDetectorTrigger(void) {
+    // A fall re-triggers while tumbling; keep the first capture window
+    if (postRemaining == 0)
+        postRemaining = FALL_POST_TRIGGER_SAMPLES;
+}
+
+bool fallDetectorTakeConfirmed(void) {
+    bool result = confirmed;
+    confirmed = false;
+    return result;
+}
+
+uint16_t fallDetectorPeakMg(void) {
+    return peakMg;
+}
+
+void fallDetectorCopyCapture(AccelSample *samples) {
+    memcpy(samples, capture, sizeof(capture));
+}
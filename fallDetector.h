@@ -0,0 +1,37 @@
+/*
+ * File: fallDetector.h
+ * Project: Smart Watch - Final Version
+ * Description: Fall/impact detection. The ADXL345 free-fall detector raises
+ *              the interrupt; the samples around it are captured from the
+ *              FIFO stream and checked for an impact before logging.
+ */
+
+#ifndef FALL_DETECTOR_H
+#define FALL_DETECTOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "accelSensor.h"
+
+#define FALL_PRE_TRIGGER_SAMPLES    16
+#define FALL_POST_TRIGGER_SAMPLES   48
+#define FALL_CAPTURE_SAMPLES        (FALL_PRE_TRIGGER_SAMPLES + FALL_POST_TRIGGER_SAMPLES)
+
+// Programs THRESH_FF/TIME_FF and enables the free-fall interrupt.
+bool fallDetectorInit(void);
+
+// Feeds every sample drained from the FIFO, in order.
+void fallDetectorAddSample(const AccelSample *sample);
+
+// Called when INT_SOURCE reports FREE_FALL; starts the post-trigger capture.
+void fallDetectorTrigger(void);
+
+// True once per confirmed fall (free fall followed by an impact).
+bool fallDetectorTakeConfirmed(void);
+
+// Peak impact of the last confirmed fall, in mg, and its capture window
+// (oldest sample first, FALL_PRE_TRIGGER_SAMPLES before the trigger).
+uint16_t fallDetectorPeakMg(void);
+void fallDetectorCopyCapture(AccelSample *samples);
+
+#endif // FALL_DETECTOR_H
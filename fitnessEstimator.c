@@ -0,0 +1,112 @@
+/*
+ * File: fitnessEstimator.c
+ * Project: Smart Watch - Final Version
+ * Description: Per-step distance and energy integration.
+ *
+ * Cadence comes from a smoothed step interval. Stride length is the
+ * wearer's height times a cadence-dependent ratio, interpolated from a
+ * short table. Active energy uses the ACSM walking/running equations
+ * minus the resting 3.5 ml/kg/min term; per step this reduces to
+ *   cal = coefficient * stride(m) * weight(kg) * 5
+ * so each step costs one division (cadence) and a few multiplies.
+ */
+
+#include <stdint.h>
+#include "timebase.h"
+#include "historyStore.h"
+#include "fitnessEstimator.h"
+
+#define TICKS_PER_MINUTE        (TIMER1_TICKS_PER_SECOND * 60)
+#define STEP_GAP_TICKS          (TIMER1_TICKS_PER_SECOND * 2)   // longer pause: stopped
+#define DEFAULT_CADENCE         100             // assumed for the first step
+#define RUNNING_CADENCE         140             // switches to the running equation
+#define WALK_COEFFICIENT_X10    1               // 0.1 ml/kg per metre
+#define RUN_COEFFICIENT_X10     2               // 0.2 ml/kg per metre
+
+typedef struct {
+    uint8_t cadence;        // steps per minute
+    uint8_t ratio;          // stride / height, percent
+} StrideBreakpoint;
+
+static const StrideBreakpoint STRIDE_TABLE[] = {
+    {80, 38}, {100, 41}, {120, 45}, {140, 55}, {160, 65}, {180, 70}
+};
+#define STRIDE_TABLE_SIZE (sizeof(STRIDE_TABLE) / sizeof(STRIDE_TABLE[0]))
+
+static uint32_t distanceMm;
+static uint32_t energyCal;
+static uint32_t lastStepTicks;
+static uint32_t smoothedInterval;
+
+static uint16_t strideRatio(uint16_t stepsPerMinute) {
+    const StrideBreakpoint *low = &STRIDE_TABLE[0];
+    const StrideBreakpoint *high = &STRIDE_TABLE[STRIDE_TABLE_SIZE - 1];
+
+    if (stepsPerMinute <= low->cadence)
+        return low->ratio;
+    if (stepsPerMinute >= high->cadence)
+        return high->ratio;
+
+    // Breakpoints are 20 spm apart, so the segment is found by index
+    high = &STRIDE_TABLE[(stepsPerMinute - low->cadence) / 20 + 1];
+    low = high - 1;
+    return low->ratio + (uint16_t)(high->ratio - low->ratio) * (stepsPerMinute - low->cadence)
+                        / (high->cadence - low->cadence);
+}
+
+void fitnessEstimatorReset(void) {
+    distanceMm = 0;
+    energyCal = 0;
+    smoothedInterval = 0;
+}
+
+void fitnessEstimatorRestore(uint32_t savedDistanceMm, uint32_t savedEnergyCal) {
+    distanceMm = savedDistanceMm;
+    energyCal = savedEnergyCal;
+}
+
+void fitnessEstimatorOnStep(uint32_t ticks) {
+    uint32_t interval = ticks - lastStepTicks;
+    uint32_t strideMm;
+    uint16_t cadence;
+
+    lastStepTicks = ticks;
+    if (smoothedInterval == 0 || interval > STEP_GAP_TICKS) {
+        smoothedInterval = TICKS_PER_MINUTE / DEFAULT_CADENCE;
+    } else {
+        // EMA with alpha 1/4: cadence follows within a few steps
+        smoothedInterval = smoothedInterval - (smoothedInterval >> 2) + (interval >> 2);
+        if (smoothedInterval == 0)
+            smoothedInterval = 1;
+    }
+    cadence = TICKS_PER_MINUTE / smoothedInterval;
+
+    strideMm = (uint32_t)FITNESS_HEIGHT_CM * 10 * strideRatio(cadence) / 100;
+    distanceMm += strideMm;
+    energyCal += strideMm * FITNESS_WEIGHT_KG * 5
+                 * (cadence >= RUNNING_CADENCE ? RUN_COEFFICIENT_X10 : WALK_COEFFICIENT_X10)
+                 / 10000;
+}
+
+uint32_t fitnessDistanceMm(void) {
+    return distanceMm;
+}
+
+uint32_t fitnessEnergyCal(void) {
+    return energyCal;
+}
+
+void fitnessEstimatorCloseDay(uint32_t dayStart) {
+    HistoryRecord record;
+    record.timestamp = dayStart;
+
+    record.type = HISTORY_RECORD_DISTANCE;
+    record.value = (distanceMm / 10000 > 0xFFFF) ? 0xFFFF : distanceMm / 10000;
+    historyStoreAppend(&record);
+
+    record.type = HISTORY_RECORD_ENERGY;
+    record.value = (energyCal / 1000 > 0xFFFF) ? 0xFFFF : energyCal / 1000;
+    historyStoreAppend(&record);
+
+    fitnessEstimatorReset();
+}
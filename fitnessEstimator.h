@@ -0,0 +1,32 @@
+/*
+ * File: fitnessEstimator.h
+ * Project: Smart Watch - Final Version
+ * Description: Distance and active-energy estimates from step events, kept
+ *              as running daily totals.
+ */
+
+#ifndef FITNESS_ESTIMATOR_H
+#define FITNESS_ESTIMATOR_H
+
+#include <stdint.h>
+
+// Wearer profile used by the stride and energy models
+#define FITNESS_HEIGHT_CM       170
+#define FITNESS_WEIGHT_KG       70
+
+void fitnessEstimatorReset(void);
+
+// Puts back today's totals saved before a reset
+void fitnessEstimatorRestore(uint32_t distanceMm, uint32_t energyCal);
+
+// Accounts for one step; ticks is a monotonic time in Timer1 ticks.
+void fitnessEstimatorOnStep(uint32_t ticks);
+
+uint32_t fitnessDistanceMm(void);       // today
+uint32_t fitnessEnergyCal(void);        // today, active energy (small calories)
+
+// Logs today's totals to the history store and starts a new day.
+// dayStart is the history timestamp of the day being closed.
+void fitnessEstimatorCloseDay(uint32_t dayStart);
+
+#endif // FITNESS_ESTIMATOR_H
@@ -0,0 +1,241 @@
+/*
+ * File: historyBrowser.c
+ * Project: Smart Watch - Final Version
+ * Description: Day-by-day step history read from the flash log.
+ *
+ * Nothing but the visible day is held in RAM: a cursor seeks to the start
+ * of the day and the step records are decimated on the fly into one bin
+ * per graph column, so a page costs the records of one day whatever the
+ * length of the log. Step blocks are decoded segment by segment. A block
+ * is stamped with its end, so the one holding the last minutes of the day
+ * can be logged after records of the next morning; loading stops at the
+ * first block ending past midnight, or once no block can reach back into
+ * the day. While the screen waits for a button, the day the
+ * wearer is likely to open next is read into a second page in small
+ * slices; when it is requested it is already binned and only drawn.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "System/delay.h"
+#include "oledDriver/oledC.h"
+#include "oledDriver/oledC_colors.h"
+#include "oledDriver/oledC_shapes.h"
+#include "historyStore.h"
+#include "historyCodec.h"
+#include "stepLog.h"
+#include "taskSupervisor.h"
+#include "historyBrowser.h"
+
+#define MINUTES_PER_DAY         (24 * 60)
+#define BROWSER_COLUMNS         90
+#define MINUTES_PER_COLUMN      (MINUTES_PER_DAY / BROWSER_COLUMNS)    // 16
+
+#define GRAPH_X                 3
+#define GRAPH_TOP               12
+#define GRAPH_BOTTOM            81
+#define GRAPH_HEIGHT            (GRAPH_BOTTOM - GRAPH_TOP + 1)
+#define LABEL_Y                 85
+
+#define PREFETCH_SLICE_RECORDS  32
+#define POLL_MS                 10
+
+typedef struct {
+    uint32_t dayStart;
+    uint16_t columns[BROWSER_COLUMNS];
+    uint32_t total;
+    HistoryCursor cursor;
+    bool loading;
+    bool ready;
+} DayPage;
+
+static const char *const MONTH_NAMES[12] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+static DayPage pages[2];
+
+static void pageStart(DayPage *page, uint32_t dayStart) {
+    page->dayStart = dayStart;
+    memset(page->columns, 0, sizeof(page->columns));
+    page->total = 0;
+    historyCursorSeek(&page->cursor, dayStart);
+    page->loading = true;
+    page->ready = false;
+}
+
+static void binSteps(DayPage *page, uint32_t timestamp, uint16_t steps) {
+    if (steps == 0 || timestamp < page->dayStart || timestamp >= page->dayStart + MINUTES_PER_DAY)
+        return;
+    uint16_t *column = &page->columns[(timestamp - page->dayStart) / MINUTES_PER_COLUMN];
+    *column = (*column > 0xFFFF - steps) ? 0xFFFF : *column + steps;
+    page->total += steps;
+}
+
+// Idle runs carry no steps, so only the single-minute segments are binned
+static void binBlock(DayPage *page, uint32_t start, const uint8_t *data, uint8_t length) {
+    HistoryCodecDecoder decoder;
+    HistoryCodecSegment segment;
+
+    historyCodecDecoderStart(&decoder, start, data, length);
+    while (historyCodecDecodeNext(&decoder, &segment))
+        binSteps(page, segment.timestamp, segment.count);
+}
+
+// The block still being filled in RAM, clipped to the page like the rest
+static void binPending(DayPage *page) {
+    uint8_t data[HISTORY_BLOB_MAX_BYTES];
+    uint32_t start;
+    uint8_t length = stepLogPending(&start, data);
+
+    if (length > 0)
+        binBlock(page, start, data, length);
+}
+
+// Bins up to maxRecords more records of the page's day
+static void pageStep(DayPage *page, uint16_t maxRecords) {
+    uint32_t dayEnd = page->dayStart + MINUTES_PER_DAY;
+    HistoryRecord record;
+    uint8_t data[HISTORY_BLOB_MAX_BYTES];
+    bool last = false;
+
+    while (page->loading && maxRecords-- > 0) {
+        if (!historyCursorNext(&page->cursor, &record) ||
+            record.timestamp >= dayEnd + HISTORY_CODEC_MAX_MINUTES) {
+            last = true;
+        } else if (record.type == HISTORY_RECORD_STEPS) {
+            binSteps(page, record.timestamp, record.value);
+        } else if (record.type == HISTORY_RECORD_STEP_BLOCK) {
+            // The payload starts with the block's length in minutes
+            if (historyCursorReadBlob(&page->cursor, &record, data) && record.value > 0 &&
+                data[0] <= HISTORY_CODEC_MAX_MINUTES)
+                binBlock(page, record.timestamp - data[0], &data[1], record.value - 1);
+            last = (record.timestamp >= dayEnd);
+        }
+        if (last) {
+            binPending(page);
+            page->loading = false;
+            page->ready = true;
+        }
+    }
+}
+
+static void pageLoad(DayPage *page, uint32_t dayStart) {
+    if (page->dayStart != dayStart || (!page->loading && !page->ready))
+        pageStart(page, dayStart);
+    while (page->loading)
+        pageStep(page, 0xFFFF);
+}
+
+static void drawFrame(void) {
+    static const uint8_t HOURS[] = {0, 6, 12, 18};
+    char label[3];
+
+    oledC_clearScreen();
+    oledC_DrawRectangle(GRAPH_X, GRAPH_BOTTOM + 1, GRAPH_X + BROWSER_COLUMNS - 1, GRAPH_BOTTOM + 1,
+                        OLEDC_COLOR_GHOSTWHITE);
+    for (uint8_t i = 0; i < sizeof(HOURS); i++) {
+        uint8_t x = GRAPH_X + (uint16_t)HOURS[i] * BROWSER_COLUMNS / 24;
+        oledC_DrawRectangle(x, GRAPH_BOTTOM + 2, x, GRAPH_BOTTOM + 3, OLEDC_COLOR_GHOSTWHITE);
+        sprintf(label, "%u", HOURS[i]);
+        oledC_DrawString(x, LABEL_Y, 1, 1, (uint8_t *)label, OLEDC_COLOR_WHITE);
+    }
+}
+
+static void drawPage(const DayPage *page) {
+    uint16_t peak = 1;
+    uint8_t month, day;
+    char text[12];
+
+    oledC_DrawRectangle(0, 0, 95, GRAPH_TOP - 2, OLEDC_COLOR_BLACK);
+    historyDate(page->dayStart, &month, &day);
+    sprintf(text, "%s %02u", MONTH_NAMES[month - 1], day);
+    oledC_DrawString(0, 0, 1, 1, (uint8_t *)text, OLEDC_COLOR_WHITE);
+    sprintf(text, "%lu", (unsigned long)page->total);
+    oledC_DrawString(96 - 6 * strlen(text), 0, 1, 1, (uint8_t *)text, OLEDC_COLOR_SKYBLUE);
+
+    for (uint8_t i = 0; i < BROWSER_COLUMNS; i++) {
+        if (page->columns[i] > peak)
+            peak = page->columns[i];
+    }
+    // Each column is one fill for the bar and one for the space above it
+    for (uint8_t i = 0; i < BROWSER_COLUMNS; i++) {
+        uint8_t x = GRAPH_X + i;
+        uint8_t height = (uint32_t)page->columns[i] * GRAPH_HEIGHT / peak;
+        if (height < GRAPH_HEIGHT)
+            oledC_DrawRectangle(x, GRAPH_TOP, x, GRAPH_BOTTOM - height, OLEDC_COLOR_BLACK);
+        if (height > 0)
+            oledC_DrawRectangle(x, GRAPH_BOTTOM - height + 1, x, GRAPH_BOTTOM, OLEDC_COLOR_BLUE);
+    }
+}
+
+// From the history index, so opening the screen costs the same after the
+// New Year or a clock set back, when the oldest records lie after today
+static uint32_t oldestDay(uint32_t today) {
+    uint32_t timestamp;
+
+    if (!historyOldestRunStart(today, &timestamp))
+        return today;
+    return timestamp - timestamp % MINUTES_PER_DAY;
+}
+
+void historyBrowserRun(uint32_t today) {
+    DayPage *shown = &pages[0];
+    DayPage *spare = &pages[1];
+    uint32_t firstDay = oldestDay(today);
+    int8_t direction = -1;      // the wearer starts at today, so older is next
+
+    spare->loading = false;
+    spare->ready = false;
+    pageLoad(shown, today);
+    drawFrame();
+    drawPage(shown);
+    if (today > firstDay)
+        pageStart(spare, today - MINUTES_PER_DAY);
+
+    while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) taskSupervisorIdleDelay(POLL_MS);
+
+    while (true) {
+        taskSupervisorCheckIn(TASK_UI_PAGE);
+        bool button1Pressed = (PORTAbits.RA11 == 0);
+        bool button2Pressed = (PORTAbits.RA12 == 0);
+        uint32_t target;
+
+        if (button1Pressed && button2Pressed)
+            break;
+        if (button1Pressed && shown->dayStart > firstDay) {
+            direction = -1;
+            target = shown->dayStart - MINUTES_PER_DAY;
+        } else if (button2Pressed && shown->dayStart < today) {
+            direction = 1;
+            target = shown->dayStart + MINUTES_PER_DAY;
+        } else {
+            if (spare->loading)
+                pageStep(spare, PREFETCH_SLICE_RECORDS);
+            else
+                DELAY_milliseconds(POLL_MS);
+            continue;
+        }
+
+        pageLoad(spare, target);
+        DayPage *previous = shown;
+        shown = spare;
+        spare = previous;
+        drawPage(shown);
+
+        target = shown->dayStart + direction * (int32_t)MINUTES_PER_DAY;
+        if ((direction < 0 && shown->dayStart > firstDay) || (direction > 0 && shown->dayStart < today))
+            pageStart(spare, target);
+
+        while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) {
+            if (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0)
+                break;
+            taskSupervisorIdleDelay(POLL_MS);
+        }
+    }
+
+    while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) taskSupervisorIdleDelay(POLL_MS);
+}
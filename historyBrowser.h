@@ -0,0 +1,17 @@
+/*
+ * File: historyBrowser.h
+ * Project: Smart Watch - Final Version
+ * Description: Day-by-day step history read from the flash log.
+ */
+
+#ifndef HISTORY_BROWSER_H
+#define HISTORY_BROWSER_H
+
+#include <stdint.h>
+
+// Shows one day per page, starting at today (a historyTimestamp at
+// 00:00). BUTTON1 pages to older days, BUTTON2 to newer ones, both
+// buttons together return.
+void historyBrowserRun(uint32_t today);
+
+#endif // HISTORY_BROWSER_H
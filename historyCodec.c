@@ -0,0 +1,131 @@
+/*
+ * File: historyCodec.c
+ * Project: Smart Watch - Final Version
+ * Description: Delta, zig-zag, varint and run-length coding of per-minute
+ *              step counts.
+ *
+ * Zero minutes are never written as literals: they extend a pending run,
+ * which is emitted when the next non-zero minute arrives or the block is
+ * finished. The encoder always keeps room for the pending run token, so a
+ * block refused as full still finishes cleanly.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "historyCodec.h"
+
+static uint8_t varintSize(uint32_t value) {
+    uint8_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static void putVarint(HistoryCodecEncoder *encoder, uint32_t value) {
+    while (value >= 0x80) {
+        encoder->data[encoder->length++] = (value & 0x7F) | 0x80;
+        value >>= 7;
+    }
+    encoder->data[encoder->length++] = value;
+}
+
+static uint32_t literalToken(uint16_t previous, uint16_t count) {
+    int32_t delta = (int32_t)count - previous;
+    uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+    return zigzag << 1;
+}
+
+static uint32_t runToken(uint16_t run) {
+    return ((uint32_t)(run - 1) << 1) | 1;
+}
+
+static void emitRun(HistoryCodecEncoder *encoder) {
+    if (encoder->idleRun == 0)
+        return;
+    putVarint(encoder, runToken(encoder->idleRun));
+    encoder->idleRun = 0;
+    encoder->previous = 0;
+}
+
+void historyCodecEncoderStart(HistoryCodecEncoder *encoder) {
+    encoder->previous = 0;
+    encoder->idleRun = 0;
+    encoder->minutes = 0;
+    encoder->length = 0;
+}
+
+bool historyCodecEncodeMinute(HistoryCodecEncoder *encoder, uint16_t count) {
+    uint8_t needed;
+
+    if (encoder->minutes >= HISTORY_CODEC_MAX_MINUTES)
+        return false;
+
+    if (count == 0) {
+        if (encoder->length + varintSize(runToken(encoder->idleRun + 1)) > HISTORY_CODEC_BLOCK_BYTES)
+            return false;
+        encoder->idleRun++;
+    } else {
+        if (encoder->idleRun > 0)
+            needed = varintSize(runToken(encoder->idleRun)) + varintSize(literalToken(0, count));
+        else
+            needed = varintSize(literalToken(encoder->previous, count));
+        if (encoder->length + needed > HISTORY_CODEC_BLOCK_BYTES)
+            return false;
+        emitRun(encoder);
+        putVarint(encoder, literalToken(encoder->previous, count));
+        encoder->previous = count;
+    }
+    encoder->minutes++;
+    return true;
+}
+
+uint8_t historyCodecEncoderFinish(HistoryCodecEncoder *encoder) {
+    emitRun(encoder);
+    return encoder->length;
+}
+
+void historyCodecDecoderStart(HistoryCodecDecoder *decoder, uint32_t base,
+                              const uint8_t *data, uint8_t length) {
+    decoder->data = data;
+    decoder->length = length;
+    decoder->position = 0;
+    decoder->previous = 0;
+    decoder->timestamp = base;
+}
+
+bool historyCodecDecodeNext(HistoryCodecDecoder *decoder, HistoryCodecSegment *segment) {
+    uint32_t token = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+
+    if (decoder->position >= decoder->length)
+        return false;
+    do {
+        if (decoder->position >= decoder->length || shift > 21)
+            return false;
+        byte = decoder->data[decoder->position++];
+        token |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    segment->timestamp = decoder->timestamp;
+    if (token & 1) {
+        if ((token >> 1) >= 0xFFFF)
+            return false;
+        segment->count = 0;
+        segment->minutes = (token >> 1) + 1;
+        decoder->previous = 0;
+    } else {
+        uint32_t zigzag = token >> 1;
+        int32_t count = (int32_t)decoder->previous + (int32_t)((zigzag >> 1) ^ -(zigzag & 1));
+        if (count < 0 || count > 0xFFFF)
+            return false;
+        segment->count = count;
+        segment->minutes = 1;
+        decoder->previous = count;
+    }
+    decoder->timestamp += segment->minutes;
+    return true;
+}
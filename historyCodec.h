@@ -0,0 +1,66 @@
+/*
+ * File: historyCodec.h
+ * Project: Smart Watch - Final Version
+ * Description: Compact encoding of per-minute step counts for the history
+ *              log.
+ *
+ * A block carries consecutive minutes from a base timestamp (kept in the
+ * block's header record, not in the payload). Each token is an unsigned
+ * LEB128 varint whose low bit selects its meaning:
+ *   0  one minute, count = previous count + zigzag-decoded (token >> 1)
+ *   1  (token >> 1) + 1 idle minutes with a count of zero
+ * Per-minute counts change slowly and idle stretches dominate, so most
+ * minutes cost one byte and a quiet hour costs one or two.
+ *
+ * Neither side needs more RAM than the structures below. No device
+ * dependencies: builds on a host compiler for off-target checks.
+ */
+
+#ifndef HISTORY_CODEC_H
+#define HISTORY_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define HISTORY_CODEC_BLOCK_BYTES   40
+#define HISTORY_CODEC_MAX_MINUTES   240     // a block never spans more
+
+typedef struct {
+    uint16_t previous;          // count of the last literal minute
+    uint16_t idleRun;           // zero minutes not emitted yet
+    uint16_t minutes;           // minutes in the block so far
+    uint8_t length;
+    uint8_t data[HISTORY_CODEC_BLOCK_BYTES];
+} HistoryCodecEncoder;
+
+typedef struct {
+    const uint8_t *data;
+    uint8_t length;
+    uint8_t position;
+    uint16_t previous;
+    uint32_t timestamp;         // of the next segment
+} HistoryCodecDecoder;
+
+// A stretch of minutes with the same count (minutes > 1 only when idle)
+typedef struct {
+    uint32_t timestamp;
+    uint16_t count;
+    uint16_t minutes;
+} HistoryCodecSegment;
+
+void historyCodecEncoderStart(HistoryCodecEncoder *encoder);
+
+// Appends the next minute. False, leaving the block unchanged, when it is
+// full; the caller then finishes the block and starts a new one.
+bool historyCodecEncodeMinute(HistoryCodecEncoder *encoder, uint16_t count);
+
+// Emits any pending idle run and returns the payload length.
+uint8_t historyCodecEncoderFinish(HistoryCodecEncoder *encoder);
+
+void historyCodecDecoderStart(HistoryCodecDecoder *decoder, uint32_t base,
+                              const uint8_t *data, uint8_t length);
+
+// False at the end of the payload or on a malformed token.
+bool historyCodecDecodeNext(HistoryCodecDecoder *decoder, HistoryCodecSegment *segment);
+
+#endif // HISTORY_CODEC_H
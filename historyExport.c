@@ -0,0 +1,214 @@
+/*
+ * File: historyExport.c
+ * Project: Smart Watch - Final Version
+ * Description: Bulk export of the history log over UART1.
+ *
+ * Frames are built from the log only when the window has room and are
+ * kept, encoded, until acknowledged, so a resend is a copy into the UART
+ * ring. The UART is interrupt driven and this module only ever runs from
+ * the main loop, so an export costs a few record reads per pass and step
+ * counting carries on meanwhile. Frames not yet acknowledged always follow
+ * those that are, and frames not yet queued always follow those that are,
+ * which keeps the line in sequence order.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "System/crc.h"
+#include "uartDriver/uart1_driver.h"
+#include "historyStore.h"
+#include "historyExport.h"
+
+#define FRAME_HEADER_BYTES  6       // sync, type, seq, length
+#define FRAME_MAX_BYTES     (FRAME_HEADER_BYTES + HISTORY_EXPORT_PAYLOAD_MAX + 2)
+#define RECORD_BYTES        6
+
+typedef struct {
+    uint8_t length;
+    bool queued;
+    uint8_t bytes[FRAME_MAX_BYTES];
+} ExportFrame;
+
+static ExportFrame window[HISTORY_EXPORT_WINDOW];
+static HistoryCursor cursor;
+static bool active;
+static bool endBuilt;
+static uint16_t nextSeq;            // of the next frame built
+static uint16_t ackedSeq;           // oldest frame not acknowledged
+static uint32_t lastProgress;
+static uint8_t retries;
+
+static uint8_t received[FRAME_MAX_BYTES];
+static uint8_t receivedCount;
+
+static uint16_t outstanding(void) {
+    return nextSeq - ackedSeq;
+}
+
+static void putLe(uint8_t *out, uint32_t value, uint8_t bytes) {
+    while (bytes--) {
+        *out++ = value & 0xFF;
+        value >>= 8;
+    }
+}
+
+static uint32_t getLe(const uint8_t *in, uint8_t bytes) {
+    uint32_t value = 0;
+    while (bytes--)
+        value = (value << 8) | in[bytes];
+    return value;
+}
+
+static uint16_t frameCrc(const uint8_t *frame, uint8_t payloadLength) {
+    return (uint16_t)CRC_Calculate(&CRC_CONFIG_CCITT16, &frame[2], FRAME_HEADER_BYTES - 2 + payloadLength);
+}
+
+// The payload is already in place after the header
+static void sealFrame(ExportFrame *frame, uint8_t type, uint8_t payloadLength) {
+    uint8_t *bytes = frame->bytes;
+
+    bytes[0] = HISTORY_EXPORT_SYNC0;
+    bytes[1] = HISTORY_EXPORT_SYNC1;
+    bytes[2] = type;
+    putLe(&bytes[3], nextSeq, 2);
+    bytes[5] = payloadLength;
+    putLe(&bytes[FRAME_HEADER_BYTES + payloadLength], frameCrc(bytes, payloadLength), 2);
+    frame->length = FRAME_HEADER_BYTES + payloadLength + 2;
+    frame->queued = false;
+    nextSeq++;
+}
+
+// Fills the next frame with whole records; a data frame that would be
+// empty becomes the end frame
+static void buildFrame(void) {
+    ExportFrame *frame = &window[nextSeq % HISTORY_EXPORT_WINDOW];
+    uint8_t *payload = &frame->bytes[FRAME_HEADER_BYTES];
+    uint8_t length = 4;
+    HistoryCursor before;
+    HistoryRecord record;
+
+    for (;;) {
+        before = cursor;
+        if (!historyCursorNext(&cursor, &record))
+            break;
+        uint8_t blobBytes = 0;
+        if (record.type == HISTORY_RECORD_STEP_BLOCK) {
+            if (record.value > HISTORY_BLOB_MAX_BYTES)
+                continue;
+            blobBytes = record.value;
+        }
+        if (length + RECORD_BYTES + blobBytes > HISTORY_EXPORT_PAYLOAD_MAX) {
+            cursor = before;
+            break;
+        }
+        if (blobBytes > 0 &&
+            !historyCursorReadBlob(&cursor, &record, &payload[length + RECORD_BYTES]))
+            continue;
+        payload[length] = record.type;
+        putLe(&payload[length + 1], record.timestamp, 3);
+        putLe(&payload[length + 4], record.value, 2);
+        length += RECORD_BYTES + blobBytes;
+    }
+
+    putLe(payload, historyCursorPosition(&cursor), 4);
+    if (length == 4) {
+        sealFrame(frame, HISTORY_EXPORT_END, length);
+        endBuilt = true;
+    } else {
+        sealFrame(frame, HISTORY_EXPORT_DATA, length);
+    }
+}
+
+static void resendUnacked(void) {
+    for (uint16_t seq = ackedSeq; seq != nextSeq; seq++)
+        window[seq % HISTORY_EXPORT_WINDOW].queued = false;
+}
+
+static void queueFrames(void) {
+    for (uint16_t seq = ackedSeq; seq != nextSeq; seq++) {
+        ExportFrame *frame = &window[seq % HISTORY_EXPORT_WINDOW];
+        if (frame->queued)
+            continue;
+        if (!uart1_write(frame->bytes, frame->length))
+            return;
+        frame->queued = true;
+    }
+}
+
+static void handleFrame(uint8_t type, uint16_t seq, const uint8_t *payload, uint8_t length, uint32_t now) {
+    if (type == HISTORY_EXPORT_START && length == 4) {
+        historyCursorAtPosition(&cursor, getLe(payload, 4));
+        nextSeq = 0;
+        ackedSeq = 0;
+        endBuilt = false;
+        retries = 0;
+        lastProgress = now;
+        active = true;
+        return;
+    }
+    if (!active || (type != HISTORY_EXPORT_ACK && type != HISTORY_EXPORT_NAK))
+        return;
+    // Anything outside the window is a stale or duplicated ack
+    if ((uint16_t)(seq - ackedSeq) > outstanding())
+        return;
+    if (seq != ackedSeq) {
+        ackedSeq = seq;
+        retries = 0;
+    }
+    lastProgress = now;
+    if (type == HISTORY_EXPORT_NAK)
+        resendUnacked();
+    if (endBuilt && outstanding() == 0)
+        active = false;
+}
+
+static void receiveByte(uint8_t byte, uint32_t now) {
+    if ((receivedCount == 0 && byte != HISTORY_EXPORT_SYNC0) ||
+        (receivedCount == 1 && byte != HISTORY_EXPORT_SYNC1)) {
+        receivedCount = (byte == HISTORY_EXPORT_SYNC0) ? 1 : 0;
+        if (receivedCount == 1)
+            received[0] = byte;
+        return;
+    }
+    received[receivedCount++] = byte;
+    if (receivedCount < FRAME_HEADER_BYTES)
+        return;
+
+    uint8_t length = received[5];
+    if (length > HISTORY_EXPORT_PAYLOAD_MAX) {
+        receivedCount = 0;
+        return;
+    }
+    if (receivedCount < FRAME_HEADER_BYTES + length + 2)
+        return;
+    receivedCount = 0;
+    if (getLe(&received[FRAME_HEADER_BYTES + length], 2) == frameCrc(received, length))
+        handleFrame(received[2], getLe(&received[3], 2), &received[FRAME_HEADER_BYTES], length, now);
+}
+
+void historyExportInit(void) {
+    active = false;
+    receivedCount = 0;
+    uart1_open(HISTORY_EXPORT_BAUD);
+}
+
+void historyExportService(uint32_t now) {
+    uint8_t byte;
+
+    while (uart1_read(&byte))
+        receiveByte(byte, now);
+    if (!active)
+        return;
+
+    if (outstanding() > 0 && now - lastProgress >= HISTORY_EXPORT_RETRY_TICKS) {
+        if (++retries > HISTORY_EXPORT_MAX_RETRIES) {
+            active = false;
+            return;
+        }
+        resendUnacked();
+        lastProgress = now;
+    }
+    while (!endBuilt && outstanding() < HISTORY_EXPORT_WINDOW)
+        buildFrame();
+    queueFrames();
+}
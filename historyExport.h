@@ -0,0 +1,57 @@
+/*
+ * File: historyExport.h
+ * Project: Smart Watch - Final Version
+ * Description: Bulk export of the history log over UART1.
+ *
+ * Every frame, in both directions:
+ *   0xA5 0x5A  type  seq (16-bit LE)  length  payload  CRC16 (LE)
+ * The CRC is CRC-16/CCITT-FALSE over type, seq, length and payload.
+ *
+ * Host to watch:
+ *   'S' start   payload: log position to resume from (32-bit LE), 0 for
+ *               the oldest record; restarts any export in progress
+ *   'A' ack     seq: next frame expected, so every earlier frame is done
+ *   'N' nak     like 'A', and frames from seq on are sent again at once
+ * Watch to host, numbered from 0 for each start:
+ *   'D' data    payload: log position after the last record (32-bit LE),
+ *               then records: type, timestamp (24-bit LE), value (LE),
+ *               followed by value bytes of payload for a step block
+ *   'E' end     payload: log position of the end (32-bit LE)
+ *
+ * Up to HISTORY_EXPORT_WINDOW frames are outstanding; the oldest one is
+ * sent again, with those after it, when no ack has arrived for
+ * HISTORY_EXPORT_RETRY_TICKS. A host that lost the session resumes by
+ * sending 'S' with the position of the last data frame it stored.
+ */
+
+#ifndef HISTORY_EXPORT_H
+#define HISTORY_EXPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timebase.h"
+
+#define HISTORY_EXPORT_BAUD             500000  // BRG 1 at FCY 4 MHz: no divider error,
+                                                // and a standard Linux rate
+#define HISTORY_EXPORT_PAYLOAD_MAX      64
+#define HISTORY_EXPORT_WINDOW           4
+#define HISTORY_EXPORT_RETRY_TICKS      TICKS_FROM_MS(250)
+#define HISTORY_EXPORT_MAX_RETRIES      20      // then the session is dropped
+
+#define HISTORY_EXPORT_SYNC0            0xA5
+#define HISTORY_EXPORT_SYNC1            0x5A
+#define HISTORY_EXPORT_START            'S'
+#define HISTORY_EXPORT_ACK              'A'
+#define HISTORY_EXPORT_NAK              'N'
+#define HISTORY_EXPORT_DATA             'D'
+#define HISTORY_EXPORT_END              'E'
+
+// Opens UART1 and waits for a host. Call once at boot.
+void historyExportInit(void);
+
+// Handles host frames, reads the next records into free window frames and
+// queues frames for transmission. Never blocks; call from the main loop
+// with the current Timer1 tick count.
+void historyExportService(uint32_t now);
+
+#endif // HISTORY_EXPORT_H
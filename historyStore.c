@@ -0,0 +1,548 @@
+/*
+ * File: historyStore.c
+ * Project: Smart Watch - Final Version
+ * Description: Log-structured history in a ring of flash pages.
+ *
+ * Each page starts with a header record carrying a sequence number; the
+ * page with the highest valid sequence is the one being appended to.
+ * Records are four instruction words written as two double-words:
+ *   word0  type[15:12] timestamp[19:16]
+ *   word1  timestamp[15:0]
+ *   word2  value
+ *   word3  CRC-16/CCITT over words 0..2
+ * A blob (HISTORY_RECORD_STEP_BLOCK) is a header record whose value is
+ * the payload length, followed by continuation slots of five bytes each:
+ *   word0  0xE000 | byte0
+ *   word1  byte1 | byte2 << 8
+ *   word2  byte3 | byte4 << 8
+ *   word3  CRC
+ * A blob never spans pages, and cursors skip its continuation slots.
+ * Slots fill in order, so the first free one is found by binary search.
+ * When the active page is full the oldest page is erased and reused.
+ *
+ * Cursors address pages by age (0 = oldest), so they read in log order
+ * without knowing where the ring starts; the sequence they carry tells
+ * how many pages were recycled since and therefore how far to shift.
+ *
+ * A sparse index in RAM holds a key for every block of
+ * HISTORY_INDEX_BLOCK_SLOTS slots, taken from the timestamp of its first
+ * record. It is rebuilt at boot from one record per block and kept current
+ * by appends. Timestamps are not monotonic over the log: they wrap at the
+ * New Year and go back when the clock is set back or reset to its default.
+ * The index is therefore split into runs wherever a block starts more than
+ * HISTORY_RUN_SLACK minutes before the latest start of its run (less than
+ * that is normal: daily totals are logged after the day they stamp). The
+ * key is the run number above the run's latest start so far, which never
+ * decreases along the log. A seek binary-searches each run, newest first,
+ * and then reads at most about one block.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "System/flash.h"
+#include "System/crc.h"
+#include "historyStore.h"
+
+#define HISTORY_PAGE_COUNT          8
+#define HISTORY_WORDS_PER_RECORD    4
+#define HISTORY_SLOTS_PER_PAGE      (FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS / HISTORY_WORDS_PER_RECORD)
+#define HISTORY_RECORD_PC_UNITS     (HISTORY_WORDS_PER_RECORD * 2)
+#define HISTORY_TYPE_PAGE_HEADER    0xF
+#define HISTORY_TYPE_CONTINUATION   0xE
+#define HISTORY_CONTINUATION_BYTES  5
+#define HISTORY_INDEX_BLOCK_SLOTS   32
+#define HISTORY_INDEX_BLOCKS        ((HISTORY_SLOTS_PER_PAGE - 1 + HISTORY_INDEX_BLOCK_SLOTS - 1) / HISTORY_INDEX_BLOCK_SLOTS)
+#define HISTORY_INDEX_EMPTY         0xFFFFFFFFUL
+#define HISTORY_TIMESTAMP_BITS      20
+#define HISTORY_TIMESTAMP_MASK      ((1UL << HISTORY_TIMESTAMP_BITS) - 1)
+#define HISTORY_RUN_LIMIT           0xFFEUL     // keeps keys below HISTORY_INDEX_EMPTY
+#define HISTORY_RUN_SLACK           (2 * 24 * 60UL)
+
+static const uint16_t historyPages[HISTORY_PAGE_COUNT * FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS]
+    __attribute__((space(prog), aligned(FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS), noload));
+
+static const uint16_t DAYS_BEFORE_MONTH[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+static uint32_t baseAddress;
+static uint8_t activePage;
+static uint16_t nextSlot;
+static uint32_t activeSequence;
+static uint32_t blockIndex[HISTORY_PAGE_COUNT][HISTORY_INDEX_BLOCKS];   // key per block
+static uint32_t lastKey;            // of the newest indexed block
+
+static uint32_t slotAddress(uint8_t page, uint16_t slot) {
+    return baseAddress + (uint32_t)page * FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS
+                       + (uint32_t)slot * HISTORY_RECORD_PC_UNITS;
+}
+
+static uint16_t recordCrc(const uint16_t *words) {
+    uint8_t bytes[6];
+    for (uint8_t i = 0; i < 3; i++) {
+        bytes[2 * i] = words[i] & 0xFF;
+        bytes[2 * i + 1] = words[i] >> 8;
+    }
+    return (uint16_t)CRC_Calculate(&CRC_CONFIG_CCITT16, bytes, sizeof(bytes));
+}
+
+// Fills in the CRC (words[3]) and programs the slot
+static bool writeWords(uint8_t page, uint16_t slot, uint16_t *words) {
+    uint32_t address = slotAddress(page, slot);
+
+    words[3] = recordCrc(words);
+    return FLASH_WriteDoubleWord16(address, words[0], words[1]) &&
+           FLASH_WriteDoubleWord16(address + 4, words[2], words[3]);
+}
+
+static void packRecord(uint16_t *words, uint8_t type, uint32_t timestamp, uint16_t value) {
+    words[0] = ((uint16_t)type << 12) | ((timestamp >> 16) & 0x000F);
+    words[1] = timestamp & 0xFFFF;
+    words[2] = value;
+}
+
+static bool writeSlot(uint8_t page, uint16_t slot, uint8_t type, uint32_t timestamp, uint16_t value) {
+    uint16_t words[HISTORY_WORDS_PER_RECORD];
+    packRecord(words, type, timestamp, value);
+    return writeWords(page, slot, words);
+}
+
+// False for erased slots and slots failing their CRC
+static bool readWords(uint8_t page, uint16_t slot, uint16_t *words) {
+    uint32_t address = slotAddress(page, slot);
+
+    for (uint8_t i = 0; i < HISTORY_WORDS_PER_RECORD; i++)
+        words[i] = FLASH_ReadWord16(address + i * 2);
+    return words[0] != FLASH_ERASED_WORD16 && words[3] == recordCrc(words);
+}
+
+static bool readSlot(uint8_t page, uint16_t slot, HistoryRecord *record) {
+    uint16_t words[HISTORY_WORDS_PER_RECORD];
+
+    if (!readWords(page, slot, words))
+        return false;
+
+    record->type = words[0] >> 12;
+    record->timestamp = ((uint32_t)(words[0] & 0x000F) << 16) | words[1];
+    record->value = words[2];
+    return true;
+}
+
+static bool readPageSequence(uint8_t page, uint32_t *sequence) {
+    HistoryRecord header;
+    if (!readSlot(page, 0, &header) || header.type != HISTORY_TYPE_PAGE_HEADER)
+        return false;
+    *sequence = ((uint32_t)header.value << 16) | (header.timestamp & 0xFFFF);
+    return true;
+}
+
+static uint16_t findFirstFreeSlot(uint8_t page) {
+    uint16_t low = 1, high = HISTORY_SLOTS_PER_PAGE;
+    while (low < high) {
+        uint16_t mid = (low + high) / 2;
+        if (FLASH_ReadWord16(slotAddress(page, mid)) == FLASH_ERASED_WORD16)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+}
+
+// Erases the page after the active one (the oldest) and makes it active
+static void startNewPage(void) {
+    uint8_t page = (activePage + 1) % HISTORY_PAGE_COUNT;
+
+    FLASH_ErasePage(slotAddress(page, 0));
+    for (uint8_t block = 0; block < HISTORY_INDEX_BLOCKS; block++)
+        blockIndex[page][block] = HISTORY_INDEX_EMPTY;
+    activeSequence++;
+    writeSlot(page, 0, HISTORY_TYPE_PAGE_HEADER, activeSequence & 0xFFFF, activeSequence >> 16);
+    activePage = page;
+    nextSlot = 1;
+}
+
+static uint8_t pageAtAge(uint8_t age) {
+    return (activePage + 1 + age) % HISTORY_PAGE_COUNT;
+}
+
+static uint16_t pageEnd(uint8_t page) {
+    return (page == activePage) ? nextSlot : HISTORY_SLOTS_PER_PAGE;
+}
+
+static bool pageInUse(uint8_t page) {
+    uint32_t sequence;
+    return readPageSequence(page, &sequence);
+}
+
+// Shifts the cursor by the number of pages recycled since it was set
+static void followRecycledPages(HistoryCursor *cursor) {
+    uint32_t recycled = activeSequence - cursor->sequence;
+    if (recycled == 0)
+        return;
+    if (recycled > cursor->age) {
+        cursor->age = 0;
+        cursor->slot = 0;
+    } else {
+        cursor->age -= recycled;
+    }
+    cursor->sequence = activeSequence;
+}
+
+static uint16_t firstSlotOfBlock(uint8_t block) {
+    return 1 + (uint16_t)block * HISTORY_INDEX_BLOCK_SLOTS;
+}
+
+// Blocks holding records, counted in log order from the oldest page
+static uint16_t indexedBlocks(void) {
+    uint16_t blocks = (HISTORY_PAGE_COUNT - 1) * HISTORY_INDEX_BLOCKS;
+    if (nextSlot > 1)
+        blocks += (nextSlot - 2) / HISTORY_INDEX_BLOCK_SLOTS + 1;
+    return blocks;
+}
+
+static uint32_t indexAt(uint16_t position) {
+    return blockIndex[pageAtAge(position / HISTORY_INDEX_BLOCKS)][position % HISTORY_INDEX_BLOCKS];
+}
+
+static uint32_t indexKey(uint32_t run, uint32_t timestamp) {
+    return (run << HISTORY_TIMESTAMP_BITS) | (timestamp & HISTORY_TIMESTAMP_MASK);
+}
+
+static uint32_t keyRun(uint32_t key) {
+    return key >> HISTORY_TIMESTAMP_BITS;
+}
+
+// Key of a block starting at timestamp after a block keyed previous
+static uint32_t nextKey(uint32_t previous, uint32_t timestamp) {
+    uint32_t latest;
+
+    if (previous == HISTORY_INDEX_EMPTY)
+        return indexKey(0, timestamp);
+    latest = previous & HISTORY_TIMESTAMP_MASK;
+    if (timestamp + HISTORY_RUN_SLACK < latest)
+        return indexKey(keyRun(previous) + 1, timestamp);
+    return (timestamp > latest) ? indexKey(keyRun(previous), timestamp) : previous;
+}
+
+// Renumbers the runs from 0 before the run number outgrows its bits
+static void rebaseRuns(void) {
+    uint32_t oldest = HISTORY_INDEX_EMPTY;
+
+    for (uint16_t position = 0; position < indexedBlocks() && oldest == HISTORY_INDEX_EMPTY; position++)
+        oldest = indexAt(position);
+    if (oldest == HISTORY_INDEX_EMPTY)
+        return;
+    for (uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+        for (uint8_t block = 0; block < HISTORY_INDEX_BLOCKS; block++) {
+            if (blockIndex[page][block] != HISTORY_INDEX_EMPTY)
+                blockIndex[page][block] -= oldest & ~HISTORY_TIMESTAMP_MASK;
+        }
+    }
+    lastKey -= oldest & ~HISTORY_TIMESTAMP_MASK;
+}
+
+// One record per block. Blocks with no readable record, and pages whose
+// header is lost, inherit the previous key so the index stays sorted.
+static void rebuildIndex(void) {
+    HistoryRecord record;
+
+    lastKey = HISTORY_INDEX_EMPTY;
+    for (uint8_t age = 0; age < HISTORY_PAGE_COUNT; age++) {
+        uint8_t page = pageAtAge(age);
+        bool inUse = pageInUse(page);
+        uint16_t end = pageEnd(page);
+
+        for (uint8_t block = 0; block < HISTORY_INDEX_BLOCKS; block++) {
+            uint16_t slot = firstSlotOfBlock(block);
+            uint16_t blockEnd = slot + HISTORY_INDEX_BLOCK_SLOTS;
+            uint32_t key = lastKey;
+
+            if (inUse && slot >= end) {
+                key = HISTORY_INDEX_EMPTY;      // not written yet
+            } else if (inUse) {
+                for (; slot < end && slot < blockEnd; slot++) {
+                    if (readSlot(page, slot, &record) && record.type != HISTORY_TYPE_CONTINUATION) {
+                        key = nextKey(lastKey, record.timestamp);
+                        break;
+                    }
+                }
+            }
+            blockIndex[page][block] = key;
+            if (key != HISTORY_INDEX_EMPTY)
+                lastKey = key;
+        }
+    }
+}
+
+void historyStoreInit(void) {
+    bool found = false;
+    uint32_t sequence;
+
+    baseAddress = __builtin_tbladdress(historyPages);
+
+    for (uint8_t page = 0; page < HISTORY_PAGE_COUNT; page++) {
+        if (readPageSequence(page, &sequence) && (!found || sequence > activeSequence)) {
+            activeSequence = sequence;
+            activePage = page;
+            found = true;
+        }
+    }
+
+    if (!found) {
+        activeSequence = 0;
+        activePage = HISTORY_PAGE_COUNT - 1;
+        startNewPage();
+    } else {
+        nextSlot = findFirstFreeSlot(activePage);
+    }
+    rebuildIndex();
+}
+
+// Writes the next slot of the active page. timestamp is the record's, or
+// for a continuation its blob's, which is a valid lower bound for the index.
+static bool appendWords(uint16_t *words, uint32_t timestamp) {
+    if ((nextSlot - 1) % HISTORY_INDEX_BLOCK_SLOTS == 0) {
+        lastKey = nextKey(lastKey, timestamp);
+        blockIndex[activePage][(nextSlot - 1) / HISTORY_INDEX_BLOCK_SLOTS] = lastKey;
+        if (keyRun(lastKey) >= HISTORY_RUN_LIMIT)
+            rebaseRuns();
+    }
+    // A failed write still consumes the slot: ECC forbids programming it again
+    return writeWords(activePage, nextSlot++, words);
+}
+
+bool historyStoreAppend(const HistoryRecord *record) {
+    uint16_t words[HISTORY_WORDS_PER_RECORD];
+
+    if (nextSlot >= HISTORY_SLOTS_PER_PAGE)
+        startNewPage();
+    packRecord(words, record->type, record->timestamp, record->value);
+    return appendWords(words, record->timestamp);
+}
+
+bool historyStoreAppendBlob(const HistoryRecord *header, const uint8_t *data) {
+    uint16_t words[HISTORY_WORDS_PER_RECORD];
+    uint8_t length = header->value;
+    uint16_t slots = 1 + (length + HISTORY_CONTINUATION_BYTES - 1) / HISTORY_CONTINUATION_BYTES;
+    bool ok;
+
+    if (length > HISTORY_BLOB_MAX_BYTES)
+        return false;
+    if (nextSlot + slots > HISTORY_SLOTS_PER_PAGE)
+        startNewPage();
+
+    packRecord(words, header->type, header->timestamp, length);
+    ok = appendWords(words, header->timestamp);
+    for (uint8_t offset = 0; offset < length; offset += HISTORY_CONTINUATION_BYTES) {
+        uint8_t chunk[HISTORY_CONTINUATION_BYTES] = {0};
+        for (uint8_t i = 0; i < HISTORY_CONTINUATION_BYTES && offset + i < length; i++)
+            chunk[i] = data[offset + i];
+        words[0] = ((uint16_t)HISTORY_TYPE_CONTINUATION << 12) | chunk[0];
+        words[1] = chunk[1] | ((uint16_t)chunk[2] << 8);
+        words[2] = chunk[3] | ((uint16_t)chunk[4] << 8);
+        ok = appendWords(words, header->timestamp) && ok;
+    }
+    return ok;
+}
+
+void historyCursorOldest(HistoryCursor *cursor) {
+    cursor->age = 0;
+    cursor->slot = 0;
+    cursor->sequence = activeSequence;
+}
+
+// First position in [low, high) whose key is at least key. Unused pages
+// at the start of the ring are empty and sort first.
+static uint16_t lowerBound(uint16_t low, uint16_t high, uint32_t key) {
+    while (low < high) {
+        uint16_t mid = (low + high) / 2;
+        uint32_t found = indexAt(mid);
+        if (found == HISTORY_INDEX_EMPTY || found < key)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+// Reads on from the cursor to the first record of a run not older than
+// timestamp, leaving the cursor on it. With entering set the cursor starts
+// in the last block of the run before, and the run begins at the first
+// regression; if that record is already past the timestamp, the run does
+// not cover it. False then, and when the run ends first.
+static bool seekWithin(HistoryCursor *cursor, uint32_t latest, bool entering, uint32_t timestamp) {
+    HistoryRecord record;
+    HistoryCursor before;
+
+    for (;;) {
+        before = *cursor;
+        if (!historyCursorNext(cursor, &record))
+            return false;
+        if (record.timestamp + HISTORY_RUN_SLACK < latest) {
+            if (!entering || record.timestamp > timestamp)
+                return false;
+            entering = false;
+            latest = record.timestamp;
+        } else if (record.timestamp > latest) {
+            latest = record.timestamp;
+        }
+        if (!entering && record.timestamp >= timestamp) {
+            *cursor = before;
+            return true;
+        }
+    }
+}
+
+// The newest run covering the timestamp wins: after the clock went back,
+// that is the one the wearer last lived through.
+void historyCursorSeek(HistoryCursor *cursor, uint32_t timestamp) {
+    uint16_t runEnd = indexedBlocks();
+
+    while (runEnd > 0 && indexAt(runEnd - 1) != HISTORY_INDEX_EMPTY) {
+        uint32_t run = keyRun(indexAt(runEnd - 1));
+        uint16_t runStart = lowerBound(0, runEnd, indexKey(run, 0));
+        uint16_t position = lowerBound(runStart, runEnd, indexKey(run, timestamp));
+        bool entering = false;
+        uint32_t latest = 0;
+
+        // Records from the timestamp on can begin in the block before that
+        // one, and a run's first records in the last block of the run
+        // before. Blocks that only inherited a key hold none, so go back to
+        // the block the key was read from.
+        if (position > runStart || (runStart > 0 && indexAt(runStart - 1) != HISTORY_INDEX_EMPTY)) {
+            entering = (position == runStart);
+            if (entering)
+                latest = indexAt(position - 1) & HISTORY_TIMESTAMP_MASK;
+            position = lowerBound(entering ? 0 : runStart, position, indexAt(position - 1));
+        }
+        historyCursorOldest(cursor);
+        cursor->age = position / HISTORY_INDEX_BLOCKS;
+        cursor->slot = firstSlotOfBlock(position % HISTORY_INDEX_BLOCKS);
+        if (seekWithin(cursor, latest, entering, timestamp))
+            return;
+        runEnd = runStart;
+    }
+    // Nothing that recent: the end of the log
+    historyCursorOldest(cursor);
+    cursor->age = HISTORY_PAGE_COUNT - 1;
+    cursor->slot = nextSlot;
+}
+
+// Timestamp of the first record of the run whose first block is at
+// position. After a regression that record can sit in the block before;
+// reading on from there stops at the regression, in that block or at the
+// start of the one at position.
+static uint32_t runFirstTimestamp(uint16_t position) {
+    HistoryCursor cursor;
+    HistoryRecord record;
+    uint32_t latest;
+    uint16_t from;
+
+    if (position == 0 || indexAt(position - 1) == HISTORY_INDEX_EMPTY)
+        return indexAt(position) & HISTORY_TIMESTAMP_MASK;
+    latest = indexAt(position - 1) & HISTORY_TIMESTAMP_MASK;
+    from = lowerBound(0, position, indexAt(position - 1));
+    historyCursorOldest(&cursor);
+    cursor.age = from / HISTORY_INDEX_BLOCKS;
+    cursor.slot = firstSlotOfBlock(from % HISTORY_INDEX_BLOCKS);
+    while (historyCursorNext(&cursor, &record)) {
+        if (record.timestamp + HISTORY_RUN_SLACK < latest)
+            return record.timestamp;
+        if (record.timestamp > latest)
+            latest = record.timestamp;
+    }
+    return indexAt(position) & HISTORY_TIMESTAMP_MASK;
+}
+
+bool historyOldestRunStart(uint32_t notAfter, uint32_t *timestamp) {
+    uint32_t previous = HISTORY_INDEX_EMPTY;
+
+    for (uint16_t position = 0; position < indexedBlocks(); position++) {
+        uint32_t key = indexAt(position);
+        if (key == HISTORY_INDEX_EMPTY)
+            continue;
+        if (previous == HISTORY_INDEX_EMPTY || keyRun(key) != keyRun(previous)) {
+            uint32_t first = runFirstTimestamp(position);
+            if (first <= notAfter) {
+                *timestamp = first;
+                return true;
+            }
+        }
+        previous = key;
+    }
+    return false;
+}
+
+bool historyCursorNext(HistoryCursor *cursor, HistoryRecord *record) {
+    followRecycledPages(cursor);
+    while (cursor->age < HISTORY_PAGE_COUNT) {
+        uint8_t page = pageAtAge(cursor->age);
+        if (cursor->slot == 0)
+            cursor->slot = pageInUse(page) ? 1 : HISTORY_SLOTS_PER_PAGE;
+        while (cursor->slot < pageEnd(page)) {
+            if (readSlot(page, cursor->slot++, record) && record->type != HISTORY_TYPE_CONTINUATION)
+                return true;
+        }
+        if (page == activePage)
+            return false;   // stay at the end so later appends are picked up
+        cursor->age++;
+        cursor->slot = 0;
+    }
+    return false;
+}
+
+// In slots. Pages are numbered by sequence + HISTORY_PAGE_COUNT - 1, so the
+// page at age a is activeSequence + a and no number goes negative while
+// the ring is still filling.
+uint32_t historyCursorPosition(HistoryCursor *cursor) {
+    followRecycledPages(cursor);
+    return (activeSequence + cursor->age) * HISTORY_SLOTS_PER_PAGE + cursor->slot;
+}
+
+void historyCursorAtPosition(HistoryCursor *cursor, uint32_t position) {
+    uint32_t page = position / HISTORY_SLOTS_PER_PAGE;
+
+    historyCursorOldest(cursor);
+    if (page >= activeSequence + HISTORY_PAGE_COUNT) {
+        cursor->age = HISTORY_PAGE_COUNT - 1;
+        cursor->slot = nextSlot;
+    } else if (page >= activeSequence) {
+        cursor->age = page - activeSequence;
+        cursor->slot = position % HISTORY_SLOTS_PER_PAGE;
+    }
+}
+
+bool historyCursorReadBlob(HistoryCursor *cursor, const HistoryRecord *header, uint8_t *data) {
+    uint16_t words[HISTORY_WORDS_PER_RECORD];
+    uint8_t length = header->value;
+
+    followRecycledPages(cursor);
+    if (length > HISTORY_BLOB_MAX_BYTES || cursor->age >= HISTORY_PAGE_COUNT)
+        return false;
+    for (uint8_t offset = 0; offset < length; offset += HISTORY_CONTINUATION_BYTES) {
+        uint8_t page = pageAtAge(cursor->age);
+        if (cursor->slot >= pageEnd(page) || !readWords(page, cursor->slot, words) ||
+            (words[0] >> 12) != HISTORY_TYPE_CONTINUATION)
+            return false;
+        cursor->slot++;
+        uint8_t chunk[HISTORY_CONTINUATION_BYTES] = {
+            words[0] & 0xFF, words[1] & 0xFF, words[1] >> 8, words[2] & 0xFF, words[2] >> 8
+        };
+        for (uint8_t i = 0; i < HISTORY_CONTINUATION_BYTES && offset + i < length; i++)
+            data[offset + i] = chunk[i];
+    }
+    return true;
+}
+
+uint32_t historyTimestamp(uint8_t month, uint8_t day, uint8_t hours, uint8_t minutes) {
+    uint32_t days = DAYS_BEFORE_MONTH[month - 1] + (day - 1);
+    return (days * 24 + hours) * 60 + minutes;
+}
+
+void historyDate(uint32_t timestamp, uint8_t *month, uint8_t *day) {
+    uint16_t dayOfYear = timestamp / (24 * 60);
+    uint8_t m = 12;
+    while (m > 1 && DAYS_BEFORE_MONTH[m - 1] > dayOfYear)
+        m--;
+    *month = m;
+    *day = dayOfYear - DAYS_BEFORE_MONTH[m - 1] + 1;
+}
@@ -0,0 +1,92 @@
+/*
+ * File: historyStore.h
+ * Project: Smart Watch - Final Version
+ * Description: Persistent, log-structured history of timestamped records in
+ *              a ring of reserved flash pages.
+ */
+
+#ifndef HISTORY_STORE_H
+#define HISTORY_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Record types (4 bits, 0x0, 0xE and 0xF are reserved)
+typedef enum {
+    HISTORY_RECORD_STEPS = 1,       // value: steps in the minute (older logs)
+    HISTORY_RECORD_SLEEP = 2,       // value: activity count, bit 15 = asleep
+    HISTORY_RECORD_ACTIVITY = 3,    // value: ActivityClass, logged on change
+    HISTORY_RECORD_DISTANCE = 4,    // value: daily distance in 10 m units
+    HISTORY_RECORD_ENERGY = 5,      // value: daily active energy in kcal
+    HISTORY_RECORD_FALL = 6,        // value: peak impact in mg
+    HISTORY_RECORD_STEP_BLOCK = 7   // blob: minute count, then historyCodec payload;
+                                    // timestamp: the minute after the block
+} HistoryRecordType;
+
+#define HISTORY_SLEEP_ASLEEP_FLAG   0x8000
+#define HISTORY_BLOB_MAX_BYTES      45      // nine continuation slots
+
+// Timestamps are minutes since January 1st, 00:00 (the clock has no year)
+typedef struct {
+    uint8_t type;
+    uint32_t timestamp;
+    uint16_t value;
+} HistoryRecord;
+
+// Read position in the log. Cursors survive appends, including the erase
+// of the oldest page (records on it are then skipped).
+typedef struct {
+    uint8_t age;            // pages after the oldest one
+    uint16_t slot;          // 0: page not entered yet
+    uint32_t sequence;      // active page sequence the age refers to
+} HistoryCursor;
+
+// Finds the newest page and its first free slot and rebuilds the time
+// index from one record per block. Call once at boot.
+void historyStoreInit(void);
+
+// Appends one record. Occasionally erases the oldest page first, which
+// stalls the CPU for a few milliseconds, so call from the main loop only.
+bool historyStoreAppend(const HistoryRecord *record);
+
+// Positions the cursor on the oldest record.
+void historyCursorOldest(HistoryCursor *cursor);
+
+// Positions the cursor on the first record not older than timestamp, in
+// the newest stretch of the log whose clock passed through it (the clock
+// has no year and can be set back), or at the end of the log if none did. The
+// block is found in the RAM index; only records of that block are read.
+void historyCursorSeek(HistoryCursor *cursor, uint32_t timestamp);
+
+// First timestamp of the oldest stretch of the log (as historyCursorSeek
+// splits it) that began no later than notAfter; false if none did. Runs
+// are found in the RAM index; at most about one block is read per run
+// that began later.
+bool historyOldestRunStart(uint32_t notAfter, uint32_t *timestamp);
+
+// Reads the record under the cursor and advances past it; false at the end
+// of the log. Records failing their CRC are skipped.
+bool historyCursorNext(HistoryCursor *cursor, HistoryRecord *record);
+
+// Position of the cursor in the log as a whole. Unlike the cursor itself
+// it stays meaningful across reboots, so it can be handed out as a resume
+// point.
+uint32_t historyCursorPosition(HistoryCursor *cursor);
+
+// Places the cursor at a historyCursorPosition value. A position on a page
+// recycled since moves it to the oldest record, one past the end of the
+// log to the end.
+void historyCursorAtPosition(HistoryCursor *cursor, uint32_t position);
+
+// Appends a record followed by a payload of header->value bytes. The blob
+// is kept on one page; the rest of a page too short for it is left empty.
+bool historyStoreAppendBlob(const HistoryRecord *header, const uint8_t *data);
+
+// Reads the payload of the blob whose header the cursor has just returned
+// (header->value bytes) and moves past it. False if any part is damaged.
+bool historyCursorReadBlob(HistoryCursor *cursor, const HistoryRecord *header, uint8_t *data);
+
+uint32_t historyTimestamp(uint8_t month, uint8_t day, uint8_t hours, uint8_t minutes);
+void historyDate(uint32_t timestamp, uint8_t *month, uint8_t *day);
+
+#endif // HISTORY_STORE_H
@@ -0,0 +1,229 @@
+/*
+ * File: i2cScheduler.c
+ * Project: Smart Watch - Final Version
+ * Description: Priority and deadline scheduling of I2C1 transfers.
+ *
+ * Each pass picks the most urgent candidate: the highest-priority due
+ * job (ties go to the longest overdue) unless a queued one-off has a
+ * strictly higher priority. Before starting it, the pass checks that the
+ * transfer ends before any job of higher priority falls due; if not, the
+ * bus is left free for that job and the pass ends. A late job keeps its
+ * phase while less than a period behind and is re-phased after that, so a
+ * long stall costs one read rather than a burst of catch-up reads.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "Accel_i2c.h"
+#include "i2cScheduler.h"
+
+#define I2C_BYTE_US             90      // 9 clocks at 100 kHz
+#define I2C_CONDITION_US        30      // start, restart or stop
+
+typedef struct {
+    bool active;
+    uint8_t address;
+    uint8_t reg;
+    uint8_t length;
+    I2cPriority priority;
+    uint32_t period;
+    uint32_t nextDue;
+    uint8_t head;
+    uint8_t tail;
+    I2cSample ring[I2C_SCHEDULER_RING_DEPTH];
+    I2cJobStats stats;
+} I2cJob;
+
+static I2cJob jobs[I2C_SCHEDULER_MAX_JOBS];
+static I2cRequest *requests[I2C_SCHEDULER_MAX_REQUESTS];
+static uint8_t requestCount;
+
+static uint16_t transferUs(uint8_t length, bool write) {
+    if (write)  // one register per transfer: address, register, data
+        return length * (3 * I2C_BYTE_US + 2 * I2C_CONDITION_US);
+    // address, register, restart, address, data
+    return (3 + length) * I2C_BYTE_US + 3 * I2C_CONDITION_US;
+}
+
+static uint32_t usToTicks(uint16_t us) {
+    return (us + I2C_SCHEDULER_TICK_US - 1) / I2C_SCHEDULER_TICK_US;
+}
+
+static I2cJob *jobFromId(I2cJobId job) {
+    if (job < 0 || job >= I2C_SCHEDULER_MAX_JOBS || !jobs[job].active)
+        return NULL;
+    return &jobs[job];
+}
+
+static I2cJob *nextDueJob(uint32_t now) {
+    I2cJob *best = NULL;
+
+    for (uint8_t i = 0; i < I2C_SCHEDULER_MAX_JOBS; i++) {
+        I2cJob *job = &jobs[i];
+        if (!job->active || (int32_t)(now - job->nextDue) < 0)
+            continue;
+        if (best == NULL || job->priority < best->priority ||
+            (job->priority == best->priority && (int32_t)(job->nextDue - best->nextDue) < 0))
+            best = job;
+    }
+    return best;
+}
+
+// First queued request of the highest priority, -1 when the queue is empty
+static int8_t nextRequest(void) {
+    int8_t best = -1;
+
+    for (uint8_t i = 0; i < requestCount; i++) {
+        if (best < 0 || requests[i]->priority < requests[best]->priority)
+            best = i;
+    }
+    return best;
+}
+
+static void removeRequest(uint8_t index) {
+    requestCount--;
+    for (uint8_t i = index; i < requestCount; i++)
+        requests[i] = requests[i + 1];
+}
+
+// Ticks until a job more urgent than priority falls due
+static uint32_t slackBefore(I2cPriority priority, uint32_t now) {
+    uint32_t slack = UINT32_MAX;
+
+    for (uint8_t i = 0; i < I2C_SCHEDULER_MAX_JOBS; i++) {
+        const I2cJob *job = &jobs[i];
+        if (!job->active || job->priority >= priority)
+            continue;
+        int32_t until = (int32_t)(job->nextDue - now);
+        if (until <= 0)
+            return 0;
+        if ((uint32_t)until < slack)
+            slack = until;
+    }
+    return slack;
+}
+
+static void runJob(I2cJob *job, uint32_t now) {
+    uint8_t data[I2C_SCHEDULER_MAX_LENGTH];
+    I2cSample *slot;
+
+    if (now - job->nextDue >= job->period) {
+        job->stats.late++;
+        job->nextDue = now + job->period;
+    } else {
+        job->nextDue += job->period;
+    }
+
+    if (i2cReadSlaveRegisters(job->address, job->reg, data, job->length) != OK) {
+        job->stats.failed++;
+        return;
+    }
+    if ((uint8_t)(job->head - job->tail) == I2C_SCHEDULER_RING_DEPTH) {
+        job->tail++;
+        job->stats.dropped++;
+    }
+    slot = &job->ring[job->head & (I2C_SCHEDULER_RING_DEPTH - 1)];
+    slot->ticks = now;
+    memcpy(slot->data, data, job->length);
+    job->head++;
+    job->stats.completed++;
+}
+
+static void runRequest(I2cRequest *request) {
+    bool ok;
+
+    if (request->write) {
+        ok = true;
+        for (uint8_t i = 0; ok && i < request->length; i++)
+            ok = (i2cWriteSlave(request->address, request->reg + i, request->data[i]) == OK);
+    } else {
+        ok = (i2cReadSlaveRegisters(request->address, request->reg, request->data, request->length) == OK);
+    }
+    request->state = ok ? I2C_REQUEST_DONE : I2C_REQUEST_FAILED;
+}
+
+void i2cSchedulerInit(void) {
+    memset(jobs, 0, sizeof(jobs));
+    requestCount = 0;
+}
+
+I2cJobId i2cSchedulerAddPeriodic(uint8_t address, uint8_t reg, uint8_t length,
+                                 uint32_t periodTicks, uint32_t firstDue, I2cPriority priority) {
+    if (length == 0 || length > I2C_SCHEDULER_MAX_LENGTH || periodTicks == 0)
+        return -1;
+
+    for (uint8_t i = 0; i < I2C_SCHEDULER_MAX_JOBS; i++) {
+        I2cJob *job = &jobs[i];
+        if (job->active)
+            continue;
+        memset(job, 0, sizeof(*job));
+        job->address = address;
+        job->reg = reg;
+        job->length = length;
+        job->priority = priority;
+        job->period = periodTicks;
+        job->nextDue = firstDue;
+        job->active = true;
+        return (I2cJobId)i;
+    }
+    return -1;
+}
+
+void i2cSchedulerRemove(I2cJobId job) {
+    I2cJob *entry = jobFromId(job);
+    if (entry != NULL)
+        entry->active = false;
+}
+
+bool i2cSchedulerTakeSample(I2cJobId job, I2cSample *sample) {
+    I2cJob *entry = jobFromId(job);
+    if (entry == NULL || entry->head == entry->tail)
+        return false;
+    *sample = entry->ring[entry->tail & (I2C_SCHEDULER_RING_DEPTH - 1)];
+    entry->tail++;
+    return true;
+}
+
+const I2cJobStats *i2cSchedulerStats(I2cJobId job) {
+    I2cJob *entry = jobFromId(job);
+    return (entry != NULL) ? &entry->stats : NULL;
+}
+
+bool i2cSchedulerSubmit(I2cRequest *request) {
+    if (requestCount >= I2C_SCHEDULER_MAX_REQUESTS || request->state == I2C_REQUEST_QUEUED ||
+        request->length == 0)
+        return false;
+    request->state = I2C_REQUEST_QUEUED;
+    requests[requestCount++] = request;
+    return true;
+}
+
+void i2cSchedulerService(uint32_t now) {
+    uint16_t spentUs = 0;
+
+    while (spentUs < I2C_SCHEDULER_BUDGET_US) {
+        I2cJob *job = nextDueJob(now);
+        int8_t index = nextRequest();
+        I2cRequest *request = (index >= 0) ? requests[index] : NULL;
+        uint16_t cost;
+
+        if (request != NULL && (job == NULL || request->priority < job->priority)) {
+            cost = transferUs(request->length, request->write);
+            if (slackBefore(request->priority, now) < usToTicks(cost))
+                break;
+            removeRequest(index);
+            runRequest(request);
+        } else if (job != NULL) {
+            cost = transferUs(job->length, false);
+            if (slackBefore(job->priority, now) < usToTicks(cost))
+                break;
+            runJob(job, now);
+        } else {
+            break;
+        }
+        spentUs += cost;
+        now += usToTicks(cost);
+    }
+}
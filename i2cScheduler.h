@@ -0,0 +1,83 @@
+/*
+ * File: i2cScheduler.h
+ * Project: Smart Watch - Final Version
+ * Description: Shares I2C1 between devices. Devices register periodic
+ *              register reads and submit one-off transfers; the main loop
+ *              runs the scheduler, which places them on the bus by
+ *              priority and deadline and publishes each periodic read into
+ *              that job's sample ring.
+ *
+ * Transfers are the blocking ones from Accel_i2c, so all time accounting
+ * is an estimate from the byte count at 100 kHz. Times are Timer1 ticks.
+ */
+
+#ifndef I2C_SCHEDULER_H
+#define I2C_SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_SCHEDULER_MAX_JOBS      4
+#define I2C_SCHEDULER_MAX_REQUESTS  4
+#define I2C_SCHEDULER_MAX_LENGTH    6
+#define I2C_SCHEDULER_RING_DEPTH    4       // power of two
+#define I2C_SCHEDULER_TICK_US       64      // Timer1 at FCY / 256
+#define I2C_SCHEDULER_BUDGET_US     2000    // bus time per service call
+
+typedef enum {
+    I2C_PRIORITY_HIGH,
+    I2C_PRIORITY_NORMAL,
+    I2C_PRIORITY_LOW
+} I2cPriority;
+
+typedef int8_t I2cJobId;                    // negative when registration failed
+
+typedef struct {
+    uint32_t ticks;                         // when the read completed
+    uint8_t data[I2C_SCHEDULER_MAX_LENGTH];
+} I2cSample;
+
+typedef struct {
+    uint16_t completed;
+    uint16_t failed;
+    uint16_t late;                          // started more than a period late
+    uint16_t dropped;                       // ring overwritten before being read
+} I2cJobStats;
+
+typedef enum {
+    I2C_REQUEST_IDLE,
+    I2C_REQUEST_QUEUED,
+    I2C_REQUEST_DONE,
+    I2C_REQUEST_FAILED
+} I2cRequestState;
+
+// One-off transfer. The caller owns the structure and the data buffer
+// until state leaves I2C_REQUEST_QUEUED.
+typedef struct {
+    uint8_t address;                        // 8-bit write address
+    uint8_t reg;
+    uint8_t length;
+    bool write;
+    uint8_t *data;
+    I2cPriority priority;
+    volatile I2cRequestState state;
+} I2cRequest;
+
+void i2cSchedulerInit(void);
+
+// Reads length bytes from reg every periodTicks, first at firstDue.
+I2cJobId i2cSchedulerAddPeriodic(uint8_t address, uint8_t reg, uint8_t length,
+                                 uint32_t periodTicks, uint32_t firstDue, I2cPriority priority);
+void i2cSchedulerRemove(I2cJobId job);
+
+// Oldest unread sample of a job; false when its ring is empty.
+bool i2cSchedulerTakeSample(I2cJobId job, I2cSample *sample);
+const I2cJobStats *i2cSchedulerStats(I2cJobId job);
+
+// Queues a one-off transfer; false when the queue is full.
+bool i2cSchedulerSubmit(I2cRequest *request);
+
+// Runs due work for at most I2C_SCHEDULER_BUDGET_US of bus time.
+void i2cSchedulerService(uint32_t now);
+
+#endif // I2C_SCHEDULER_H
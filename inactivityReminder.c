@@ -0,0 +1,79 @@
+/*
+ * File: inactivityReminder.c
+ * Project: Smart Watch - Final Version
+ * Description: Sedentary reminder state machine.
+ *
+ * While the wearer moves, only the ADXL345 inactivity interrupt is
+ * enabled. When it reports TIME_INACT seconds below THRESH_INACT, the
+ * reminder alarm is started for the rest of the period and the detectors
+ * are swapped, so the next interrupt is either movement (cancel) or the
+ * alarm (remind, then re-arm for another period). Between those events
+ * the CPU does nothing on behalf of this feature.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "alarmScheduler.h"
+#include "accelSensor.h"
+#include "inactivityReminder.h"
+
+#define INACT_THRESHOLD_MG      188
+#define ACT_THRESHOLD_MG        375
+#define INACT_TIME_SECONDS      60
+
+static uint16_t periodSeconds = INACTIVITY_REMINDER_DEFAULT_MINUTES * 60U;
+static uint8_t wakeHour = INACTIVITY_REMINDER_WAKE_HOUR;
+static uint8_t sleepHour = INACTIVITY_REMINDER_SLEEP_HOUR;
+static bool sedentary = false;
+static AlarmId reminderAlarm = ALARM_NONE;
+
+static void watchForInactivity(void) {
+    sedentary = false;
+    accelSensorDisableInterrupts(ACCEL_INT_ACTIVITY);
+    accelSensorEnableInterrupts(ACCEL_INT_INACTIVITY);
+}
+
+static void watchForActivity(void) {
+    sedentary = true;
+    accelSensorDisableInterrupts(ACCEL_INT_INACTIVITY);
+    accelSensorEnableInterrupts(ACCEL_INT_ACTIVITY);
+}
+
+bool inactivityReminderInit(void) {
+    if (reminderAlarm == ALARM_NONE)
+        reminderAlarm = alarmSchedulerAdd();
+    alarmSchedulerCancel(reminderAlarm);
+    sedentary = false;
+    return reminderAlarm != ALARM_NONE &&
+           accelSensorConfigureActivity(ACT_THRESHOLD_MG, INACT_THRESHOLD_MG, INACT_TIME_SECONDS) &&
+           accelSensorEnableInterrupts(ACCEL_INT_INACTIVITY);
+}
+
+void inactivityReminderSetPeriod(uint8_t minutes) {
+    if (minutes * 60U <= INACT_TIME_SECONDS)
+        minutes = INACT_TIME_SECONDS / 60 + 1;
+    periodSeconds = minutes * 60U;
+}
+
+void inactivityReminderSetWakingHours(uint8_t startHour, uint8_t endHour) {
+    wakeHour = startHour;
+    sleepHour = endHour;
+}
+
+void inactivityReminderOnAccelEvents(uint8_t source) {
+    if ((source & ACCEL_INT_ACTIVITY) && sedentary) {
+        alarmSchedulerCancel(reminderAlarm);
+        watchForInactivity();
+    } else if ((source & ACCEL_INT_INACTIVITY) && !sedentary) {
+        // The detector has already seen TIME_INACT seconds of stillness
+        alarmSchedulerStart(reminderAlarm, periodSeconds - INACT_TIME_SECONDS);
+        watchForActivity();
+    }
+}
+
+bool inactivityReminderTakeDue(uint8_t hourOfDay) {
+    if (!alarmSchedulerTakeFired(ALARM_BIT(reminderAlarm)))
+        return false;
+    alarmSchedulerStart(reminderAlarm, periodSeconds);
+    return hourOfDay >= wakeHour && hourOfDay < sleepHour;
+}
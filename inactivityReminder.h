@@ -0,0 +1,32 @@
+/*
+ * File: inactivityReminder.h
+ * Project: Smart Watch - Final Version
+ * Description: Sedentary reminder built from the ADXL345 activity and
+ *              inactivity detectors and a scheduled alarm; nothing is counted
+ *              in software while the wearer sits still.
+ */
+
+#ifndef INACTIVITY_REMINDER_H
+#define INACTIVITY_REMINDER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define INACTIVITY_REMINDER_DEFAULT_MINUTES 60
+#define INACTIVITY_REMINDER_WAKE_HOUR       8   // reminders from 08:00
+#define INACTIVITY_REMINDER_SLEEP_HOUR      22  // until 21:59
+
+// Programs the ADXL345 detectors and claims an alarm slot.
+// alarmSchedulerInit must have run.
+bool inactivityReminderInit(void);
+
+void inactivityReminderSetPeriod(uint8_t minutes);
+void inactivityReminderSetWakingHours(uint8_t startHour, uint8_t endHour);
+
+// Passes on the ADXL345 INT_SOURCE bits read by the main loop.
+void inactivityReminderOnAccelEvents(uint8_t source);
+
+// True once per elapsed sedentary period that falls in waking hours.
+bool inactivityReminderTakeDue(uint8_t hourOfDay);
+
+#endif // INACTIVITY_REMINDER_H
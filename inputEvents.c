@@ -0,0 +1,42 @@
+/*
+ * File: inputEvents.c
+ * Project: Smart Watch - Final Version
+ * Description: Fixed-size ring buffer of input events.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "inputEvents.h"
+
+#define INPUT_QUEUE_SIZE 8   // power of two
+
+static volatile uint8_t queue[INPUT_QUEUE_SIZE];
+static volatile uint8_t head = 0;
+static volatile uint8_t tail = 0;
+
+bool inputEventPost(InputEvent event) {
+    uint16_t savedIpl;
+    bool posted = false;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    if ((uint8_t)(head - tail) < INPUT_QUEUE_SIZE) {
+        queue[head & (INPUT_QUEUE_SIZE - 1)] = (uint8_t)event;
+        head++;
+        posted = true;
+    }
+    RESTORE_CPU_IPL(savedIpl);
+    return posted;
+}
+
+bool inputEventPop(InputEvent *event) {
+    if (head == tail)
+        return false;
+    *event = (InputEvent)queue[tail & (INPUT_QUEUE_SIZE - 1)];
+    tail++;
+    return true;
+}
+
+void inputEventFlush(void) {
+    tail = head;
+}
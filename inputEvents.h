@@ -0,0 +1,27 @@
+/*
+ * File: inputEvents.h
+ * Project: Smart Watch - Final Version
+ * Description: Queue of user input events (buttons, accelerometer taps).
+ *              Producers may run in interrupt context; the main loop is the
+ *              only consumer.
+ */
+
+#ifndef INPUT_EVENTS_H
+#define INPUT_EVENTS_H
+
+#include <stdbool.h>
+
+typedef enum {
+    INPUT_EVENT_BUTTON1,
+    INPUT_EVENT_BUTTON2,
+    INPUT_EVENT_BUTTON_BOTH,
+    INPUT_EVENT_TAP,
+    INPUT_EVENT_DOUBLE_TAP
+} InputEvent;
+
+// Returns false (and drops the event) when the queue is full.
+bool inputEventPost(InputEvent event);
+bool inputEventPop(InputEvent *event);
+void inputEventFlush(void);
+
+#endif // INPUT_EVENTS_H
@@ -0,0 +1,103 @@
+/*
+ * File: latencyMonitor.c
+ * Project: Smart Watch - Final Version
+ * Description: Interrupt latency histograms, measured against the
+ *              hardware event that raised each interrupt.
+ *
+ * SCCP6 captures every rising edge of the accelerometer's INT1 line into
+ * its buffer while INT1 itself raises the interrupt, so the capture is
+ * the moment the event happened whatever the CPU was doing. The handler
+ * takes the oldest buffered edge, which is the one it is servicing, and
+ * drops the rest. The 16-bit timer wraps after ~1 s, longer than any
+ * latency worth measuring.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "latencyMonitor.h"
+
+#define CAPTURE_US_PER_TICK     16      // FCY / 64
+#define TIMER1_US_PER_TICK      64      // FCY / 256
+#define ACCEL_INT_RP            11
+#define ACCEL_INT_CAPTURE_PPS   RPINR8bits.ICM6R
+
+static LatencyStats stats[LATENCY_SOURCE_COUNT];
+
+void latencyMonitorInit(void) {
+    latencyMonitorReset();
+
+    __builtin_write_OSCCONL(OSCCON & 0xbf); // unlock PPS
+    ACCEL_INT_CAPTURE_PPS = ACCEL_INT_RP;
+    __builtin_write_OSCCONL(OSCCON | 0x40); // lock PPS
+
+    CCP6CON1L = 0;
+    CCP6CON1Lbits.CCSEL = 1;                // input capture
+    CCP6CON1Lbits.MOD = 0b0001;             // every rising edge
+    CCP6CON1Lbits.TMRPS = 0b11;             // FCY / 64
+    CCP6CON1H = 0;
+    CCP6CON2H = 0;                          // capture from the ICM6 pin
+    CCP6CON1Lbits.CCPON = 1;
+}
+
+void latencyMonitorRecord(LatencySource source, uint32_t latencyUs) {
+    LatencyStats *entry = &stats[source];
+    uint8_t bucket = 0;
+    uint16_t savedIpl;
+
+    while (bucket < LATENCY_BUCKETS - 1 && latencyUs >= ((uint32_t)LATENCY_FIRST_BUCKET_US << bucket))
+        bucket++;
+
+    // A higher-priority source may record in the middle of this one
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    if (entry->counts[bucket] < UINT16_MAX)
+        entry->counts[bucket]++;
+    if (entry->events < UINT16_MAX)
+        entry->events++;
+    if (latencyUs > entry->maxUs)
+        entry->maxUs = latencyUs;
+    if (entry->budgetUs != 0 && latencyUs > entry->budgetUs && entry->overBudget < UINT16_MAX)
+        entry->overBudget++;
+    RESTORE_CPU_IPL(savedIpl);
+}
+
+void latencyMonitorTimer1Entry(void) {
+    latencyMonitorRecord(LATENCY_TIMER1, (uint32_t)TMR1 * TIMER1_US_PER_TICK);
+}
+
+void latencyMonitorAccelEntry(void) {
+    uint16_t now = CCP6TMRL;
+    uint16_t edge;
+
+    if (!CCP6STATLbits.ICBNE)
+        return;                             // raised without an edge
+    edge = CCP6BUFL;
+    while (CCP6STATLbits.ICBNE)
+        (void)CCP6BUFL;
+    latencyMonitorRecord(LATENCY_ACCEL_INT, (uint32_t)(uint16_t)(now - edge) * CAPTURE_US_PER_TICK);
+}
+
+void latencyMonitorSetBudget(LatencySource source, uint32_t budgetUs) {
+    stats[source].budgetUs = budgetUs;
+}
+
+void latencyMonitorSnapshot(LatencySource source, LatencyStats *copy) {
+    uint16_t savedIpl;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    *copy = stats[source];
+    RESTORE_CPU_IPL(savedIpl);
+}
+
+void latencyMonitorReset(void) {
+    uint16_t savedIpl;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    for (uint8_t i = 0; i < LATENCY_SOURCE_COUNT; i++) {
+        uint32_t budget = stats[i].budgetUs;
+        memset(&stats[i], 0, sizeof(stats[i]));
+        stats[i].budgetUs = budget;
+    }
+    RESTORE_CPU_IPL(savedIpl);
+}
@@ -0,0 +1,56 @@
+/*
+ * File: latencyMonitor.h
+ * Project: Smart Watch - Final Version
+ * Description: Interrupt latency histograms, measured against the
+ *              hardware event that raised each interrupt.
+ *
+ * Timer1's latency is TMR1 at entry, since the timer restarts on its
+ * period match (64 us resolution). External events are time-stamped by
+ * input capture on SCCP6, free running at FCY / 64 (16 us); the handler
+ * subtracts the captured edge from the timer at entry. Latencies are kept
+ * per source in power-of-two buckets with a count of those over the
+ * source's budget.
+ */
+
+#ifndef LATENCY_MONITOR_H
+#define LATENCY_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    LATENCY_TIMER1,             // 1 Hz timekeeping tick
+    LATENCY_ACCEL_INT,          // ADXL345 INT1 edge on RB11
+    LATENCY_SOURCE_COUNT
+} LatencySource;
+
+// Bucket b holds latencies below LATENCY_FIRST_BUCKET_US << b; the last
+// one everything longer
+#define LATENCY_BUCKETS         14
+#define LATENCY_FIRST_BUCKET_US 16
+
+typedef struct {
+    uint16_t counts[LATENCY_BUCKETS];
+    uint16_t events;
+    uint16_t overBudget;
+    uint32_t maxUs;
+    uint32_t budgetUs;
+} LatencyStats;
+
+// Starts the capture timer. Call before enabling the monitored interrupts.
+void latencyMonitorInit(void);
+
+// Adds one latency; callable from any interrupt level
+void latencyMonitorRecord(LatencySource source, uint32_t latencyUs);
+
+// First statement of the corresponding handlers
+void latencyMonitorTimer1Entry(void);
+void latencyMonitorAccelEntry(void);
+
+void latencyMonitorSetBudget(LatencySource source, uint32_t budgetUs);
+
+// Consistent copy of one source's statistics
+void latencyMonitorSnapshot(LatencySource source, LatencyStats *stats);
+void latencyMonitorReset(void);
+
+#endif // LATENCY_MONITOR_H
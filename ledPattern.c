@@ -0,0 +1,169 @@
+/*
+ * File: ledPattern.c
+ * Project: Smart Watch - Final Version
+ * Description: LED pattern engine on SCCP4 (LED1) and SCCP5 (LED2).
+ *
+ * Both modules run buffered dual-edge PWM at ~1 kHz. SCCP4's compare
+ * interrupt, postscaled 1:16, is the ~61 Hz pattern tick: it only loads
+ * the next duty value. The interrupt is disabled again once no pattern is
+ * playing, so an idle engine costs nothing.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "ledPattern.h"
+
+// PPS: route the SCCP outputs to the LED pins (RA8 -> LED1, RA9 -> LED2)
+#define LED1_PPS_OUTPUT     RPOR13bits.RP26R
+#define LED2_PPS_OUTPUT     RPOR13bits.RP27R
+#define PPS_FN_OCM4         21
+#define PPS_FN_OCM5         22
+
+#define LED_PWM_PERIOD      1023    // FCY / 4 / 1024 = ~977 Hz
+#define LED_TICK_POSTSCALE  15      // OPS: tick every 16 periods
+
+typedef struct {
+    const uint8_t *levels;
+    uint8_t length;
+    uint8_t ticksPerStep;
+} LedPattern;
+
+typedef struct {
+    const LedPattern *pattern;
+    uint8_t index;
+    uint8_t tick;
+    uint8_t repeatsLeft;
+    bool directOn;
+} LedChannel;
+
+static const uint8_t BLINK_LEVELS[] = {255, 0};
+static const uint8_t DOUBLE_FLASH_LEVELS[] = {255, 0, 255, 0, 0, 0, 0, 0};
+// Gamma-corrected (2.2) ramp so the fade looks linear to the eye
+static const uint8_t BREATHE_LEVELS[] = {
+    0, 1, 3, 7, 14, 23, 34, 48, 64, 83, 105, 129, 156, 186, 219, 255,
+    255, 219, 186, 156, 129, 105, 83, 64, 48, 34, 23, 14, 7, 3, 1, 0
+};
+
+static const LedPattern PATTERNS[LED_PATTERN_COUNT] = {
+    [LED_PATTERN_BLINK]        = {BLINK_LEVELS, sizeof(BLINK_LEVELS), 15},
+    [LED_PATTERN_BREATHE]      = {BREATHE_LEVELS, sizeof(BREATHE_LEVELS), 4},
+    [LED_PATTERN_DOUBLE_FLASH] = {DOUBLE_FLASH_LEVELS, sizeof(DOUBLE_FLASH_LEVELS), 6},
+};
+
+static volatile LedChannel channels[LED_COUNT];
+
+static void setDuty(LedId led, uint8_t level) {
+    uint16_t duty = (uint16_t)level << 2;
+    if (led == LED_1)
+        CCP4RBL = duty;
+    else
+        CCP5RBL = duty;
+}
+
+static bool anyPatternActive(void) {
+    for (uint8_t led = 0; led < LED_COUNT; led++)
+        if (channels[led].pattern != NULL)
+            return true;
+    return false;
+}
+
+void ledPatternInit(void) {
+    __builtin_write_OSCCONL(OSCCON & 0xbf); // unlock PPS
+    LED1_PPS_OUTPUT = PPS_FN_OCM4;
+    LED2_PPS_OUTPUT = PPS_FN_OCM5;
+    __builtin_write_OSCCONL(OSCCON | 0x40); // lock PPS
+
+    CCP4CON1L = 0;
+    CCP4CON1Lbits.TMRPS = 1;                // FCY / 4
+    CCP4CON1Lbits.MOD = 0b0101;             // dual-edge buffered PWM
+    CCP4CON1H = 0;
+    CCP4CON1Hbits.OPS = LED_TICK_POSTSCALE;
+    CCP4CON2H = 0;
+    CCP4CON2Hbits.OCAEN = 1;
+    CCP4PRL = LED_PWM_PERIOD;
+    CCP4RAL = 0;
+    CCP4RBL = 0;
+
+    CCP5CON1L = 0;
+    CCP5CON1Lbits.TMRPS = 1;
+    CCP5CON1Lbits.MOD = 0b0101;
+    CCP5CON1H = 0;
+    CCP5CON2H = 0;
+    CCP5CON2Hbits.OCAEN = 1;
+    CCP5PRL = LED_PWM_PERIOD;
+    CCP5RAL = 0;
+    CCP5RBL = 0;
+
+    for (uint8_t led = 0; led < LED_COUNT; led++) {
+        channels[led].pattern = NULL;
+        channels[led].directOn = false;
+    }
+
+    IPC11bits.CCP4IP = 2;
+    IFS2bits.CCP4IF = 0;
+    IEC2bits.CCP4IE = 0;
+
+    CCP4CON1Lbits.CCPON = 1;
+    CCP5CON1Lbits.CCPON = 1;
+}
+
+void ledPatternPlay(LedId led, LedPatternId pattern, uint8_t repeats) {
+    volatile LedChannel *channel = &channels[led];
+
+    IEC2bits.CCP4IE = 0;
+    channel->pattern = &PATTERNS[pattern];
+    channel->index = 0;
+    channel->tick = 0;
+    channel->repeatsLeft = repeats;
+    setDuty(led, channel->pattern->levels[0]);
+    IFS2bits.CCP4IF = 0;
+    IEC2bits.CCP4IE = 1;
+}
+
+void ledPatternStop(LedId led) {
+    IEC2bits.CCP4IE = 0;
+    channels[led].pattern = NULL;
+    setDuty(led, channels[led].directOn ? 255 : 0);
+    if (anyPatternActive())
+        IEC2bits.CCP4IE = 1;
+}
+
+bool ledPatternIsActive(LedId led) {
+    return channels[led].pattern != NULL;
+}
+
+void ledPatternSet(LedId led, bool on) {
+    if (channels[led].directOn == on)
+        return;
+    channels[led].directOn = on;
+    if (channels[led].pattern == NULL)
+        setDuty(led, on ? 255 : 0);
+}
+
+// Pattern tick: advance each playing channel by one step when due
+void __attribute__((__interrupt__, auto_psv)) _CCP4Interrupt(void) {
+    for (uint8_t led = 0; led < LED_COUNT; led++) {
+        volatile LedChannel *channel = &channels[led];
+        const LedPattern *pattern = channel->pattern;
+
+        if (pattern == NULL || ++channel->tick < pattern->ticksPerStep)
+            continue;
+        channel->tick = 0;
+
+        if (++channel->index >= pattern->length) {
+            channel->index = 0;
+            if (channel->repeatsLeft != LED_REPEAT_FOREVER && --channel->repeatsLeft == 0) {
+                channel->pattern = NULL;
+                setDuty(led, channel->directOn ? 255 : 0);
+                continue;
+            }
+        }
+        setDuty(led, pattern->levels[channel->index]);
+    }
+
+    if (!anyPatternActive())
+        IEC2bits.CCP4IE = 0;
+    IFS2bits.CCP4IF = 0;
+}
@@ -0,0 +1,40 @@
+/*
+ * File: ledPattern.h
+ * Project: Smart Watch - Final Version
+ * Description: Notification patterns on LED1/LED2 generated by SCCP PWM.
+ *              Brightness steps are loaded from the PWM interrupt, so a
+ *              pattern plays without any main-loop involvement.
+ */
+
+#ifndef LED_PATTERN_H
+#define LED_PATTERN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    LED_1,
+    LED_2,
+    LED_COUNT
+} LedId;
+
+typedef enum {
+    LED_PATTERN_BLINK,
+    LED_PATTERN_BREATHE,
+    LED_PATTERN_DOUBLE_FLASH,
+    LED_PATTERN_COUNT
+} LedPatternId;
+
+#define LED_REPEAT_FOREVER 0
+
+void ledPatternInit(void);
+
+// Starts a pattern on one LED; repeats == LED_REPEAT_FOREVER loops until stopped.
+void ledPatternPlay(LedId led, LedPatternId pattern, uint8_t repeats);
+void ledPatternStop(LedId led);
+bool ledPatternIsActive(LedId led);
+
+// Direct on/off (button feedback). Ignored while a pattern is playing.
+void ledPatternSet(LedId led, bool on);
+
+#endif // LED_PATTERN_H
@@ -14,10 +14,33 @@
  #include <string.h>
  #include "System/system.h"
  #include "System/delay.h"
+ #include "System/rtcc.h"
  #include "oledDriver/oledC.h"
  #include "oledDriver/oledC_colors.h"
  #include "oledDriver/oledC_shapes.h"
  #include "Accel_i2c.h"
+ #include "powerMonitor.h"
+ #include "snapshotStore.h"
+ #include "ledPattern.h"
+ #include "accelSensor.h"
+ #include "inputEvents.h"
+ #include "historyStore.h"
+ #include "stepLog.h"
+ #include "historyExport.h"
+ #include "sleepTracker.h"
+ #include "activityClassifier.h"
+ #include "fitnessEstimator.h"
+ #include "fallDetector.h"
+ #include "inactivityReminder.h"
+ #include "diagnostics.h"
+ #include "i2cScheduler.h"
+ #include "historyBrowser.h"
+ #include "latencyMonitor.h"
+ #include "samplingMonitor.h"
+ #include "taskSupervisor.h"
+ #include "complications.h"
+ #include "alarmScheduler.h"
+ #include "timebase.h"
  #include <libpic30.h>
  #include <xc.h>
  
@@ -26,25 +49,45 @@
  #define BUTTON2_PORT      PORTAbits.RA1
  #define BUTTON1_TRIS      TRISAbits.TRISA0
  #define BUTTON2_TRIS      TRISAbits.TRISA1
- #define LED1_PORT         LATAbits.LATA8
- #define LED2_PORT         LATAbits.LATA9
  #define LED1_TRIS         TRISAbits.TRISA8
  #define LED2_TRIS         TRISAbits.TRISA9
  
- // Accelerometer Configuration
- #define ACCEL_WRITE_ADDR  0x3A
- #define REG_POWER_CTL     0x2D
- #define REG_DATA_X0       0x32
- #define REG_DATA_Y0       0x34
- #define REG_DATA_Z0       0x36
- #define MEASURE_MODE      0x08
- 
  // Constants
  #define STEP_THRESHOLD    900.0f
  #define GRAPH_WIDTH       90
  #define GRAPH_HEIGHT      100
  #define HISTORY_SIZE      60
- #define MENU_ITEM_COUNT   5
+ #define MENU_ITEM_COUNT   9
+ #define SUPPLY_SAMPLE_PERIOD 60
+ #define STEP_GOAL         1000
+ #define MOVE_OVERLAY_SECONDS 5
+ #define ALARM_OFF_HOUR    24      // the hour field's extra value: alarm off
+ #define COUNTDOWN_MAX_MINUTES 99
+ #define SECONDS_PER_DAY   86400UL
+ // Longest stretch of the alarm clock timed by the RTCC, whose LPRC may be a
+ // few percent off Timer1; each wake-up re-derives the wait from the face
+ // clock, so the alarm rings within seconds of the time shown.
+ #define ALARM_CLOCK_MAX_WAIT 600UL
+ // A single tap is only reported once the double-tap window has passed
+ // (LATENT + WINDOW = 350 ms), so a double tap never also moves the menu.
+ #define TAP_CONFIRM_TICKS ((350UL * TIMER1_TICKS_PER_SECOND) / 1000)
+ // Interrupt latency budgets. Timer1 is only held off by IPL 7 sections
+ // (flash writes); INT1 also waits for a Timer1 handler that redraws.
+ #define TIMER1_LATENCY_BUDGET_US 1000
+ #define ACCEL_INT_LATENCY_BUDGET_US 5000
+ // The activity classifier's 64-sample window is sized for ~2.5 s, i.e. a
+ // detector sample every 39 ms; intervals more than 10 ms off are violations.
+ #define STEP_SAMPLE_INTERVAL_TICKS ((39UL * TIMER1_TICKS_PER_SECOND) / 1000)
+ #define STEP_SAMPLE_TOLERANCE_TICKS ((10UL * TIMER1_TICKS_PER_SECOND) / 1000)
+ // Supervised tasks. The loop's tasks run on every pass, so one period
+ // bounds them all; a fall capture drains the whole FIFO, and the sleep
+ // page only wakes on the 1 Hz tick and the 2 s FIFO watermark.
+ #define MAIN_LOOP_PERIOD_TICKS TICKS_FROM_MS(500)
+ #define ACCEL_EVENTS_BUDGET_TICKS TICKS_FROM_MS(30)
+ #define I2C_SCHEDULER_BUDGET_TICKS TICKS_FROM_MS(I2C_SCHEDULER_BUDGET_US / 1000 + 2)
+ #define HISTORY_EXPORT_BUDGET_TICKS TICKS_FROM_MS(20)
+ #define CLOCK_FACE_BUDGET_TICKS TICKS_FROM_MS(150)
+ #define UI_PAGE_PERIOD_TICKS TICKS_FROM_MS(2500)
  
  // Data Structures
  typedef struct {
@@ -61,6 +104,13 @@
      uint8_t month;
  } DateSetting;
  
+ typedef enum {
+     FACE_OVERLAY_NONE,
+     FACE_OVERLAY_MOVE,
+     FACE_OVERLAY_ALARM,
+     FACE_OVERLAY_COUNTDOWN
+ } FaceOverlay;
+ 
  typedef struct {
      uint8_t hours;
      uint8_t minutes;
@@ -82,7 +132,6 @@
  static uint8_t dateFieldSelected = 0;
  
  static bool wasStepThresholdExceeded = false;
- static bool isMovementActive = false;
  static uint16_t totalSteps = 0;
  static const float GRAVITY_BASELINE = 1024.0f;
  static uint8_t stepsPerSecond[HISTORY_SIZE] = {0};
@@ -94,12 +143,37 @@
  static bool inTimeSetMenu = false;
  static uint8_t timeFormatOption = 0;
  static bool showFootIcon = false;
- static bool redrawClock = false;
  static bool justEnteredMenu = false;
  static bool inMainMenu = false;
+ static bool singleTapPending = false;
+ static uint32_t singleTapDeadline = 0;
+ static FaceOverlay faceOverlay = FACE_OVERLAY_NONE;
+ static OLEDC_PANEL_PROFILE wantedPanelProfile = OLEDC_PANEL_BALANCED;
+ static bool panelProfilePending = true;
+ static AlarmId overlayTimer = ALARM_NONE;
+ static AlarmId alarmClockTimer = ALARM_NONE;
+ static AlarmId countdownTimer = ALARM_NONE;
+ static TimeSetting alarmTime = {7, 0};
+ static uint32_t alarmClockLeft = 0;     // seconds to alarmTime when last armed
+ static TimeSetting alarmToSet = {ALARM_OFF_HOUR, 0};
+ static uint8_t countdownToSet = 0;
+ static uint8_t alarmFieldSelected = 0;
+ static ComplicationId activityComplication = -1;
+ static ComplicationId fitnessComplication = -1;
+ static ComplicationId moveComplication = -1;
+ 
+ static const AccelTapConfig TAP_CONFIG = {
+     .thresholdMg = 3000,
+     .durationMs = 10,
+     .latencyMs = 100,
+     .windowMs = 250,
+     .axes = ACCEL_AXIS_Z
+ };
  
  static const uint8_t DAYS_PER_MONTH[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
  static ClockTime systemClock = {4, 0, 0, 24, 1}; // 4:00:00 AM, Jan 24th
+ static AccelerometerData latestAccel;
+ static uint8_t latestDrained = 0;
  static char lastDisplayedTime[9] = "";
  
  // Foot Icon Bitmaps (16x16)
@@ -120,6 +194,7 @@
  void processTimeSetInput(void);
  bool checkTiltToSave(void);
  void displayDateSetValues(void);
+ void displayAlarmValues(void);
  extern void renderMainMenu(void);
  
  // Error Handling
@@ -129,63 +204,131 @@
      while (1);
  }
  
- // Reads accelerometer data for a specific axis
- int16_t readAccelerometerAxis(uint8_t registerAddress) {
-     uint8_t lowByte, highByte;
-     int retries = 3;
-     for (int i = 0; i < retries; i++) {
-         if (i2cReadSlaveRegister(ACCEL_WRITE_ADDR, registerAddress, &lowByte) == OK)
-             break;
-         if (i == retries - 1)
-             haltWithError("I2C Read Error (LSB)");
-         DELAY_milliseconds(10);
+ // Drains the accelerometer FIFO, passing every sample to the fall detector,
+ // and returns the newest one. Returns the number of samples drained, zero
+ // when none arrived since the last call.
+ uint8_t readLatestAccelerometer(AccelerometerData *accel) {
+     AccelSample sample;
+     uint8_t entries = accelSensorFifoEntries();
+     uint8_t remaining = entries;
+     if (entries == 0)
+         return 0;
+     while (remaining-- > 0) {
+         if (!accelSensorReadSample(&sample))
+             haltWithError("I2C Read Error");
+         fallDetectorAddSample(&sample);
      }
-     for (int i = 0; i < retries; i++) {
-         if (i2cReadSlaveRegister(ACCEL_WRITE_ADDR, registerAddress + 1, &highByte) == OK)
-             break;
-         if (i == retries - 1)
-             haltWithError("I2C Read Error (MSB)");
-         DELAY_milliseconds(10);
-     }
-     return ((int16_t)highByte << 8) | lowByte;
+     accel->x = sample.x;
+     accel->y = sample.y;
+     accel->z = sample.z;
+     return entries;
  }
  
- // Initializes the accelerometer with retry mechanism
+ // Initializes the accelerometer (register access retries internally)
  void initializeAccelerometer(void) {
-     I2Cerror status;
-     uint8_t deviceId = 0;
-     for (int i = 0; i < 3; i++) {
-         status = i2cReadSlaveRegister(ACCEL_WRITE_ADDR, 0x00, &deviceId);
-         if (status == OK && deviceId == 0xE5)
-             break;
-         if (i == 2)
-             haltWithError("I2C Error or Wrong Device ID");
-         DELAY_milliseconds(10);
-     }
-     for (int i = 0; i < 3; i++) {
-         status = i2cWriteSlave(ACCEL_WRITE_ADDR, REG_POWER_CTL, MEASURE_MODE);
-         if (status == OK)
-             break;
-         if (i == 2)
-             haltWithError("Accel Power Error");
-         DELAY_milliseconds(10);
+     if (!accelSensorInit())
+         haltWithError("I2C Error or Wrong Device ID");
+     if (!accelSensorConfigureTap(&TAP_CONFIG))
+         haltWithError("Accel Tap Config Error");
+     // Stream mode keeps the last 32 samples for the fall detector's capture
+     if (!accelSensorConfigureFifo(ACCEL_FIFO_STREAM, 0) || !fallDetectorInit())
+         haltWithError("Accel FIFO Config Error");
+     if (!inactivityReminderInit())
+         haltWithError("Accel Inactivity Config Error");
+     accelSensorInitInterruptPin();
+ }
+ 
+ // Coarse monotonic time in Timer1 ticks (64 us), for short timeouts
+ static uint32_t currentTicks(void) {
+     uint32_t seconds;
+     uint16_t ticks;
+     do {
+         seconds = elapsedSeconds;
+         ticks = TMR1;
+     } while (seconds != elapsedSeconds);
+     return seconds * TIMER1_TICKS_PER_SECOND + ticks;
+ }
+ 
+ // Logs a confirmed fall and flashes LED2 so the wearer notices
+ static void reportFall(void) {
+     HistoryRecord record;
+     record.type = HISTORY_RECORD_FALL;
+     record.timestamp = historyTimestamp(systemClock.month, systemClock.day,
+                                         systemClock.hours, systemClock.minutes);
+     record.value = fallDetectorPeakMg();
+     historyStoreAppend(&record);
+     ledPatternPlay(LED_2, LED_PATTERN_DOUBLE_FLASH, 5);
+ }
+ 
+ // Turns accelerometer interrupts into input events. INT_SOURCE is only
+ // read after INT1 fired, so taps and falls cost no polling on the I2C bus.
+ // The FIFO is drained first, in every mode: the samples of a free fall are
+ // already queued when it is reported and belong before the trigger. The
+ // newest sample is kept for this pass's step detection.
+ void serviceAccelerometerEvents(void) {
+     latestDrained = readLatestAccelerometer(&latestAccel);
+     if (accelSensorInterruptPending()) {
+         uint8_t source = accelSensorReadInterruptSource();
+         if (source & ACCEL_INT_DOUBLE_TAP) {
+             singleTapPending = false;
+             inputEventPost(INPUT_EVENT_DOUBLE_TAP);
+         } else if (source & ACCEL_INT_SINGLE_TAP) {
+             singleTapPending = true;
+             singleTapDeadline = currentTicks() + TAP_CONFIRM_TICKS;
+         }
+         if (source & ACCEL_INT_FREE_FALL)
+             fallDetectorTrigger();
+         inactivityReminderOnAccelEvents(source);
      }
-     for (int i = 0; i < 3; i++) {
-         status = i2cWriteSlave(ACCEL_WRITE_ADDR, 0x31, 0x0B);
-         if (status == OK)
-             break;
-         if (i == 2)
-             haltWithError("Accel Data Format Error");
-         DELAY_milliseconds(10);
+     if (singleTapPending && (int32_t)(currentTicks() - singleTapDeadline) >= 0) {
+         singleTapPending = false;
+         inputEventPost(INPUT_EVENT_TAP);
      }
+     if (fallDetectorTakeConfirmed())
+         reportFall();
  }
  
- // Detects steps based on accelerometer data
+ // Feeds the step count of every minute to the compressed step log, so the
+ // history browser can page through past days
+ static void logStepMinute(void) {
+     static uint8_t trackedMinute = 0xFF;
+     static uint32_t minuteStart;
+     static uint16_t stepsAtMinuteStart;
+ 
+     if (systemClock.minutes == trackedMinute)
+         return;
+     if (trackedMinute != 0xFF)
+         stepLogAddMinute(minuteStart, totalSteps - stepsAtMinuteStart);
+     trackedMinute = systemClock.minutes;
+     minuteStart = historyTimestamp(systemClock.month, systemClock.day,
+                                    systemClock.hours, systemClock.minutes);
+     stepsAtMinuteStart = totalSteps;
+ }
+ 
+ // Records the activity class in the history whenever it changes
+ static void logActivityChange(void) {
+     static ActivityClass loggedActivity = ACTIVITY_IDLE;
+     ActivityClass activity = activityClassifierCurrent();
+     if (activity == loggedActivity)
+         return;
+ 
+     HistoryRecord record;
+     record.type = HISTORY_RECORD_ACTIVITY;
+     record.timestamp = historyTimestamp(systemClock.month, systemClock.day,
+                                         systemClock.hours, systemClock.minutes);
+     record.value = activity;
+     historyStoreAppend(&record);
+     loggedActivity = activity;
+ }
+ 
+ // Detects steps in the sample serviceAccelerometerEvents drained this pass
  void detectStep(void) {
-     AccelerometerData accel;
-     accel.x = readAccelerometerAxis(REG_DATA_X0);
-     accel.y = readAccelerometerAxis(REG_DATA_Y0);
-     accel.z = readAccelerometerAxis(REG_DATA_Z0);
+     AccelerometerData accel = latestAccel;
+     uint8_t drained = latestDrained;
+     if (drained == 0)
+         return;
+     latestDrained = 0;
+     samplingMonitorSample(currentTicks(), drained);
  
      float ax = accel.x * 4.0f;
      float ay = accel.y * 4.0f;
@@ -194,37 +337,77 @@
      float dynamicForce = fabsf(magnitude - GRAVITY_BASELINE);
      bool exceedsThreshold = (dynamicForce > STEP_THRESHOLD);
  
-     isMovementActive = exceedsThreshold;
+     if (activityClassifierAddSample((int16_t)(magnitude - GRAVITY_BASELINE))) {
+         logActivityChange();
+         complicationsInvalidate(activityComplication);
+     }
  
      if (exceedsThreshold && !wasStepThresholdExceeded) {
          totalSteps++;
          stepsPerSecond[currentSecondIndex]++;
+         fitnessEstimatorOnStep(currentTicks());
+         complicationsInvalidate(fitnessComplication);
+         if (totalSteps == STEP_GOAL)
+             ledPatternPlay(LED_1, LED_PATTERN_BREATHE, 3);
          printf("Step detected! Total=%u\n", totalSteps);
      }
  
      wasStepThresholdExceeded = exceedsThreshold;
  }
  
- // Displays the current step pace on the OLED
- void displayStepPace(void) {
-     static char previousText[6] = "";
-     char currentText[6];
+ // Puts a message over the clock face for MOVE_OVERLAY_SECONDS
+ static void showFaceOverlay(FaceOverlay overlay) {
+     faceOverlay = overlay;
+     alarmSchedulerStart(overlayTimer, MOVE_OVERLAY_SECONDS);
+     complicationsInvalidate(moveComplication);
+ }
  
-     if (displayedStepPace <= 0.5f) {
-         if (previousText[0] != '\0') {
-             oledC_DrawString(25, 2, 1, 1, (uint8_t *)previousText, OLEDC_COLOR_BLACK);
-             previousText[0] = '\0';
-         }
-         return;
+ // Shows or clears the sedentary reminder overlay on the clock face
+ void updateMoveReminder(void) {
+     if (inactivityReminderTakeDue(systemClock.hours)) {
+         ledPatternPlay(LED_1, LED_PATTERN_DOUBLE_FLASH, 3);
+         showFaceOverlay(FACE_OVERLAY_MOVE);
+     } else if (alarmSchedulerTakeFired(ALARM_BIT(overlayTimer))) {
+         faceOverlay = FACE_OVERLAY_NONE;
+         complicationsInvalidate(moveComplication);
      }
+ }
+ 
+ // Seconds from now until the next hours:minutes, a full day if that is now
+ static uint32_t secondsUntil(uint8_t hours, uint8_t minutes) {
+     uint32_t target = hours * 3600UL + minutes * 60UL;
+     uint32_t now = systemClock.hours * 3600UL + systemClock.minutes * 60UL + systemClock.seconds;
+     uint32_t seconds = (target + SECONDS_PER_DAY - now) % SECONDS_PER_DAY;
+     return (seconds == 0) ? SECONDS_PER_DAY : seconds;
+ }
  
-     sprintf(currentText, "%u", (uint16_t)(displayedStepPace + 0.5f));
+ // Arms the next stretch toward alarmTime on the face clock
+ static void armAlarmClock(void) {
+     alarmClockLeft = secondsUntil(alarmTime.hours, alarmTime.minutes);
+     alarmSchedulerStart(alarmClockTimer, alarmClockLeft < ALARM_CLOCK_MAX_WAIT
+                                          ? alarmClockLeft : ALARM_CLOCK_MAX_WAIT);
+ }
+ 
+ static void ringUserAlarm(FaceOverlay overlay) {
+     ledPatternPlay(LED_1, LED_PATTERN_BLINK, 10);
+     ledPatternPlay(LED_2, LED_PATTERN_BLINK, 10);
+     showFaceOverlay(overlay);
+ }
  
-     if (strcmp(previousText, currentText) != 0) {
-         oledC_DrawString(25, 2, 1, 1, (uint8_t *)previousText, OLEDC_COLOR_BLACK);
-         oledC_DrawString(25, 2, 1, 1, (uint8_t *)currentText, OLEDC_COLOR_WHITE);
-         strcpy(previousText, currentText);
+ // Rings the alarm clock and the countdown; the banner waits for the clock
+ // face. The alarm clock wakes at least every ALARM_CLOCK_MAX_WAIT and rings
+ // once the face clock has passed alarmTime, i.e. when the wait to it has
+ // wrapped around to the next day.
+ void serviceUserAlarms(void) {
+     uint16_t fired = alarmSchedulerTakeFired(ALARM_BIT(alarmClockTimer) | ALARM_BIT(countdownTimer));
+     if (fired & ALARM_BIT(alarmClockTimer)) {
+         uint32_t previousLeft = alarmClockLeft;
+         armAlarmClock();
+         if (alarmClockLeft > previousLeft)
+             ringUserAlarm(FACE_OVERLAY_ALARM);
      }
+     if (fired & ALARM_BIT(countdownTimer))
+         ringUserAlarm(FACE_OVERLAY_COUNTDOWN);
  }
  
  // Converts a number to a two-digit string
@@ -263,84 +446,191 @@
      }
  }
  
- // Renders the clock display on the OLED
- void renderClockDisplay(ClockTime *time) {
-     static uint8_t lastHours = 255, lastMinutes = 255, lastSeconds = 255;
-     static bool lastWas12Hour = false, lastIsPM = false;
-     static uint8_t lastDay = 255, lastMonth = 255;
-     char buffer[3];
-     bool isPM = false;
-     uint8_t displayHours = time->hours;
+ // Draws the foot icon animation based on step activity
+ void renderFootIcon(uint8_t x, uint8_t y, const uint16_t *bitmap, uint8_t width, uint8_t height) {
+     for (uint8_t row = 0; row < height; row++)
+         for (uint8_t col = 0; col < width; col++)
+             if (bitmap[row] & (1 << (width - 1 - col)))
+                 oledC_DrawPoint(x + col, y + row, OLEDC_COLOR_WHITE);
+ }
  
-     if (redrawClock) {
-         lastHours = lastMinutes = lastSeconds = 255;
-         lastDay = lastMonth = 255;
-         lastWas12Hour = !use12HourFormat;
-         lastIsPM = true;
-         redrawClock = false;
-     }
+ // Clock face complications. Each source packs what its region shows into
+ // one value, and the region is repainted only when that value changes.
+ 
+ // Hours as shown on the face, and whether they are after noon
+ static uint8_t faceHours(bool *isPM) {
+     uint8_t hours = systemClock.hours;
  
+     *isPM = (hours >= 12);
      if (use12HourFormat) {
-         if (displayHours == 0)
-             displayHours = 12;
-         else if (displayHours >= 12) {
-             isPM = true;
-             if (displayHours > 12)
-                 displayHours -= 12;
-         }
+         if (hours == 0)
+             hours = 12;
+         else if (hours > 12)
+             hours -= 12;
      }
+     return hours;
+ }
  
-     if (displayHours != lastHours || lastWas12Hour != use12HourFormat) {
-         oledC_DrawRectangle(8, 45, 32, 61, OLEDC_COLOR_BLACK);
-         formatTwoDigits(displayHours, buffer);
-         oledC_DrawString(8, 45, 2, 2, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
-         oledC_DrawString(32, 45, 2, 2, (uint8_t *)":", OLEDC_COLOR_WHITE);
-         lastHours = displayHours;
-     }
+ static uint32_t timeSource(void) {
+     bool isPM;
+     return (uint16_t)faceHours(&isPM) << 8 | systemClock.minutes;
+ }
  
-     if (time->minutes != lastMinutes || lastWas12Hour != use12HourFormat) {
-         oledC_DrawRectangle(40, 45, 64, 61, OLEDC_COLOR_BLACK);
-         formatTwoDigits(time->minutes, buffer);
-         oledC_DrawString(40, 45, 2, 2, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
-         oledC_DrawString(64, 45, 2, 2, (uint8_t *)":", OLEDC_COLOR_WHITE);
-         lastMinutes = time->minutes;
-     }
+ static void timeRender(const Complication *complication, uint32_t value) {
+     char buffer[3];
+     uint8_t x = complication->left;
+ 
+     formatTwoDigits(value >> 8, buffer);
+     oledC_DrawString(x, complication->top, 2, 2, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
+     oledC_DrawString(x + 24, complication->top, 2, 2, (uint8_t *)":", OLEDC_COLOR_WHITE);
+     formatTwoDigits(value & 0xFF, buffer);
+     oledC_DrawString(x + 32, complication->top, 2, 2, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
+     oledC_DrawString(x + 56, complication->top, 2, 2, (uint8_t *)":", OLEDC_COLOR_WHITE);
+ }
  
-     if (time->seconds != lastSeconds) {
-         oledC_DrawRectangle(72, 45, 96, 61, OLEDC_COLOR_BLACK);
-         formatTwoDigits(time->seconds, buffer);
-         oledC_DrawString(72, 45, 2, 2, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
-         lastSeconds = time->seconds;
-     }
+ static uint32_t secondsSource(void) {
+     return systemClock.seconds;
+ }
  
-     if (use12HourFormat && (isPM != lastIsPM || lastWas12Hour != use12HourFormat || lastHours == 255)) {
-         oledC_DrawRectangle(0, 85, 20, 93, OLEDC_COLOR_BLACK);
-         oledC_DrawString(0, 85, 1, 1, (uint8_t *)(isPM ? "PM" : "AM"), OLEDC_COLOR_WHITE);
-         lastIsPM = isPM;
-     } else if (!use12HourFormat && lastWas12Hour) {
-         oledC_DrawRectangle(0, 85, 20, 93, OLEDC_COLOR_BLACK);
-     }
+ static void secondsRender(const Complication *complication, uint32_t value) {
+     char buffer[3];
+     formatTwoDigits(value, buffer);
+     oledC_DrawString(complication->left, complication->top, 2, 2, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
+ }
  
-     if (time->day != lastDay || time->month != lastMonth || lastHours == 255) {
-         oledC_DrawRectangle(65, 85, 95, 93, OLEDC_COLOR_BLACK);
-         formatTwoDigits(time->day, buffer);
-         oledC_DrawString(65, 85, 1, 1, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
-         oledC_DrawString(77, 85, 1, 1, (uint8_t *)"/", OLEDC_COLOR_WHITE);
-         formatTwoDigits(time->month, buffer);
-         oledC_DrawString(83, 85, 1, 1, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
-         lastDay = time->day;
-         lastMonth = time->month;
-     }
+ // 0 in 24h format, else 1 for AM and 2 for PM
+ static uint32_t meridiemSource(void) {
+     bool isPM;
+     faceHours(&isPM);
+     return use12HourFormat ? (isPM ? 2 : 1) : 0;
+ }
  
-     lastWas12Hour = use12HourFormat;
+ static void meridiemRender(const Complication *complication, uint32_t value) {
+     if (value != 0)
+         oledC_DrawString(complication->left, complication->top, 1, 1,
+                          (uint8_t *)(value == 2 ? "PM" : "AM"), OLEDC_COLOR_WHITE);
  }
  
- // Draws the foot icon animation based on step activity
- void renderFootIcon(uint8_t x, uint8_t y, const uint16_t *bitmap, uint8_t width, uint8_t height) {
-     for (uint8_t row = 0; row < height; row++)
-         for (uint8_t col = 0; col < width; col++)
-             if (bitmap[row] & (1 << (width - 1 - col)))
-                 oledC_DrawPoint(x + col, y + row, OLEDC_COLOR_WHITE);
+ static uint32_t dateSource(void) {
+     return (uint16_t)systemClock.day << 8 | systemClock.month;
+ }
+ 
+ static void dateRender(const Complication *complication, uint32_t value) {
+     char buffer[3];
+     uint8_t x = complication->left;
+ 
+     formatTwoDigits(value >> 8, buffer);
+     oledC_DrawString(x, complication->top, 1, 1, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
+     oledC_DrawString(x + 12, complication->top, 1, 1, (uint8_t *)"/", OLEDC_COLOR_WHITE);
+     formatTwoDigits(value & 0xFF, buffer);
+     oledC_DrawString(x + 18, complication->top, 1, 1, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
+ }
+ 
+ // Rounded step pace, 0 while standing still
+ static uint32_t paceSource(void) {
+     if (displayedStepPace <= 0.5f)
+         return 0;
+     return (uint16_t)(displayedStepPace + 0.5f);
+ }
+ 
+ static void paceRender(const Complication *complication, uint32_t value) {
+     char text[6];
+ 
+     if (value == 0)
+         return;
+     sprintf(text, "%u", (uint16_t)value);
+     oledC_DrawString(complication->left, complication->top, 1, 1, (uint8_t *)text, OLEDC_COLOR_WHITE);
+ }
+ 
+ static uint32_t activitySource(void) {
+     return activityClassifierCurrent();
+ }
+ 
+ static void activityRender(const Complication *complication, uint32_t value) {
+     if (value != ACTIVITY_IDLE)
+         oledC_DrawString(complication->left, complication->top, 1, 1,
+                          (uint8_t *)activityClassName((ActivityClass)value), OLEDC_COLOR_WHITE);
+ }
+ 
+ // Today's distance in hundredths of a km above, active kcal below
+ static uint32_t fitnessSource(void) {
+     uint32_t hundredthsKm = fitnessDistanceMm() / 10000;
+     return hundredthsKm << 16 | (uint16_t)(fitnessEnergyCal() / 1000);
+ }
+ 
+ static void fitnessRender(const Complication *complication, uint32_t value) {
+     char text[24];
+     uint16_t hundredthsKm = value >> 16;
+ 
+     sprintf(text, "%u.%02ukm %ukcal", hundredthsKm / 100, hundredthsKm % 100, (uint16_t)value);
+     oledC_DrawString(complication->left, complication->top, 1, 1, (uint8_t *)text, OLEDC_COLOR_WHITE);
+ }
+ 
+ // Alternates between the two frames every second while walking
+ static uint32_t footSource(void) {
+     if (displayedStepPace <= 0)
+         return 0;
+     return showFootIcon ? 1 : 2;
+ }
+ 
+ static void footRender(const Complication *complication, uint32_t value) {
+     if (value != 0)
+         renderFootIcon(complication->left, complication->top,
+                        value == 1 ? FOOT_ICON_1 : FOOT_ICON_2, 16, 16);
+ }
+ 
+ static uint32_t moveSource(void) {
+     return faceOverlay;
+ }
+ 
+ static void moveRender(const Complication *complication, uint32_t value) {
+     static const char *const TEXT[] = {"", "Time to move!", "Alarm!", "Time's up!"};
+     if (value == FACE_OVERLAY_NONE)
+         return;
+     oledC_DrawRectangle(complication->left, complication->top, complication->right,
+                         complication->bottom, OLEDC_COLOR_DARKRED);
+     oledC_DrawString(6, 26, 1, 1, (uint8_t *)TEXT[value], OLEDC_COLOR_WHITE);
+ }
+ 
+ // Text of scale 2 drawn at y covers y + 2 to y + 17
+ static const Complication TIME_COMPLICATION = {
+     8, 45, 71, 62, COMPLICATION_PER_MINUTE, timeSource, timeRender
+ };
+ static const Complication SECONDS_COMPLICATION = {
+     72, 45, 95, 62, COMPLICATION_PER_SECOND, secondsSource, secondsRender
+ };
+ static const Complication MERIDIEM_COMPLICATION = {
+     0, 85, 20, 93, COMPLICATION_PER_MINUTE, meridiemSource, meridiemRender
+ };
+ static const Complication DATE_COMPLICATION = {
+     65, 85, 95, 93, COMPLICATION_PER_MINUTE, dateSource, dateRender
+ };
+ static const Complication PACE_COMPLICATION = {
+     25, 2, 60, 10, COMPLICATION_PER_SECOND, paceSource, paceRender
+ };
+ static const Complication ACTIVITY_COMPLICATION = {
+     66, 2, 95, 10, COMPLICATION_ON_EVENT, activitySource, activityRender
+ };
+ static const Complication FITNESS_COMPLICATION = {
+     0, 70, 95, 78, COMPLICATION_ON_EVENT, fitnessSource, fitnessRender
+ };
+ static const Complication FOOT_COMPLICATION = {
+     0, 0, 15, 15, COMPLICATION_PER_SECOND, footSource, footRender
+ };
+ static const Complication MOVE_COMPLICATION = {
+     0, 22, 95, 38, COMPLICATION_ON_EVENT, moveSource, moveRender
+ };
+ 
+ static void addFaceComplications(void) {
+     complicationsAdd(&TIME_COMPLICATION);
+     complicationsAdd(&SECONDS_COMPLICATION);
+     complicationsAdd(&MERIDIEM_COMPLICATION);
+     complicationsAdd(&DATE_COMPLICATION);
+     complicationsAdd(&PACE_COMPLICATION);
+     activityComplication = complicationsAdd(&ACTIVITY_COMPLICATION);
+     fitnessComplication = complicationsAdd(&FITNESS_COMPLICATION);
+     complicationsAdd(&FOOT_COMPLICATION);
+     moveComplication = complicationsAdd(&MOVE_COMPLICATION);
  }
  
  // Manages the time format selection menu
@@ -351,16 +641,17 @@
      renderTimeFormatMenu();
  
      while (inTimeFormatMenu) {
+         taskSupervisorCheckIn(TASK_UI_PAGE);
          bool button1Pressed = (PORTAbits.RA11 == 0);
          bool button2Pressed = (PORTAbits.RA12 == 0);
  
          if (button2Pressed) {
-             while (PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+             while (PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
              timeFormatOption = (timeFormatOption + 1) % 2;
              renderTimeFormatMenu();
              DELAY_milliseconds(50);
          } else if (button1Pressed) {
-             while (PORTAbits.RA11 == 0) DELAY_milliseconds(10);
+             while (PORTAbits.RA11 == 0) taskSupervisorIdleDelay(10);
              use12HourFormat = (timeFormatOption == 0);
              inTimeFormatMenu = false;
              DELAY_milliseconds(50);
@@ -417,12 +708,12 @@
      bool button2Pressed = (PORTAbits.RA12 == 0);
  
      if (button1Pressed && button2Pressed) {
-         while (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+         while (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
          timeFieldSelected = !timeFieldSelected;
          renderTimeSetMenu();
          DELAY_milliseconds(50);
      } else if (button1Pressed) {
-         while (PORTAbits.RA11 == 0) DELAY_milliseconds(10);
+         while (PORTAbits.RA11 == 0) taskSupervisorIdleDelay(10);
          if (timeFieldSelected == 0)
              timeToSet.hours = (timeToSet.hours + 1) % 24;
          else
@@ -430,7 +721,7 @@
          displayTimeSetValues();
          DELAY_milliseconds(50);
      } else if (button2Pressed) {
-         while (PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+         while (PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
          if (timeFieldSelected == 0)
              timeToSet.hours = (timeToSet.hours == 0) ? 23 : timeToSet.hours - 1;
          else
@@ -443,9 +734,8 @@
  // Checks if the device is tilted to save settings
  bool checkTiltToSave(void) {
      AccelerometerData accel;
-     accel.x = readAccelerometerAxis(REG_DATA_X0);
-     accel.y = readAccelerometerAxis(REG_DATA_Y0);
-     accel.z = readAccelerometerAxis(REG_DATA_Z0);
+     if (!readLatestAccelerometer(&accel))
+         return false;
  
      const float TILT_THRESHOLD = 600.0f;
      float ax = accel.x * 4.0f;
@@ -465,10 +755,11 @@
  
      renderTimeSetMenu();
  
-     while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+     while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
  
      int tiltCount = 0;
      while (inTimeSetMenu) {
+         taskSupervisorCheckIn(TASK_UI_PAGE);
          processTimeSetInput();
          if (checkTiltToSave()) {
              tiltCount++;
@@ -476,6 +767,9 @@
                  systemClock.hours = timeToSet.hours;
                  systemClock.minutes = timeToSet.minutes;
                  systemClock.seconds = 0;
+                 // A clock set back must not look like the alarm time passing
+                 if (alarmSchedulerPending(alarmClockTimer))
+                     armAlarmClock();
                  inTimeSetMenu = false;
                  break;
              }
@@ -524,12 +818,12 @@
      bool button2Pressed = (PORTAbits.RA12 == 0);
  
      if (button1Pressed && button2Pressed) {
-         while (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+         while (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
          dateFieldSelected = !dateFieldSelected;
          renderDateSetMenu();
          DELAY_milliseconds(50);
      } else if (button1Pressed) {
-         while (PORTAbits.RA11 == 0) DELAY_milliseconds(10);
+         while (PORTAbits.RA11 == 0) taskSupervisorIdleDelay(10);
          if (dateFieldSelected == 0) {
              uint8_t maxDay = DAYS_PER_MONTH[dateToSet.month - 1];
              dateToSet.day = (dateToSet.day % maxDay) + 1;
@@ -542,7 +836,7 @@
          displayDateSetValues();
          DELAY_milliseconds(50);
      } else if (button2Pressed) {
-         while (PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+         while (PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
          if (dateFieldSelected == 0) {
              if (dateToSet.day == 1)
                  dateToSet.day = DAYS_PER_MONTH[dateToSet.month - 1];
@@ -571,10 +865,11 @@
  
      renderDateSetMenu();
  
-     while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+     while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
  
      int tiltCount = 0;
      while (inTimeSetMenu) {
+         taskSupervisorCheckIn(TASK_UI_PAGE);
          processDateSetInput();
          if (checkTiltToSave()) {
              tiltCount++;
@@ -591,6 +886,124 @@
      }
  }
  
+ // Alarm page fields: alarm hours, alarm minutes, countdown minutes
+ static const uint8_t ALARM_FIELD_LEFT[3] = {36, 66, 36};
+ static const uint8_t ALARM_FIELD_TOP[3] = {26, 26, 54};
+ 
+ // Renders the base layout for the alarm menu
+ void renderAlarmMenu(void) {
+     oledC_clearScreen();
+     oledC_DrawString(6, 2, 2, 2, (uint8_t *)"Alarms", OLEDC_COLOR_WHITE);
+     oledC_DrawString(4, 33, 1, 1, (uint8_t *)"Alarm", OLEDC_COLOR_WHITE);
+     oledC_DrawString(4, 61, 1, 1, (uint8_t *)"Timer", OLEDC_COLOR_WHITE);
+     oledC_DrawString(66, 61, 1, 1, (uint8_t *)"min", OLEDC_COLOR_WHITE);
+     oledC_DrawString(4, 84, 1, 1, (uint8_t *)"Tilt to save", OLEDC_COLOR_WHITE);
+ 
+     for (uint8_t i = 0; i < 3; i++) {
+         uint8_t left = ALARM_FIELD_LEFT[i];
+         uint8_t top = ALARM_FIELD_TOP[i];
+         oledC_DrawRectangle(left, top, left + 26, top + 22,
+                             i == alarmFieldSelected ? OLEDC_COLOR_WHITE : OLEDC_COLOR_BLACK);
+         oledC_DrawRectangle(left + 2, top + 2, left + 24, top + 20, OLEDC_COLOR_BLACK);
+     }
+ 
+     displayAlarmValues();
+ }
+ 
+ // Displays the current values in the alarm menu; "--" is off
+ void displayAlarmValues(void) {
+     char buffer[3];
+     uint8_t values[3] = {alarmToSet.hours, alarmToSet.minutes, countdownToSet};
+     bool off[3] = {alarmToSet.hours == ALARM_OFF_HOUR, false, countdownToSet == 0};
+ 
+     for (uint8_t i = 0; i < 3; i++) {
+         uint8_t left = ALARM_FIELD_LEFT[i] + 2;
+         uint8_t top = ALARM_FIELD_TOP[i] + 2;
+         oledC_DrawRectangle(left, top, left + 22, top + 18, OLEDC_COLOR_BLACK);
+         if (off[i])
+             strcpy(buffer, "--");
+         else
+             sprintf(buffer, "%02d", values[i]);
+         oledC_DrawString(left, top, 2, 2, (uint8_t *)buffer, OLEDC_COLOR_WHITE);
+     }
+ }
+ 
+ // Processes user input for the alarm menu
+ void processAlarmInput(void) {
+     bool button1Pressed = (PORTAbits.RA11 == 0);
+     bool button2Pressed = (PORTAbits.RA12 == 0);
+ 
+     if (button1Pressed && button2Pressed) {
+         while (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
+         alarmFieldSelected = (alarmFieldSelected + 1) % 3;
+         renderAlarmMenu();
+         DELAY_milliseconds(50);
+     } else if (button1Pressed) {
+         while (PORTAbits.RA11 == 0) taskSupervisorIdleDelay(10);
+         if (alarmFieldSelected == 0)
+             alarmToSet.hours = (alarmToSet.hours + 1) % (ALARM_OFF_HOUR + 1);
+         else if (alarmFieldSelected == 1)
+             alarmToSet.minutes = (alarmToSet.minutes + 1) % 60;
+         else
+             countdownToSet = (countdownToSet + 1) % (COUNTDOWN_MAX_MINUTES + 1);
+         displayAlarmValues();
+         DELAY_milliseconds(50);
+     } else if (button2Pressed) {
+         while (PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
+         if (alarmFieldSelected == 0)
+             alarmToSet.hours = (alarmToSet.hours == 0) ? ALARM_OFF_HOUR : alarmToSet.hours - 1;
+         else if (alarmFieldSelected == 1)
+             alarmToSet.minutes = (alarmToSet.minutes == 0) ? 59 : alarmToSet.minutes - 1;
+         else
+             countdownToSet = (countdownToSet == 0) ? COUNTDOWN_MAX_MINUTES : countdownToSet - 1;
+         displayAlarmValues();
+         DELAY_milliseconds(50);
+     }
+ }
+ 
+ // Manages the alarm page: a daily alarm and a countdown in minutes. Only
+ // the settings that were changed are applied, so a running countdown is
+ // not restarted by saving the alarm.
+ void manageAlarmPage(void) {
+     uint32_t remaining = alarmSchedulerRemaining(countdownTimer);
+ 
+     alarmToSet.hours = alarmSchedulerPending(alarmClockTimer) ? alarmTime.hours : ALARM_OFF_HOUR;
+     alarmToSet.minutes = alarmTime.minutes;
+     countdownToSet = (remaining + 59) / 60 > COUNTDOWN_MAX_MINUTES
+                    ? COUNTDOWN_MAX_MINUTES : (remaining + 59) / 60;
+     alarmFieldSelected = 0;
+ 
+     TimeSetting initialAlarm = alarmToSet;
+     uint8_t initialCountdown = countdownToSet;
+ 
+     renderAlarmMenu();
+ 
+     while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
+ 
+     while (true) {
+         taskSupervisorCheckIn(TASK_UI_PAGE);
+         processAlarmInput();
+         if (checkTiltToSave())
+             break;
+         DELAY_milliseconds(20);
+     }
+ 
+     if (alarmToSet.hours != initialAlarm.hours || alarmToSet.minutes != initialAlarm.minutes) {
+         if (alarmToSet.hours == ALARM_OFF_HOUR) {
+             alarmSchedulerCancel(alarmClockTimer);
+         } else {
+             alarmTime = alarmToSet;
+             armAlarmClock();
+         }
+     }
+     if (countdownToSet != initialCountdown) {
+         if (countdownToSet == 0)
+             alarmSchedulerCancel(countdownTimer);
+         else
+             alarmSchedulerStart(countdownTimer, countdownToSet * 60UL);
+     }
+ }
+ 
  // Displays the step rate graph
  void displayStepGraph(void) {
      isGraphDisplayed = true;
@@ -633,11 +1046,12 @@
  
      static uint8_t button1HoldCount = 0;
      while (graphModeActive) {
+         taskSupervisorCheckIn(TASK_UI_PAGE);
          bool button1Pressed = (PORTAbits.RA11 == 0);
          bool button2Pressed = (PORTAbits.RA12 == 0);
  
          if (button2Pressed) {
-             while (PORTAbits.RA12 == 0) DELAY_milliseconds(10);
+             while (PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
              graphModeActive = false;
              inMainMenu = true;
              renderMainMenu();
@@ -650,7 +1064,7 @@
                  oledC_clearScreen();
                  graphModeActive = false;
                  inMainMenu = false;
-                 redrawClock = true;
+                 complicationsInvalidateAll();
                  DELAY_milliseconds(50);
                  break;
              }
@@ -664,9 +1078,53 @@
      isGraphDisplayed = false;
  }
  
+ // Sleep tracking mode: the panel sleeps and the CPU idles between the 1 Hz
+ // tick and the accelerometer's FIFO watermark interrupt. Any button exits
+ // to the clock face.
+ void manageSleepMode(void) {
+     uint8_t lastMinute = systemClock.minutes;
+     uint32_t epochStart = historyTimestamp(systemClock.month, systemClock.day,
+                                            systemClock.hours, systemClock.minutes);
+
+     oledC_clearScreen();
+     if (!sleepTrackerStart()) {
+         sleepTrackerStop();
+         oledC_DrawString(10, 40, 1, 1, (uint8_t *)"Accel Error", OLEDC_COLOR_DARKRED);
+         DELAY_milliseconds(1000);
+         renderMainMenu();
+         return;
+     }
+     oledC_DrawString(16, 40, 2, 2, (uint8_t *)"Sleep", OLEDC_COLOR_WHITE);
+     while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
+     DELAY_milliseconds(1000);
+     oledC_setSleepMode(true);
+
+     while (PORTAbits.RA11 != 0 && PORTAbits.RA12 != 0) {
+         Idle();
+         taskSupervisorCheckIn(TASK_UI_PAGE);
+         oledC_sampleRenderStats(currentTicks());
+         sleepTrackerService();
+         serviceUserAlarms();
+         if (systemClock.minutes != lastMinute) {
+             lastMinute = systemClock.minutes;
+             sleepTrackerEndEpoch(epochStart);
+             epochStart = historyTimestamp(systemClock.month, systemClock.day,
+                                           systemClock.hours, systemClock.minutes);
+         }
+     }
+
+     while (PORTAbits.RA11 == 0 || PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
+     sleepTrackerStop();
+     oledC_setSleepMode(false);
+     inMainMenu = false;
+     complicationsInvalidateAll();
+     oledC_clearScreen();
+ }
+ 
  // Menu System
  static const char *MENU_OPTIONS[MENU_ITEM_COUNT] = {
-     "PedometerGraph", "12H/24H", "Set Time", "Set Date", "Exit"
+     "PedometerGraph", "12H/24H", "Set Time", "Set Date", "Alarms", "Sleep Mode",
+     "Diagnostics", "History", "Exit"
  };
  static uint8_t currentMenuSelection = 0;
  
@@ -674,7 +1132,7 @@
  void renderMainMenu(void) {
      oledC_clearScreen();
      for (uint8_t i = 0; i < MENU_ITEM_COUNT; i++) {
-         uint8_t yPosition = 20 + (i * 12);
+         uint8_t yPosition = 4 + (i * 9);
          oledC_DrawString(10, yPosition, 1, 1, (uint8_t *)MENU_OPTIONS[i], OLEDC_COLOR_WHITE);
          if (i == currentMenuSelection)
              oledC_DrawString(4, yPosition, 1, 1, (uint8_t *)">", OLEDC_COLOR_WHITE);
@@ -683,7 +1141,7 @@
      if (use12HourFormat) {
          uint8_t displayHours = systemClock.hours;
          bool isPM = (displayHours >= 12);
-         oledC_DrawString(0, 80, 1, 1, (uint8_t *)(isPM ? "PM" : "AM"), OLEDC_COLOR_WHITE);
+         oledC_DrawString(0, 86, 1, 1, (uint8_t *)(isPM ? "PM" : "AM"), OLEDC_COLOR_WHITE);
      }
  }
  
@@ -708,28 +1166,137 @@
      strcat(currentTimeStr, buffer);
  
      if (strcmp(previousTime, currentTimeStr) != 0) {
-         oledC_DrawRectangle(48, 80, 115, 88, OLEDC_COLOR_BLACK);
-         oledC_DrawString(48, 80, 1, 1, (uint8_t *)currentTimeStr, OLEDC_COLOR_WHITE);
+         oledC_DrawRectangle(48, 86, 115, 94, OLEDC_COLOR_BLACK);
+         oledC_DrawString(48, 86, 1, 1, (uint8_t *)currentTimeStr, OLEDC_COLOR_WHITE);
          strcpy(previousTime, currentTimeStr);
      }
  }
  
- // Executes the selected menu action
+ // Executes the selected menu action. Pages block the main loop, so only
+ // their own polling is supervised while one is open.
  void executeMenuSelection(void) {
+     uint16_t supervisedTasks = taskSupervisorSelect(TASK_BIT(TASK_UI_PAGE));
+ 
      switch (currentMenuSelection) {
          case 0: displayStepGraph(); break;
          case 1: manageTimeFormatSelection(); renderMainMenu(); updateMenuTimeDisplay(); break;
          case 2: manageTimeSetPage(); renderMainMenu(); updateMenuTimeDisplay(); break;
          case 3: manageDateSetPage(); renderMainMenu(); updateMenuTimeDisplay(); break;
-         case 4: inMainMenu = false; redrawClock = true; oledC_clearScreen(); break;
+         case 4: manageAlarmPage(); renderMainMenu(); updateMenuTimeDisplay(); break;
+         case 5: manageSleepMode(); break;
+         case 6: diagnosticsRun(currentTicks); renderMainMenu(); updateMenuTimeDisplay(); break;
+         case 7:
+             historyBrowserRun(historyTimestamp(systemClock.month, systemClock.day, 0, 0));
+             renderMainMenu();
+             updateMenuTimeDisplay();
+             break;
+         case 8: inMainMenu = false; complicationsInvalidateAll(); oledC_clearScreen(); break;
          default: break;
      }
+     taskSupervisorSelect(supervisedTasks);
+ }
+ 
+ // Applies one input event to the main menu
+ void handleMenuEvent(InputEvent event) {
+     switch (event) {
+         case INPUT_EVENT_BUTTON1:
+             if (currentMenuSelection == 0)
+                 currentMenuSelection = MENU_ITEM_COUNT - 1;
+             else
+                 currentMenuSelection--;
+             renderMainMenu();
+             break;
+         case INPUT_EVENT_BUTTON2:
+         case INPUT_EVENT_TAP:
+             if (currentMenuSelection == MENU_ITEM_COUNT - 1)
+                 currentMenuSelection = 0;
+             else
+                 currentMenuSelection++;
+             renderMainMenu();
+             break;
+         case INPUT_EVENT_BUTTON_BOTH:
+         case INPUT_EVENT_DOUBLE_TAP:
+             executeMenuSelection();
+             // Sub-pages read the buttons directly; drop what queued meanwhile
+             inputEventFlush();
+             break;
+         default:
+             break;
+     }
+ }
+ 
+ // Handles input events on the clock face; returns true if the menu was opened
+ bool handleClockFaceEvents(void) {
+     InputEvent event;
+     while (inputEventPop(&event)) {
+         if (event == INPUT_EVENT_DOUBLE_TAP) {
+             inputEventFlush();
+             inMainMenu = true;
+             currentMenuSelection = 0;
+             renderMainMenu();
+             return true;
+         }
+     }
+     return false;
+ }
+ 
+ // The main loop applies the profile on its next pass, and only then talks
+ // to the panel
+ static void requestPanelProfile(OLEDC_PANEL_PROFILE profile) {
+     if (profile != wantedPanelProfile) {
+         wantedPanelProfile = profile;
+         panelProfilePending = true;
+     }
+ }
+ 
+ // Saves steps, clock and fitness totals. Runs from interrupts, so it must
+ // stay short and non-blocking.
+ static void saveSnapshot(void) {
+     WatchSnapshot snapshot;
+     snapshot.totalSteps = totalSteps;
+     snapshot.hours = systemClock.hours;
+     snapshot.minutes = systemClock.minutes;
+     snapshot.seconds = systemClock.seconds;
+     snapshot.day = systemClock.day;
+     snapshot.month = systemClock.month;
+     snapshot.distanceMm = fitnessDistanceMm();
+     snapshot.energyCal = fitnessEnergyCal();
+     snapshotStoreSave(&snapshot);
+ }
+ 
+ // Saves the state before brown-out and powers the display down; runs from
+ // the HLVD interrupt
+ static void handlePowerLoss(void) {
+     saveSnapshot();
+     oledC_shutdown();
+ }
+ 
+ // The watchdog is about to reset a stuck watch: keep what a reboot would
+ // lose. Runs from the Timer1 interrupt.
+ static void handleImminentReset(void) {
+     saveSnapshot();
+ }
+ 
+ // Restores the state saved before the last power loss, once
+ static void restoreSnapshot(void) {
+     WatchSnapshot snapshot;
+     snapshotStoreInit();
+     if (!snapshotStoreLoad(&snapshot))
+         return;
+     totalSteps = snapshot.totalSteps;
+     systemClock.hours = snapshot.hours;
+     systemClock.minutes = snapshot.minutes;
+     systemClock.seconds = snapshot.seconds;
+     systemClock.day = snapshot.day;
+     systemClock.month = snapshot.month;
+     fitnessEstimatorRestore(snapshot.distanceMm, snapshot.energyCal);
+     snapshotStoreConsume();
  }
  
  // Initializes the timer for periodic updates
  void initializeTimer(void) {
      TMR1 = 0;
-     PR1 = 15625;
+     PR1 = TIMER1_TICKS_PER_SECOND;
      T1CONbits.TCKPS = 3;
      T1CONbits.TCS = 0;
      T1CONbits.TGATE = 0;
@@ -760,12 +1327,13 @@
      BUTTON2_TRIS = 1;
      LED1_TRIS = 0;
      LED2_TRIS = 0;
-     LED1_PORT = 0;
-     LED2_PORT = 0;
+     ledPatternInit();
  }
  
  // Timer1 interrupt handler for timekeeping and step updates
  void __attribute__((__interrupt__, auto_psv)) _T1Interrupt(void) {
+     latencyMonitorTimer1Entry();
+     taskSupervisorSecondTick();
      incrementSystemTime(&systemClock);
      elapsedSeconds++;
      showFootIcon = !showFootIcon;
@@ -792,21 +1360,11 @@
          stepsPerSecond[currentSecondIndex] = 0;
  
          static uint16_t previousStepCount = 0;
-         static uint8_t inactivityCount = 0;
  
          uint16_t stepsThisSecond = totalSteps - previousStepCount;
          previousStepCount = totalSteps;
  
-         float rawPace = (float)stepsThisSecond * 60.0f;
- 
-         if (stepsThisSecond == 0) {
-             inactivityCount++;
-             if (inactivityCount >= 3) rawPace = 0.0f;
-         } else {
-             inactivityCount = 0;
-         }
- 
-         currentStepPace = rawPace;
+         currentStepPace = (float)stepsThisSecond * 60.0f;
      }
  
      IFS0bits.T1IF = 0;
@@ -814,32 +1372,84 @@
  
  // Main application entry point
  int main(void) {
-     int status;
-     uint8_t deviceId = 0;
      SYSTEM_Initialize();
      initializeHardware();
+     restoreSnapshot();
+     historyStoreInit();
+     historyExportInit();
+     powerMonitorSetEmergencyHandler(handlePowerLoss);
+     powerMonitorInit();
      oledC_setBackground(OLEDC_COLOR_BLACK);
      oledC_clearScreen();
      i2c1_open();
- 
-     for (int i = 0; i < 3; i++) {
-         status = i2cReadSlaveRegister(ACCEL_WRITE_ADDR, 0x00, &deviceId);
-         if (status == OK && deviceId == 0xE5) break;
-         if (i == 2) haltWithError("I2C Error or Wrong Device ID");
-         DELAY_milliseconds(10);
-     }
+     i2cSchedulerInit();
+ 
+     RTCC_Initialize();
+     alarmSchedulerInit();
+     overlayTimer = alarmSchedulerAdd();
+     alarmClockTimer = alarmSchedulerAdd();
+     countdownTimer = alarmSchedulerAdd();
+     latencyMonitorSetBudget(LATENCY_TIMER1, TIMER1_LATENCY_BUDGET_US);
+     latencyMonitorSetBudget(LATENCY_ACCEL_INT, ACCEL_INT_LATENCY_BUDGET_US);
+     latencyMonitorInit();
+     samplingMonitorInit(STEP_SAMPLE_INTERVAL_TICKS, STEP_SAMPLE_TOLERANCE_TICKS, ACCEL_FIFO_DEPTH);
      initializeAccelerometer();
      initializeTimer();
      configureTimerInterrupt();
+     taskSupervisorInit(currentTicks);
+     taskSupervisorSetResetHandler(handleImminentReset);
+     taskSupervisorAdd(TASK_MAIN_LOOP, MAIN_LOOP_PERIOD_TICKS, 0, true);
+     taskSupervisorAdd(TASK_ACCEL_EVENTS, MAIN_LOOP_PERIOD_TICKS, ACCEL_EVENTS_BUDGET_TICKS, true);
+     taskSupervisorAdd(TASK_I2C_SCHEDULER, MAIN_LOOP_PERIOD_TICKS, I2C_SCHEDULER_BUDGET_TICKS, true);
+     taskSupervisorAdd(TASK_HISTORY_EXPORT, MAIN_LOOP_PERIOD_TICKS, HISTORY_EXPORT_BUDGET_TICKS, true);
+     taskSupervisorAdd(TASK_CLOCK_FACE, MAIN_LOOP_PERIOD_TICKS, CLOCK_FACE_BUDGET_TICKS, !inMainMenu);
+     taskSupervisorAdd(TASK_UI_PAGE, UI_PAGE_PERIOD_TICKS, 0, false);
+     addFaceComplications();
  
      static bool wasInMenu = false;
-     LED1_PORT = 0;
-     LED2_PORT = 0;
+     uint32_t lastSupplySample = 0;
+     DateSetting trackedDate = {systemClock.day, systemClock.month};
+ 
+     requestPanelProfile(powerMonitorIsLow() ? OLEDC_PANEL_LOW_POWER : OLEDC_PANEL_BALANCED);
  
      while (1) {
          bool button1Pressed = (PORTAbits.RA11 == 0);
          bool button2Pressed = (PORTAbits.RA12 == 0);
  
+         taskSupervisorCheckIn(TASK_MAIN_LOOP);
+         if (taskSupervisorTakeAverted())
+             snapshotStoreConsume();     // saved for a reset that never came
+         taskSupervisorSetActive(TASK_CLOCK_FACE, !inMainMenu);
+         oledC_sampleRenderStats(currentTicks());
+ 
+         if (elapsedSeconds - lastSupplySample >= SUPPLY_SAMPLE_PERIOD) {
+             powerMonitorSample();
+             lastSupplySample = elapsedSeconds;
+             requestPanelProfile(powerMonitorIsLow() ? OLEDC_PANEL_LOW_POWER : OLEDC_PANEL_BALANCED);
+         }
+         // Retried on later passes while another client holds the bus
+         if (panelProfilePending)
+             panelProfilePending = !oledC_setPanelProfile(wantedPanelProfile);
+ 
+         taskSupervisorBegin(TASK_ACCEL_EVENTS);
+         serviceAccelerometerEvents();
+         taskSupervisorEnd(TASK_ACCEL_EVENTS);
+         taskSupervisorBegin(TASK_I2C_SCHEDULER);
+         i2cSchedulerService(currentTicks());
+         taskSupervisorEnd(TASK_I2C_SCHEDULER);
+         taskSupervisorBegin(TASK_HISTORY_EXPORT);
+         historyExportService(currentTicks());
+         taskSupervisorEnd(TASK_HISTORY_EXPORT);
+         logStepMinute();
+         serviceUserAlarms();
+ 
+         if (systemClock.day != trackedDate.day || systemClock.month != trackedDate.month) {
+             fitnessEstimatorCloseDay(historyTimestamp(trackedDate.month, trackedDate.day, 0, 0));
+             complicationsInvalidate(fitnessComplication);
+             trackedDate.day = systemClock.day;
+             trackedDate.month = systemClock.month;
+         }
+ 
          if (inMainMenu) {
              static bool button1WasPressed = false;
              static bool button2WasPressed = false;
@@ -854,12 +1464,12 @@
                  if (button1Pressed && button2Pressed) {
                      comboPressCount++;
                      if (comboPressCount >= 3) {
-                         LED1_PORT = 1;
-                         LED2_PORT = 1;
-                         while (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0) DELAY_milliseconds(10);
-                         LED1_PORT = 0;
-                         LED2_PORT = 0;
-                         executeMenuSelection();
+                         ledPatternSet(LED_1, true);
+                         ledPatternSet(LED_2, true);
+                         while (PORTAbits.RA11 == 0 && PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
+                         ledPatternSet(LED_1, false);
+                         ledPatternSet(LED_2, false);
+                         inputEventPost(INPUT_EVENT_BUTTON_BOTH);
                          DELAY_milliseconds(50);
                          comboPressCount = 0;
                          button1WasPressed = true;
@@ -868,28 +1478,20 @@
                  } else {
                      comboPressCount = 0;
                      if (button1Pressed && !button1WasPressed) {
-                         LED1_PORT = 1;
-                         while (PORTAbits.RA11 == 0) DELAY_milliseconds(10);
-                         LED1_PORT = 0;
-                         if (currentMenuSelection == 0)
-                             currentMenuSelection = MENU_ITEM_COUNT - 1;
-                         else
-                             currentMenuSelection--;
-                         renderMainMenu();
+                         ledPatternSet(LED_1, true);
+                         while (PORTAbits.RA11 == 0) taskSupervisorIdleDelay(10);
+                         ledPatternSet(LED_1, false);
+                         inputEventPost(INPUT_EVENT_BUTTON1);
                          DELAY_milliseconds(50);
                          button1WasPressed = true;
                      } else if (!button1Pressed) {
                          button1WasPressed = false;
                      }
                      if (button2Pressed && !button2WasPressed) {
-                         LED2_PORT = 1;
-                         while (PORTAbits.RA12 == 0) DELAY_milliseconds(10);
-                         LED2_PORT = 0;
-                         if (currentMenuSelection == MENU_ITEM_COUNT - 1)
-                             currentMenuSelection = 0;
-                         else
-                             currentMenuSelection++;
-                         renderMainMenu();
+                         ledPatternSet(LED_2, true);
+                         while (PORTAbits.RA12 == 0) taskSupervisorIdleDelay(10);
+                         ledPatternSet(LED_2, false);
+                         inputEventPost(INPUT_EVENT_BUTTON2);
                          DELAY_milliseconds(50);
                          button2WasPressed = true;
                      } else if (!button2Pressed) {
@@ -897,18 +1499,31 @@
                      }
                  }
                  if (!button1Pressed && !button2Pressed) {
-                     LED1_PORT = 0;
-                     LED2_PORT = 0;
+                     ledPatternSet(LED_1, false);
+                     ledPatternSet(LED_2, false);
                  }
-                 updateMenuTimeDisplay();
+ 
+                 InputEvent event;
+                 while (inMainMenu && inputEventPop(&event))
+                     handleMenuEvent(event);
+                 if (inMainMenu)
+                     updateMenuTimeDisplay();
              }
              wasInMenu = true;
          } else {
-             LED1_PORT = button1Pressed ? 1 : 0;
-             LED2_PORT = button2Pressed ? 1 : 0;
+             ledPatternSet(LED_1, button1Pressed);
+             ledPatternSet(LED_2, button2Pressed);
+ 
+             if (handleClockFaceEvents()) {
+                 DELAY_milliseconds(20);
+                 continue;
+             }
  
+             taskSupervisorBegin(TASK_CLOCK_FACE);
              if (wasInMenu) {
-                 oledC_DrawRectangle(0, 80, 115, 88, OLEDC_COLOR_BLACK);
+                 oledC_DrawRectangle(0, 86, 115, 94, OLEDC_COLOR_BLACK);
+                 complicationsInvalidateAll();
+                 samplingMonitorRestart();
                  wasInMenu = false;
              }
  
@@ -930,11 +1545,9 @@
  
              stepRateHistory[elapsedSeconds % GRAPH_WIDTH] = (uint8_t)displayedStepPace;
  
-             displayStepPace();
-             renderClockDisplay(&systemClock);
-             oledC_DrawRectangle(0, 0, 15, 15, OLEDC_COLOR_BLACK);
-             if (displayedStepPace > 0)
-                 renderFootIcon(0, 0, showFootIcon ? FOOT_ICON_1 : FOOT_ICON_2, 16, 16);
+             updateMoveReminder();
+             complicationsService(elapsedSeconds, systemClock.seconds);
+             taskSupervisorEnd(TASK_CLOCK_FACE);
          }
  
          DELAY_milliseconds(20);
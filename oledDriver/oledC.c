@@ -22,21 +22,97 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include "../spiDriver/spi1_driver.h"
+#include <stddef.h>
+#include <string.h>
+#include "../spiDriver/spi1_transaction.h"
 #include "oledC.h"
+#include "oledC_litMap.h"
 #include "pin_manager.h"
 #include "../system/delay.h"
 
-enum STREAMING_MODES 
+static void selectPanel(bool active);
+static void setPanelDataMode(bool data);
+static void addWindow(spi1_transaction_t *transaction, uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y);
+static uint16_t background_color;
+static OLEDC_PANEL_PROFILE panel_profile = OLEDC_PANEL_PROFILE_COUNT; /* none applied */
+
+/* Where streamed pixels land: the last window set and the next pixel in it */
+static struct
+{
+    uint8_t start_x, start_y, end_x, end_y;
+    uint8_t x, y;
+} stream_window = { 0, 0, 95, 95, 0, 0 };
+
+static struct
+{
+    bool asleep;
+    uint16_t peakLitPermille;
+    uint32_t pixelsWritten;
+    uint32_t fills;
+    uint32_t lastSample;
+    uint32_t sampledTicks;
+    uint64_t litTicks;              /* permille x ticks */
+    uint16_t heldLit;               /* at the last sample */
+    bool sampled;
+} render_stats;
+
+static const spi1_client_t oledC_client = { selectPanel, setPanelDataMode };
+
+/* Each profile sets every timing register, so switching never depends on
+ * the previous one. Frame rate is Fosc / (divider * (phase 1 + phase 2 +
+ * 50 DCLKs) * 128 rows): the low-power clock is slower and divided by 4
+ * with longer phases, well under half the balanced refresh, and its
+ * lower precharge, VCOMH and master current cut the drive current. The
+ * mux ratio stays at 128 in every profile: the start line of 0x20 set by
+ * oledC_setDisplayOrientation places the 96 visible rows in a 128-row
+ * scan. Balanced is the SSD1351 reset timing the watch has always run. */
+static const uint8_t PANEL_PERFORMANCE[] =
 {
-    NOSTREAM, WRITESTREAM, READSTREAM
+    OLEDC_CMD_SET_COMMAND_LOCK, 1, 0x12,
+    OLEDC_CMD_SET_COMMAND_LOCK, 1, 0xB1,                    /* unlock B1, B3, BB, BE */
+    OLEDC_CMD_SET_FRONT_CLOCK_DIVIDER_OSC_FREQ, 1, 0xF1,    /* fastest oscillator, /2 */
+    OLEDC_CMD_SET_PHASE_LENGTH, 1, 0x32,                    /* 5 + 3 DCLKs */
+    OLEDC_CMD_SET_PRECHARGE_VOLTAGE, 1, 0x17,
+    OLEDC_CMD_SET_SECOND_PRECHARGE_PERIOD, 1, 0x01,
+    OLEDC_CMD_SET_VCOMH_VOLTAGE, 1, 0x05,                   /* 0.82 x VCC */
+    OLEDC_CMD_MASTER_CONTRAST_CURRENT_CONTROL, 1, 0x0F,
+    OLEDC_CMD_SET_MUX_RATIO, 1, 0x7F
 };
-static uint8_t streamingMode = NOSTREAM;
 
-static void startStreamingIfNeeded(OLEDC_COMMAND cmd);
-static void stopStreaming(void);
-static uint16_t exchangeTwoBytes(uint8_t byte1, uint8_t byte2);
-static uint16_t background_color;
+static const uint8_t PANEL_BALANCED[] =
+{
+    OLEDC_CMD_SET_COMMAND_LOCK, 1, 0x12,
+    OLEDC_CMD_SET_COMMAND_LOCK, 1, 0xB1,
+    OLEDC_CMD_SET_FRONT_CLOCK_DIVIDER_OSC_FREQ, 1, 0xD1,
+    OLEDC_CMD_SET_PHASE_LENGTH, 1, 0x82,                    /* 5 + 8 DCLKs */
+    OLEDC_CMD_SET_PRECHARGE_VOLTAGE, 1, 0x17,
+    OLEDC_CMD_SET_SECOND_PRECHARGE_PERIOD, 1, 0x08,
+    OLEDC_CMD_SET_VCOMH_VOLTAGE, 1, 0x05,
+    OLEDC_CMD_MASTER_CONTRAST_CURRENT_CONTROL, 1, 0x0F,
+    OLEDC_CMD_SET_MUX_RATIO, 1, 0x7F
+};
+
+static const uint8_t PANEL_LOW_POWER[] =
+{
+    OLEDC_CMD_SET_COMMAND_LOCK, 1, 0x12,
+    OLEDC_CMD_SET_COMMAND_LOCK, 1, 0xB1,
+    OLEDC_CMD_SET_FRONT_CLOCK_DIVIDER_OSC_FREQ, 1, 0xB2,    /* slower oscillator, /4 */
+    OLEDC_CMD_SET_PHASE_LENGTH, 1, 0xF4,                    /* 9 + 15 DCLKs */
+    OLEDC_CMD_SET_PRECHARGE_VOLTAGE, 1, 0x0B,
+    OLEDC_CMD_SET_SECOND_PRECHARGE_PERIOD, 1, 0x04,
+    OLEDC_CMD_SET_VCOMH_VOLTAGE, 1, 0x00,                   /* 0.72 x VCC */
+    OLEDC_CMD_MASTER_CONTRAST_CURRENT_CONTROL, 1, 0x08,     /* 9/16 of full current */
+    OLEDC_CMD_SET_MUX_RATIO, 1, 0x7F
+};
+
+static const uint8_t *const panel_profiles[OLEDC_PANEL_PROFILE_COUNT] =
+{
+    PANEL_PERFORMANCE, PANEL_BALANCED, PANEL_LOW_POWER
+};
+static const uint8_t panel_profile_sizes[OLEDC_PANEL_PROFILE_COUNT] =
+{
+    sizeof(PANEL_PERFORMANCE), sizeof(PANEL_BALANCED), sizeof(PANEL_LOW_POWER)
+};
 
 oledc_color_t oledC_parseIntToRGB(uint16_t raw)
 {
@@ -61,53 +137,33 @@ uint16_t oledC_parseRGBToInt(uint8_t red, uint8_t green, uint8_t blue)
     return (((uint16_t)byte1) << 8) | byte2;
 }
 
-static void startStreamingIfNeeded(OLEDC_COMMAND cmd)
+static void selectPanel(bool active)
 {
-    if(cmd == OLEDC_CMD_WRITE_RAM || cmd == OLEDC_CMD_READ_RAM)
-    {
-        streamingMode = cmd == OLEDC_CMD_WRITE_RAM ? WRITESTREAM : READSTREAM;
-    } 
-    else 
-    {
-        streamingMode = NOSTREAM;
-    }
+    LATCbits.LATC9 = active ? 0 : 1; /* oledC_nCS is active low */
 }
 
-static void stopStreaming(void)
+static void setPanelDataMode(bool data)
 {
-    streamingMode = NOSTREAM;
+    LATCbits.LATC3 = data ? 1 : 0; /* oledC_DC high for data */
 }
 
-static uint16_t exchangeTwoBytes(uint8_t byte1, uint8_t byte2)
+static void addWindow(spi1_transaction_t *transaction, uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y)
 {
-    if(!oledC_open())
-    {
-        return 0xFFFF;
-    }
-    byte1 = spi1_exchangeByte(byte1);
-    byte2 = spi1_exchangeByte(byte2);
-    spi1_close();
-    return ((uint16_t)byte1) << 8 | byte2;
+    uint8_t payload[2];
+    payload[0] = 16 + (start_x > 95 ? 95 : start_x);
+    payload[1] = 16 + (end_x > 95 ? 95 : end_x);
+    spi1_transactionCommand(transaction, OLEDC_CMD_SET_COLUMN_ADDRESS, payload, 2);
+    payload[0] = start_y > 95 ? 95 : start_y;
+    payload[1] = end_y > 95 ? 95 : end_y;
+    spi1_transactionCommand(transaction, OLEDC_CMD_SET_ROW_ADDRESS, payload, 2);
 }
 
 void oledC_sendCommand(OLEDC_COMMAND cmd, uint8_t *payload, uint8_t payload_size)
 {
-    if(!oledC_open())
-    {
-        return;
-    }
-    LATCbits.LATC9 = 0; /* set oledC_nCS output low */
-    LATCbits.LATC3 = 0; /* set oledC_DC output low */
-    spi1_exchangeByte(cmd);
-    if(payload_size > 0)
-    {
-        LATCbits.LATC3 = 1; /* set oledC_DC output high */
-        spi1_writeBlock(payload, payload_size);
-        LATCbits.LATC3 = 0; /* set oledC_DC output low */
-    }
-    LATCbits.LATC9 = 1; /* set oledC_nCS output high */
-    spi1_close();
-    startStreamingIfNeeded(cmd);
+    spi1_transaction_t transaction;
+    spi1_transactionInit(&transaction);
+    spi1_transactionCommand(&transaction, cmd, payload, payload_size);
+    spi1_execute(&oledC_client, &transaction);
 }
 
 void oledC_setRowAddressBounds(uint8_t min, uint8_t max)
@@ -116,7 +172,8 @@ void oledC_setRowAddressBounds(uint8_t min, uint8_t max)
     payload[0] = min > 95 ? 95 : min;
     payload[1] = max > 95 ? 95 : max;
     oledC_sendCommand(OLEDC_CMD_SET_ROW_ADDRESS, payload, 2);
-    
+    stream_window.start_y = stream_window.y = payload[0];
+    stream_window.end_y = payload[1];
 }
 
 void oledC_setColumnAddressBounds(uint8_t min, uint8_t max)
@@ -127,11 +184,43 @@ void oledC_setColumnAddressBounds(uint8_t min, uint8_t max)
     payload[0] = 16+min;
     payload[1] = max + 16;
     oledC_sendCommand(OLEDC_CMD_SET_COLUMN_ADDRESS, payload, 2);
+    stream_window.start_x = stream_window.x = min;
+    stream_window.end_x = max;
+}
+
+/* Window, write-RAM and every pixel go out under one chip-select assertion */
+void oledC_fillWindow(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t color)
+{
+    spi1_transaction_t transaction;
+    uint16_t width;
+    uint16_t height;
+    start_x = start_x > 95 ? 95 : start_x;
+    start_y = start_y > 95 ? 95 : start_y;
+    end_x = end_x > 95 ? 95 : end_x;
+    end_y = end_y > 95 ? 95 : end_y;
+    if(end_x < start_x || end_y < start_y)
+    {
+        return;
+    }
+    width = end_x - start_x + 1;
+    height = end_y - start_y + 1;
+    spi1_transactionInit(&transaction);
+    addWindow(&transaction, start_x, start_y, end_x, end_y);
+    spi1_transactionCommand(&transaction, OLEDC_CMD_WRITE_RAM, NULL, 0);
+    spi1_transactionFill16(&transaction, color, width * height);
+    if(spi1_execute(&oledC_client, &transaction))
+    {
+        oledC_litMapFill(start_x, start_y, end_x, end_y, color);
+        render_stats.pixelsWritten += width * height;
+        render_stats.fills++;
+    }
 }
 
+/* The SSD1351 keeps its registers asleep, so the panel profile holds */
 void oledC_setSleepMode(bool on)
 {
     oledC_sendCommand(on ? OLEDC_CMD_SET_SLEEP_MODE_ON : OLEDC_CMD_SET_SLEEP_MODE_OFF, NULL, 0);
+    render_stats.asleep = on;
 }
 
 void oledC_setDisplayOrientation(void) 
@@ -143,11 +232,38 @@ void oledC_setDisplayOrientation(void)
     oledC_sendCommand(OLEDC_CMD_SET_DISPLAY_START_LINE, payload, 1);
 }
 
+bool oledC_setPanelProfile(OLEDC_PANEL_PROFILE profile)
+{
+    spi1_transaction_t transaction;
+    if(profile >= OLEDC_PANEL_PROFILE_COUNT)
+    {
+        return false;
+    }
+    if(profile == panel_profile)
+    {
+        return true;
+    }
+    spi1_transactionInit(&transaction);
+    spi1_transactionScript(&transaction, panel_profiles[profile], panel_profile_sizes[profile]);
+    if(!spi1_execute(&oledC_client, &transaction))
+    {
+        return false;
+    }
+    panel_profile = profile;
+    return true;
+}
+
+OLEDC_PANEL_PROFILE oledC_getPanelProfile(void)
+{
+    return panel_profile;
+}
+
 void oledC_startReadingDisplay(void)
 {
-    oledC_sendCommand(OLEDC_CMD_READ_RAM, NULL, 0);    
-    LATCbits.LATC9 = 0; /* set oledC_nCS output low */
-    LATCbits.LATC3 = 1; /* set oledC_DC output high */
+    spi1_transaction_t transaction;
+    spi1_transactionInit(&transaction);
+    spi1_transactionCommand(&transaction, OLEDC_CMD_READ_RAM, NULL, 0);
+    spi1_streamBegin(&oledC_client, &transaction, OLEDC_CMD_READ_RAM);
 }
 
 void oledC_stopReadingDisplay(void)
@@ -157,29 +273,24 @@ void oledC_stopReadingDisplay(void)
 
 uint16_t oledC_readColor(void)
 {
-    if(streamingMode != READSTREAM)
+    if(!spi1_streamIsOpen(&oledC_client, OLEDC_CMD_READ_RAM))
     {
         oledC_startReadingDisplay();
     }
-    if(streamingMode != READSTREAM)
-    {
-        return 0xFFFF;
-    }
-    return exchangeTwoBytes(0xFF, 0xFF);
+    return spi1_streamExchange16(&oledC_client, 0xFFFF);
 }
 
 void oledC_startWritingDisplay(void)
 {
-    oledC_sendCommand(OLEDC_CMD_WRITE_RAM, NULL, 0);    
-    LATCbits.LATC9 = 0; /* set oledC_nCS output low */
-    LATCbits.LATC3 = 1; /* set oledC_DC output high */
+    spi1_transaction_t transaction;
+    spi1_transactionInit(&transaction);
+    spi1_transactionCommand(&transaction, OLEDC_CMD_WRITE_RAM, NULL, 0);
+    spi1_streamBegin(&oledC_client, &transaction, OLEDC_CMD_WRITE_RAM);
 }
 
 void oledC_stopWritingDisplay(void)
 {
-    LATCbits.LATC9 = 1; /* set oledC_nCS output high */
-    LATCbits.LATC3 = 0; /* set oledC_DC output low */
-    stopStreaming();
+    spi1_streamEnd(&oledC_client);
 }
 
 void oledC_sendColor(uint8_t r, uint8_t g, uint8_t b)
@@ -189,19 +300,76 @@ void oledC_sendColor(uint8_t r, uint8_t g, uint8_t b)
 
 void oledC_sendColorInt(uint16_t raw)
 {
-    if(streamingMode != WRITESTREAM)
+    if(!spi1_streamIsOpen(&oledC_client, OLEDC_CMD_WRITE_RAM))
     {
         oledC_startWritingDisplay();
+        /* refused while another client or context holds the bus: the
+         * pixel is dropped, so neither the lit map nor the window moves */
+        if(!spi1_streamIsOpen(&oledC_client, OLEDC_CMD_WRITE_RAM))
+        {
+            return;
+        }
     }
-    if(streamingMode != WRITESTREAM)
+    spi1_streamExchange16(&oledC_client, raw);
+    oledC_litMapPixel(stream_window.x, stream_window.y, raw);
+    render_stats.pixelsWritten++;
+    if(stream_window.x < stream_window.end_x)
     {
-        return;
+        stream_window.x++;
+    }
+    else
+    {
+        stream_window.x = stream_window.start_x;
+        stream_window.y = (stream_window.y < stream_window.end_y) ? stream_window.y + 1 : stream_window.start_y;
     }
-    exchangeTwoBytes(raw >> 8, raw & 0x00FF);
+}
+
+/* Each interval is charged with the weight seen at its start; the panel
+ * shows nothing while asleep, so that time counts as unlit. Both sums are
+ * halved before the time reaches 2^31 ticks, which keeps them in range and
+ * leans the average toward the recent past. */
+void oledC_sampleRenderStats(uint32_t ticks)
+{
+    uint16_t lit = render_stats.asleep ? 0 : oledC_litMapPermille();
+    if(render_stats.sampled)
+    {
+        uint32_t elapsed = ticks - render_stats.lastSample;
+        if(render_stats.sampledTicks + elapsed >= 0x80000000UL)
+        {
+            render_stats.sampledTicks /= 2;
+            render_stats.litTicks /= 2;
+        }
+        render_stats.sampledTicks += elapsed;
+        render_stats.litTicks += (uint64_t)render_stats.heldLit * elapsed;
+    }
+    render_stats.heldLit = lit;
+    if(lit > render_stats.peakLitPermille)
+    {
+        render_stats.peakLitPermille = lit;
+    }
+    render_stats.lastSample = ticks;
+    render_stats.sampled = true;
+}
+
+void oledC_getRenderStats(oledc_render_stats_t *stats)
+{
+    stats->litPermille = render_stats.asleep ? 0 : oledC_litMapPermille();
+    stats->peakLitPermille = render_stats.peakLitPermille;
+    stats->averageLitPermille = render_stats.sampledTicks == 0 ? stats->litPermille :
+                                (uint16_t)(render_stats.litTicks / render_stats.sampledTicks);
+    stats->pixelsWritten = render_stats.pixelsWritten;
+    stats->fills = render_stats.fills;
+}
+
+void oledC_resetRenderStats(void)
+{
+    bool asleep = render_stats.asleep;
+    memset(&render_stats, 0, sizeof(render_stats));
+    render_stats.asleep = asleep;
 }
 
 bool oledC_open(void){
-    return spi1_open();
+    return spi1_acquire(&oledC_client);
 }
 
 void oledC_setup(void)
@@ -215,6 +383,9 @@ void oledC_setup(void)
     LATAbits.LATA13 = 1; /* set oledC_RST output high */
     LATCbits.LATC8 = 1; /* set oledC_EN output high */
     DELAY_milliseconds(1);
+    panel_profile = OLEDC_PANEL_PROFILE_COUNT; /* the reset cleared it */
+    oledC_litMapClear(0); /* counted dark until the first clear */
+    oledC_setPanelProfile(OLEDC_PANEL_BALANCED);
     oledC_setSleepMode(false);
     DELAY_milliseconds(200);
     oledC_setColumnAddressBounds(0, 95);
@@ -222,19 +393,18 @@ void oledC_setup(void)
     oledC_setDisplayOrientation();
 }
 
+/* Puts the panel to sleep and cuts its supply. Safe to call from an
+ * interrupt that preempted a pixel stream: the bus is forced idle first. */
+void oledC_shutdown(void)
+{
+    spi1_abort();
+    oledC_setSleepMode(true);
+    LATCbits.LATC8 = 0; /* set oledC_EN output low */
+}
+
 void oledC_clearScreen(void) 
 {    
-    uint8_t x;
-    uint8_t y;
-    oledC_setColumnAddressBounds(0,96);
-    oledC_setRowAddressBounds(0,96);
-    for(x = 0; x < 96; x++)
-    {
-        for(y = 0; y < 96; y++)
-        {
-            oledC_sendColorInt(background_color);
-        }
-    }
+    oledC_fillWindow(0, 0, 95, 95, background_color);
 }
 
 void oledC_setBackground(uint16_t color)
@@ -64,12 +64,44 @@ typedef enum OLEDC_CMDS
     OLEDC_CMD_SET_COMMAND_LOCK = 0xFD
 } OLEDC_COMMAND;
 
+/* Rendering statistics. Lit weights are in permille of a full white
+ * panel, estimated from what the driver drew (see oledC_litMap.h). */
+typedef struct oledc_render_stats_t
+{
+    uint16_t litPermille;           /* now, 0 while the panel sleeps */
+    uint16_t peakLitPermille;
+    uint16_t averageLitPermille;    /* over the sampled time */
+    uint32_t pixelsWritten;
+    uint32_t fills;
+} oledc_render_stats_t;
+
+/* Panel timing and drive profiles: refresh rate and drive current against
+ * power. Balanced is applied by oledC_setup. */
+typedef enum OLEDC_PANEL_PROFILES
+{
+    OLEDC_PANEL_PERFORMANCE,
+    OLEDC_PANEL_BALANCED,
+    OLEDC_PANEL_LOW_POWER,
+    OLEDC_PANEL_PROFILE_COUNT
+} OLEDC_PANEL_PROFILE;
+
 void oledC_sendCommand(OLEDC_COMMAND cmd, uint8_t *payload, uint8_t payload_size);
 
 void oledC_setRowAddressBounds(uint8_t min, uint8_t max);
 void oledC_setColumnAddressBounds(uint8_t min, uint8_t max);
+void oledC_fillWindow(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t color);
 void oledC_setSleepMode(bool on);
 void oledC_setDisplayOrientation(void);
+/* Sends the profile's whole timing sequence in one transfer; nothing is sent
+ * if it is already applied. False if the bus is busy, to be retried. */
+bool oledC_setPanelProfile(OLEDC_PANEL_PROFILE profile);
+OLEDC_PANEL_PROFILE oledC_getPanelProfile(void);
+
+/* Call regularly with a monotonic time; the average lit weight is
+ * weighted by the time between calls */
+void oledC_sampleRenderStats(uint32_t ticks);
+void oledC_getRenderStats(oledc_render_stats_t *stats);
+void oledC_resetRenderStats(void);
 void oledC_setBackground(uint16_t color);
 
 void oledC_clearScreen(void);
@@ -79,6 +111,7 @@ uint16_t oledC_readColor(void);
 
 bool oledC_open(void);
 void oledC_setup(void);
+void oledC_shutdown(void);
 void oledC_sendColor(uint8_t r, uint8_t g, uint8_t b);
 void oledC_sendColorInt(uint16_t raw);
 void oledC_startWritingDisplay(void);
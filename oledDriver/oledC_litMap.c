@@ -0,0 +1,102 @@
+/*
+ * File: oledC_litMap.c
+ * Project: Smart Watch - Final Version
+ * Description: Running estimate of the lit-pixel weight on the panel.
+ *
+ * A tile holds at most 16 x 15 = 240, so the map is one byte per tile,
+ * 576 bytes in all, and the panel total is kept alongside it so reading
+ * it costs nothing. Green has six bits against five for red and blue;
+ * doubling red and blue gives the three channels equal say.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "oledC_litMap.h"
+
+#define LIT_TILE_PIXELS         (OLEDC_LIT_TILE_SIZE * OLEDC_LIT_TILE_SIZE)
+#define LIT_CHANNEL_SUM_MAX     (2 * 31 + 63 + 2 * 31)
+#define LIT_PANEL_MAX           ((uint32_t)96 * 96 * OLEDC_LIT_WEIGHT_MAX)
+
+static uint8_t tiles[OLEDC_LIT_TILES][OLEDC_LIT_TILES];
+static uint32_t total;
+
+uint8_t oledC_litWeight(uint16_t color)
+{
+    uint16_t red = color >> 11;
+    uint16_t green = (color >> 5) & 0x3F;
+    uint16_t blue = color & 0x1F;
+    uint16_t sum = 2 * red + green + 2 * blue;
+    return (sum * OLEDC_LIT_WEIGHT_MAX + LIT_CHANNEL_SUM_MAX / 2) / LIT_CHANNEL_SUM_MAX;
+}
+
+static uint8_t litOverlap(uint8_t tile, uint8_t start, uint8_t end)
+{
+    uint8_t first = tile * OLEDC_LIT_TILE_SIZE;
+    uint8_t last = first + OLEDC_LIT_TILE_SIZE - 1;
+    if(start > first)
+    {
+        first = start;
+    }
+    if(end < last)
+    {
+        last = end;
+    }
+    return last - first + 1;
+}
+
+void oledC_litMapClear(uint16_t color)
+{
+    uint8_t weight = oledC_litWeight(color) * LIT_TILE_PIXELS;
+    uint8_t row;
+    uint8_t column;
+    for(row = 0; row < OLEDC_LIT_TILES; row++)
+    {
+        for(column = 0; column < OLEDC_LIT_TILES; column++)
+        {
+            tiles[row][column] = weight;
+        }
+    }
+    total = (uint32_t)weight * OLEDC_LIT_TILES * OLEDC_LIT_TILES;
+}
+
+void oledC_litMapFill(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t color)
+{
+    uint8_t weight = oledC_litWeight(color);
+    uint8_t row;
+    uint8_t column;
+    if(end_x > 95)
+    {
+        end_x = 95;
+    }
+    if(end_y > 95)
+    {
+        end_y = 95;
+    }
+    if(end_x < start_x || end_y < start_y)
+    {
+        return;
+    }
+    for(row = start_y / OLEDC_LIT_TILE_SIZE; row <= end_y / OLEDC_LIT_TILE_SIZE; row++)
+    {
+        uint8_t height = litOverlap(row, start_y, end_y);
+        for(column = start_x / OLEDC_LIT_TILE_SIZE; column <= end_x / OLEDC_LIT_TILE_SIZE; column++)
+        {
+            uint8_t covered = height * litOverlap(column, start_x, end_x);
+            uint8_t old = tiles[row][column];
+            uint8_t kept = old - ((uint16_t)old * covered + LIT_TILE_PIXELS / 2) / LIT_TILE_PIXELS;
+            uint8_t updated = kept + covered * weight;
+            tiles[row][column] = updated;
+            total = total - old + updated;
+        }
+    }
+}
+
+void oledC_litMapPixel(uint8_t x, uint8_t y, uint16_t color)
+{
+    oledC_litMapFill(x, y, x, y, color);
+}
+
+uint16_t oledC_litMapPermille(void)
+{
+    return (total * 1000 + LIT_PANEL_MAX / 2) / LIT_PANEL_MAX;
+}
@@ -0,0 +1,35 @@
+/*
+ * File: oledC_litMap.h
+ * Project: Smart Watch - Final Version
+ * Description: Running estimate of the lit-pixel weight on the panel.
+ *
+ * An OLED pixel draws current in proportion to how bright it is, so the
+ * panel's share of the supply follows the summed brightness of what is on
+ * screen. There is no framebuffer to count it from; instead the panel is
+ * split into 4x4 tiles, each holding the summed weight of its pixels, and
+ * every fill or pixel the driver sends updates the tiles it covers. A
+ * fully covered tile is exact; a partly covered one assumes what was
+ * overwritten had the tile's average weight. No device dependencies:
+ * the host energy report uses the same code.
+ */
+
+#ifndef OLEDC_LIT_MAP_H
+#define OLEDC_LIT_MAP_H
+
+#include <stdint.h>
+
+#define OLEDC_LIT_TILE_SIZE     4
+#define OLEDC_LIT_TILES         (96 / OLEDC_LIT_TILE_SIZE)     /* per side */
+#define OLEDC_LIT_WEIGHT_MAX    15                              /* a white pixel */
+
+/* Weight of an RGB565 color, 0 (black) to OLEDC_LIT_WEIGHT_MAX (white) */
+uint8_t oledC_litWeight(uint16_t color);
+
+void oledC_litMapClear(uint16_t color);
+void oledC_litMapFill(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t color);
+void oledC_litMapPixel(uint8_t x, uint8_t y, uint16_t color);
+
+/* Lit weight of the whole panel, full white = 1000 */
+uint16_t oledC_litMapPermille(void);
+
+#endif // OLEDC_LIT_MAP_H
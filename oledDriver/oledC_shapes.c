@@ -153,9 +153,7 @@ void oledC_DrawPoint(uint8_t x, uint8_t y, uint16_t color)
     {
         return;
     }
-    oledC_setColumnAddressBounds(x,95);
-    oledC_setRowAddressBounds(y,95);
-    oledC_sendColorInt(color);
+    oledC_fillWindow(x, y, x, y, color);
 }
 
 void oledC_DrawThickPoint(uint8_t center_x, uint8_t center_y, uint8_t width, uint16_t color)
@@ -292,17 +290,7 @@ void oledC_DrawLine(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, uint8_t widt
 
 void oledC_DrawRectangle(uint8_t start_x, uint8_t start_y, uint8_t end_x, uint8_t end_y, uint16_t color)
 {
-    uint8_t x;
-    uint8_t y;
-    oledC_setColumnAddressBounds(start_x,end_x);
-    oledC_setRowAddressBounds(start_y,end_y);
-    for(x = start_x; x < end_x+1; x++)
-    {
-        for(y = start_y; y < end_y+1; y++)
-        {
-            oledC_sendColorInt(color);
-        }
-    }
+    oledC_fillWindow(start_x, start_y, end_x, end_y, color);
 }
 
 void oledC_DrawCharacter(uint8_t x, uint8_t y, uint8_t sx, uint8_t sy, uint8_t ch, uint16_t color)
@@ -0,0 +1,97 @@
+/*
+ * File: powerMonitor.c
+ * Project: Smart Watch - Final Version
+ * Description: Supply voltage estimation and low-voltage emergency shutdown.
+ *
+ * VDD is estimated by converting the internal band-gap reference against
+ * AVDD: VDD = VBG * full-scale / reading. The HLVD module interrupts when
+ * VDD falls through the trip point, which is set above the BOR level so
+ * the registered handler still has time to save state.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "powerMonitor.h"
+
+#define POWER_BANDGAP_MV          1200UL
+#define POWER_ADC_FULL_SCALE      1023UL  // ADC runs in 10-bit mode
+#define POWER_ADC_CH_BANDGAP      0x1C    // AD1CHS CH0SA: internal VBG
+#define POWER_HLVD_TRIP_LEVEL     0x0C    // HLVDL: ~2.2 V, above BOR
+
+static void (*emergencyHandler)(void);
+static volatile uint16_t supplyMillivolts = 0;
+static volatile bool shutdownActive = false;
+
+void powerMonitorInit(void) {
+    ANCFGbits.VBGADC = 1;           // band gap routed to the ADC
+
+    HLVDCON = 0;
+    HLVDCONbits.VDIR = 0;           // trip on falling voltage
+    HLVDCONbits.HLVDL = POWER_HLVD_TRIP_LEVEL;
+    HLVDCONbits.HLVDEN = 1;
+    while (!HLVDCONbits.IRVST)
+        ;
+
+    IPC18bits.HLVDIP = 7;           // must preempt everything else
+    IFS4bits.HLVDIF = 0;
+    IEC4bits.HLVDIE = 1;
+
+    powerMonitorSample();
+}
+
+void powerMonitorSetEmergencyHandler(void (*handler)(void)) {
+    emergencyHandler = handler;
+}
+
+uint16_t powerMonitorSample(void) {
+    uint16_t previousChannel = AD1CHS;
+    uint16_t reading;
+
+    AD1CHS = POWER_ADC_CH_BANDGAP;
+    AD1CON1bits.SAMP = 1;
+    for (volatile uint8_t i = 0; i < 20; i++)
+        ;
+    AD1CON1bits.SAMP = 0;
+    while (!AD1CON1bits.DONE)
+        ;
+    reading = ADC1BUF0;
+    AD1CHS = previousChannel;
+
+    if (reading == 0)
+        return supplyMillivolts;
+    supplyMillivolts = (uint16_t)((POWER_BANDGAP_MV * POWER_ADC_FULL_SCALE) / reading);
+    return supplyMillivolts;
+}
+
+uint16_t powerMonitorGetMillivolts(void) {
+    return supplyMillivolts;
+}
+
+bool powerMonitorIsLow(void) {
+    return shutdownActive || (supplyMillivolts != 0 && supplyMillivolts < POWER_LOW_BATTERY_MV);
+}
+
+// The supply is collapsing: save state once, then sleep until either BOR
+// resets the part or the HLVD sees the supply come back, in which case a
+// software reset restores from the saved snapshot.
+void __attribute__((__interrupt__, auto_psv)) _HLVDInterrupt(void) {
+    IFS4bits.HLVDIF = 0;
+    if (shutdownActive)
+        return;
+    shutdownActive = true;
+
+    if (emergencyHandler)
+        emergencyHandler();
+
+    HLVDCONbits.HLVDEN = 0;
+    HLVDCONbits.VDIR = 1;           // now trip on rising voltage
+    HLVDCONbits.HLVDEN = 1;
+    IFS4bits.HLVDIF = 0;
+
+    while (1) {
+        Sleep();
+        if (IFS4bits.HLVDIF)
+            __asm__ volatile ("reset");
+    }
+}
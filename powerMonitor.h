@@ -0,0 +1,30 @@
+/*
+ * File: powerMonitor.h
+ * Project: Smart Watch - Final Version
+ * Description: Supply voltage estimation through the ADC band-gap channel and
+ *              low-voltage emergency handling through the HLVD module.
+ */
+
+#ifndef POWER_MONITOR_H
+#define POWER_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define POWER_LOW_BATTERY_MV      2400
+
+// Enables the band-gap reference and arms the HLVD interrupt.
+void powerMonitorInit(void);
+
+// Called from the HLVD interrupt when the supply falls below the trip
+// point. It must finish within the BOR hold-up time: no page erases,
+// no delays, no waiting on other interrupts.
+void powerMonitorSetEmergencyHandler(void (*handler)(void));
+
+// Converts the band-gap channel once and returns the estimated VDD in mV.
+uint16_t powerMonitorSample(void);
+
+uint16_t powerMonitorGetMillivolts(void);
+bool powerMonitorIsLow(void);
+
+#endif // POWER_MONITOR_H
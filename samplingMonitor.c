@@ -0,0 +1,98 @@
+/*
+ * File: samplingMonitor.c
+ * Project: Smart Watch - Final Version
+ * Description: Conformance of the step detector's sampling to the rate its
+ *              windows assume.
+ *
+ * Only sums are kept per sample (count, sum and sum of squares of the
+ * intervals in ticks); the mean and deviation are worked out when the
+ * statistics are read, so a sample costs a few additions in the loop.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include "samplingMonitor.h"
+
+static struct {
+    uint32_t nominalTicks;
+    uint32_t toleranceTicks;
+    uint8_t fifoDepth;
+    bool haveLast;
+    uint32_t lastTicks;
+    uint32_t intervals;
+    uint64_t sumTicks;
+    uint64_t sumSquares;
+    uint32_t maxJitterTicks;
+    uint32_t violations;
+    uint32_t dropped;
+    uint16_t overruns;
+} monitor;
+
+void samplingMonitorInit(uint32_t nominalTicks, uint32_t toleranceTicks, uint8_t fifoDepth) {
+    memset(&monitor, 0, sizeof(monitor));
+    monitor.nominalTicks = nominalTicks;
+    monitor.toleranceTicks = toleranceTicks;
+    monitor.fifoDepth = fifoDepth;
+}
+
+void samplingMonitorSample(uint32_t now, uint8_t drained) {
+    if (drained > 1)
+        monitor.dropped += drained - 1;
+    if (drained >= monitor.fifoDepth && monitor.overruns < UINT16_MAX)
+        monitor.overruns++;
+
+    if (monitor.haveLast) {
+        uint32_t interval = now - monitor.lastTicks;
+        uint32_t jitter = (interval > monitor.nominalTicks) ? interval - monitor.nominalTicks
+                                                            : monitor.nominalTicks - interval;
+        monitor.intervals++;
+        monitor.sumTicks += interval;
+        monitor.sumSquares += (uint64_t)interval * interval;
+        if (jitter > monitor.maxJitterTicks)
+            monitor.maxJitterTicks = jitter;
+        if (jitter > monitor.toleranceTicks)
+            monitor.violations++;
+    }
+    monitor.lastTicks = now;
+    monitor.haveLast = true;
+}
+
+void samplingMonitorRestart(void) {
+    monitor.haveLast = false;
+}
+
+void samplingMonitorStats(SamplingStats *stats) {
+    float mean = 0.0f;
+    float variance = 0.0f;
+
+    if (monitor.intervals > 0) {
+        mean = (float)monitor.sumTicks / monitor.intervals;
+        variance = (float)monitor.sumSquares / monitor.intervals - mean * mean;
+        if (variance < 0.0f)    // rounding when the intervals are all equal
+            variance = 0.0f;
+    }
+    stats->intervals = monitor.intervals;
+    stats->meanUs = (uint32_t)(mean * SAMPLING_MONITOR_TICK_US + 0.5f);
+    stats->stddevUs = (uint32_t)(sqrtf(variance) * SAMPLING_MONITOR_TICK_US + 0.5f);
+    stats->maxJitterUs = monitor.maxJitterTicks * SAMPLING_MONITOR_TICK_US;
+    stats->violations = monitor.violations;
+    stats->dropped = monitor.dropped;
+    stats->overruns = monitor.overruns;
+    stats->nominalUs = monitor.nominalTicks * SAMPLING_MONITOR_TICK_US;
+    stats->violated = (monitor.intervals >= SAMPLING_MONITOR_MIN_INTERVALS &&
+                       ((uint64_t)monitor.violations * 1000 >
+                            (uint64_t)monitor.intervals * SAMPLING_MONITOR_VIOLATION_PERMILLE ||
+                        fabsf(mean - monitor.nominalTicks) > monitor.toleranceTicks));
+}
+
+bool samplingMonitorViolated(void) {
+    SamplingStats stats;
+    samplingMonitorStats(&stats);
+    return stats.violated;
+}
+
+void samplingMonitorReset(void) {
+    samplingMonitorInit(monitor.nominalTicks, monitor.toleranceTicks, monitor.fifoDepth);
+}
@@ -0,0 +1,54 @@
+/*
+ * File: samplingMonitor.h
+ * Project: Smart Watch - Final Version
+ * Description: Conformance of the step detector's sampling to the rate its
+ *              windows assume.
+ *
+ * The detector takes the newest accelerometer sample once per main loop
+ * pass, so its effective rate is whatever the loop achieves. Each sample
+ * it consumes is time-stamped; the monitor keeps the mean, standard
+ * deviation and largest departure of the intervals from the nominal one,
+ * and counts the FIFO samples the detector never saw. No device
+ * dependencies: builds on a host compiler for off-target checks.
+ */
+
+#ifndef SAMPLING_MONITOR_H
+#define SAMPLING_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SAMPLING_MONITOR_TICK_US        64      // Timer1 at FCY / 256
+// The rate counts as violated once more than this share of intervals is
+// out of tolerance, or the mean interval itself is
+#define SAMPLING_MONITOR_VIOLATION_PERMILLE 10
+#define SAMPLING_MONITOR_MIN_INTERVALS  64      // before the flag is judged
+
+typedef struct {
+    uint32_t intervals;
+    uint32_t meanUs;
+    uint32_t stddevUs;
+    uint32_t maxJitterUs;       // largest |interval - nominal|
+    uint32_t violations;        // intervals outside the tolerance
+    uint32_t dropped;           // drained from the FIFO, never seen by the detector
+    uint16_t overruns;          // FIFO found full: samples lost outright
+    uint32_t nominalUs;
+    bool violated;
+} SamplingStats;
+
+// nominalTicks is the interval the detector's windows are sized for
+void samplingMonitorInit(uint32_t nominalTicks, uint32_t toleranceTicks, uint8_t fifoDepth);
+
+// One consumed sample at time now; drained is the number of FIFO entries
+// read to get it (the newest one included)
+void samplingMonitorSample(uint32_t now, uint8_t drained);
+
+// Forgets the last time stamp, so a deliberate pause in sampling (a menu)
+// is not counted as an interval
+void samplingMonitorRestart(void);
+
+void samplingMonitorStats(SamplingStats *stats);
+bool samplingMonitorViolated(void);
+void samplingMonitorReset(void);
+
+#endif // SAMPLING_MONITOR_H
@@ -0,0 +1,144 @@
+/*
+ * File: sleepTracker.c
+ * Project: Smart Watch - Final Version
+ * Description: Sleep/wake scoring from wrist activity.
+ *
+ * The accelerometer runs at 12.5 Hz in low-power mode with the FIFO in
+ * stream mode; the watermark interrupt wakes the CPU every 2 s to drain
+ * 25 samples in burst reads, instead of polling three axes every 20 ms.
+ * The activity count of a one-minute epoch is the sum of sample-to-sample
+ * changes on all axes, ignoring changes within the sensor noise.
+ *
+ * Epochs are scored with the Cole-Kripke rule
+ *   D = P * (404 A-4 + 598 A-3 + 326 A-2 + 441 A-1 + 1408 A0 + 508 A+1 + 350 A+2)
+ * asleep when D < 1, evaluated in integers; an epoch is therefore scored
+ * two minutes after it ends.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "accelSensor.h"
+#include "fallDetector.h"
+#include "historyStore.h"
+#include "sleepTracker.h"
+
+#define SLEEP_FIFO_WATERMARK    25      // 2 s at 12.5 Hz
+#define SLEEP_NOISE_LSB         (16 / ACCEL_MG_PER_LSB)  // per-axis change treated as noise
+#define SLEEP_COUNT_MAX         0x7FFF  // bit 15 of the record holds the verdict
+#define SLEEP_WINDOW            7
+#define SLEEP_WINDOW_CENTER     4       // epoch being scored: 4 behind, 2 ahead
+#define SLEEP_COUNT_SHIFT       6       // scales counts to the rule's activity units
+#define SLEEP_SCORE_LIMIT       1000    // D < 1 with P = 1/1000
+
+static const uint16_t COLE_KRIPKE_WEIGHTS[SLEEP_WINDOW] = {404, 598, 326, 441, 1408, 508, 350};
+
+static uint16_t windowCounts[SLEEP_WINDOW];
+static uint32_t windowStamps[SLEEP_WINDOW];
+static bool windowValid[SLEEP_WINDOW];
+static uint32_t epochCount;
+static AccelSample previousSample;
+static bool havePreviousSample;
+static bool asleep;
+static uint8_t savedInterrupts;
+
+static uint16_t axisChange(int16_t current, int16_t previous) {
+    int16_t delta = current - previous;
+    if (delta < 0)
+        delta = -delta;
+    return (delta > SLEEP_NOISE_LSB) ? delta : 0;
+}
+
+static void accumulateSample(const AccelSample *sample) {
+    if (havePreviousSample && epochCount < SLEEP_COUNT_MAX) {
+        epochCount += axisChange(sample->x, previousSample.x);
+        epochCount += axisChange(sample->y, previousSample.y);
+        epochCount += axisChange(sample->z, previousSample.z);
+    }
+    previousSample = *sample;
+    havePreviousSample = true;
+}
+
+static void scoreCenterEpoch(void) {
+    uint32_t score = 0;
+    HistoryRecord record;
+
+    for (uint8_t i = 0; i < SLEEP_WINDOW; i++)
+        score += (uint32_t)COLE_KRIPKE_WEIGHTS[i] * (windowCounts[i] >> SLEEP_COUNT_SHIFT);
+    asleep = (score < SLEEP_SCORE_LIMIT);
+
+    record.type = HISTORY_RECORD_SLEEP;
+    record.timestamp = windowStamps[SLEEP_WINDOW_CENTER];
+    record.value = windowCounts[SLEEP_WINDOW_CENTER] | (asleep ? HISTORY_SLEEP_ASLEEP_FLAG : 0);
+    historyStoreAppend(&record);
+}
+
+// Shifts the window by one epoch and scores the epoch reaching the center
+static void pushEpoch(uint16_t count, uint32_t timestamp, bool valid) {
+    for (uint8_t i = 0; i < SLEEP_WINDOW - 1; i++) {
+        windowCounts[i] = windowCounts[i + 1];
+        windowStamps[i] = windowStamps[i + 1];
+        windowValid[i] = windowValid[i + 1];
+    }
+    windowCounts[SLEEP_WINDOW - 1] = count;
+    windowStamps[SLEEP_WINDOW - 1] = timestamp;
+    windowValid[SLEEP_WINDOW - 1] = valid;
+
+    if (windowValid[SLEEP_WINDOW_CENTER])
+        scoreCenterEpoch();
+}
+
+bool sleepTrackerStart(void) {
+    for (uint8_t i = 0; i < SLEEP_WINDOW; i++) {
+        windowCounts[i] = 0;
+        windowValid[i] = false;
+    }
+    epochCount = 0;
+    havePreviousSample = false;
+    asleep = false;
+
+    // Taps and falls are not serviced overnight; only the watermark wakes us
+    savedInterrupts = accelSensorEnabledInterrupts();
+    accelSensorDisableInterrupts(savedInterrupts);
+    return accelSensorSetRate(ACCEL_RATE_12_5HZ, true) &&
+           accelSensorConfigureFifo(ACCEL_FIFO_STREAM, SLEEP_FIFO_WATERMARK) &&
+           accelSensorEnableInterrupts(ACCEL_INT_WATERMARK);
+}
+
+void sleepTrackerStop(void) {
+    // Pad the look-ahead with quiet epochs so the last real ones get scored
+    for (uint8_t i = SLEEP_WINDOW_CENTER + 1; i < SLEEP_WINDOW; i++)
+        pushEpoch(0, 0, false);
+
+    // Step mode drains the FIFO as a plain stream
+    accelSensorDisableInterrupts(ACCEL_INT_WATERMARK);
+    accelSensorConfigureFifo(ACCEL_FIFO_STREAM, 0);
+    accelSensorSetRate(ACCEL_RATE_100HZ, false);
+    accelSensorEnableInterrupts(savedInterrupts);
+}
+
+void sleepTrackerService(void) {
+    AccelSample sample;
+    uint8_t entries;
+
+    if (!accelSensorInterruptPending())
+        return;
+    if (!(accelSensorReadInterruptSource() & (ACCEL_INT_WATERMARK | ACCEL_INT_OVERRUN)))
+        return;
+
+    // A capture started before the night still completes in order
+    entries = accelSensorFifoEntries();
+    while (entries-- > 0 && accelSensorReadSample(&sample)) {
+        fallDetectorAddSample(&sample);
+        accumulateSample(&sample);
+    }
+}
+
+void sleepTrackerEndEpoch(uint32_t timestamp) {
+    sleepTrackerService();
+    pushEpoch(epochCount > SLEEP_COUNT_MAX ? SLEEP_COUNT_MAX : (uint16_t)epochCount, timestamp, true);
+    epochCount = 0;
+}
+
+bool sleepTrackerIsAsleep(void) {
+    return asleep;
+}
@@ -0,0 +1,31 @@
+/*
+ * File: sleepTracker.h
+ * Project: Smart Watch - Final Version
+ * Description: Overnight actigraphy. The ADXL345 samples at a low-power
+ *              12.5 Hz into its FIFO; per-minute activity counts are
+ *              classified sleep/wake and logged to the history store.
+ */
+
+#ifndef SLEEP_TRACKER_H
+#define SLEEP_TRACKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Reconfigures the accelerometer for batched low-power sampling.
+bool sleepTrackerStart(void);
+
+// Scores the epochs still waiting for look-ahead, then restores the
+// step-mode sampling rate and interrupt sources.
+void sleepTrackerStop(void);
+
+// Drains the FIFO when the watermark interrupt is pending. Main loop only.
+void sleepTrackerService(void);
+
+// Closes the current one-minute epoch; timestamp is that minute's start.
+void sleepTrackerEndEpoch(uint32_t timestamp);
+
+// Classification of the most recently scored epoch (two minutes behind).
+bool sleepTrackerIsAsleep(void);
+
+#endif // SLEEP_TRACKER_H
@@ -0,0 +1,175 @@
+/*
+ * File: snapshotStore.c
+ * Project: Smart Watch - Final Version
+ * Description: Append-only journal of watch state in one reserved flash page.
+ *              Each slot is eight instruction words written as four
+ *              double-words, so saving never needs an erase.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "System/flash.h"
+#include "System/crc.h"
+#include "snapshotStore.h"
+
+#define SNAPSHOT_WORDS_PER_SLOT   8
+#define SNAPSHOT_CHECK_WORD       (SNAPSHOT_WORDS_PER_SLOT - 1)
+#define SNAPSHOT_SLOT_COUNT       (FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS / SNAPSHOT_WORDS_PER_SLOT)
+#define SNAPSHOT_SLOT_PC_UNITS    (SNAPSHOT_WORDS_PER_SLOT * 2)
+#define SNAPSHOT_CONSUMED         0x0000
+
+typedef enum {
+    SLOT_DAMAGED,
+    SLOT_SNAPSHOT,
+    SLOT_CONSUMED
+} SlotState;
+
+// Slot layout (16 bits per instruction word):
+//   word0  month[15:12] day[11:7] hours[4:0]  (never 0xFFFF once written)
+//   word1  minutes[15:8] seconds[7:0]
+//   word2  totalSteps
+//   word3  distanceMm[15:0], word4 distanceMm[31:16]
+//   word5  energyCal[15:0], word6 energyCal[31:16]
+//   word7  CRC-16/CCITT over words 0..6
+// A slot whose word0 is SNAPSHOT_CONSUMED marks the snapshot before it as
+// restored, so a later reset does not bring the same state back.
+static const uint16_t snapshotPage[FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS]
+    __attribute__((space(prog), aligned(FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS), noload));
+
+static uint32_t pageAddress;
+static uint16_t nextSlot;
+static WatchSnapshot lastSnapshot;
+static bool hasSnapshot = false;
+
+static uint32_t slotAddress(uint16_t slot) {
+    return pageAddress + (uint32_t)slot * SNAPSHOT_SLOT_PC_UNITS;
+}
+
+// Same check as the history records; falls back to software when the
+// low-voltage ISR interrupts a computation on the CRC engine
+static uint16_t computeCheck(const uint16_t *words) {
+    uint8_t bytes[2 * SNAPSHOT_CHECK_WORD];
+    for (uint8_t i = 0; i < SNAPSHOT_CHECK_WORD; i++) {
+        bytes[2 * i] = words[i] & 0xFF;
+        bytes[2 * i + 1] = words[i] >> 8;
+    }
+    return (uint16_t)CRC_Calculate(&CRC_CONFIG_CCITT16, bytes, sizeof(bytes));
+}
+
+static void packSnapshot(const WatchSnapshot *snapshot, uint16_t *words) {
+    words[0] = ((uint16_t)snapshot->month << 12) | ((uint16_t)snapshot->day << 7) | snapshot->hours;
+    words[1] = ((uint16_t)snapshot->minutes << 8) | snapshot->seconds;
+    words[2] = snapshot->totalSteps;
+    words[3] = snapshot->distanceMm & 0xFFFF;
+    words[4] = snapshot->distanceMm >> 16;
+    words[5] = snapshot->energyCal & 0xFFFF;
+    words[6] = snapshot->energyCal >> 16;
+    words[SNAPSHOT_CHECK_WORD] = computeCheck(words);
+}
+
+static bool writeSlot(const uint16_t *words) {
+    uint32_t address;
+
+    if (nextSlot >= SNAPSHOT_SLOT_COUNT)
+        return false;
+    address = slotAddress(nextSlot++);
+    // The check word lands last, so an interrupted write fails it
+    for (uint8_t i = 0; i < SNAPSHOT_WORDS_PER_SLOT; i += 2)
+        if (!FLASH_WriteDoubleWord16(address + i * 2, words[i], words[i + 1]))
+            return false;
+    return true;
+}
+
+static SlotState readSlot(uint16_t slot, WatchSnapshot *snapshot) {
+    uint16_t words[SNAPSHOT_WORDS_PER_SLOT];
+    uint32_t address = slotAddress(slot);
+
+    for (uint8_t i = 0; i < SNAPSHOT_WORDS_PER_SLOT; i++)
+        words[i] = FLASH_ReadWord16(address + i * 2);
+
+    if (words[SNAPSHOT_CHECK_WORD] != computeCheck(words))
+        return SLOT_DAMAGED;
+    if (words[0] == SNAPSHOT_CONSUMED)
+        return SLOT_CONSUMED;
+
+    snapshot->month = words[0] >> 12;
+    snapshot->day = (words[0] >> 7) & 0x1F;
+    snapshot->hours = words[0] & 0x1F;
+    snapshot->minutes = words[1] >> 8;
+    snapshot->seconds = words[1] & 0xFF;
+    snapshot->totalSteps = words[2];
+    snapshot->distanceMm = ((uint32_t)words[4] << 16) | words[3];
+    snapshot->energyCal = ((uint32_t)words[6] << 16) | words[5];
+    if (snapshot->month < 1 || snapshot->month > 12 || snapshot->day < 1)
+        return SLOT_DAMAGED;
+    return SLOT_SNAPSHOT;
+}
+
+// Slots fill strictly in order, so the first unused one is found by
+// binary search on the first word of each slot.
+static uint16_t findFirstFreeSlot(void) {
+    uint16_t low = 0, high = SNAPSHOT_SLOT_COUNT;
+    while (low < high) {
+        uint16_t mid = (low + high) / 2;
+        if (FLASH_ReadWord16(slotAddress(mid)) == FLASH_ERASED_WORD16)
+            high = mid;
+        else
+            low = mid + 1;
+    }
+    return low;
+}
+
+void snapshotStoreInit(void) {
+    pageAddress = __builtin_tbladdress(snapshotPage);
+    nextSlot = findFirstFreeSlot();
+
+    // A slot whose second double-word never landed fails its check, so
+    // walk back to the newest complete one.
+    hasSnapshot = false;
+    for (uint16_t slot = nextSlot; slot > 0; slot--) {
+        SlotState state = readSlot(slot - 1, &lastSnapshot);
+        if (state != SLOT_DAMAGED) {
+            hasSnapshot = (state == SLOT_SNAPSHOT);
+            break;
+        }
+    }
+
+    if (nextSlot >= SNAPSHOT_SLOT_COUNT) {
+        FLASH_ErasePage(pageAddress);
+        nextSlot = 0;
+        if (hasSnapshot)
+            snapshotStoreSave(&lastSnapshot);
+    }
+}
+
+bool snapshotStoreSave(const WatchSnapshot *snapshot) {
+    uint16_t words[SNAPSHOT_WORDS_PER_SLOT];
+
+    packSnapshot(snapshot, words);
+    if (!writeSlot(words))
+        return false;
+
+    lastSnapshot = *snapshot;
+    hasSnapshot = true;
+    return true;
+}
+
+bool snapshotStoreLoad(WatchSnapshot *snapshot) {
+    if (!hasSnapshot)
+        return false;
+    *snapshot = lastSnapshot;
+    return true;
+}
+
+bool snapshotStoreConsume(void) {
+    uint16_t words[SNAPSHOT_WORDS_PER_SLOT] = {SNAPSHOT_CONSUMED};
+
+    if (!hasSnapshot)
+        return true;
+    words[SNAPSHOT_CHECK_WORD] = computeCheck(words);
+    if (!writeSlot(words))
+        return false;
+    hasSnapshot = false;
+    return true;
+}
@@ -0,0 +1,40 @@
+/*
+ * File: snapshotStore.h
+ * Project: Smart Watch - Final Version
+ * Description: Flash journal holding the last known step total, clock and
+ *              daily fitness totals so they survive a power loss.
+ */
+
+#ifndef SNAPSHOT_STORE_H
+#define SNAPSHOT_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    uint16_t totalSteps;
+    uint8_t hours;
+    uint8_t minutes;
+    uint8_t seconds;
+    uint8_t day;
+    uint8_t month;
+    uint32_t distanceMm;        // today's fitness totals
+    uint32_t energyCal;
+} WatchSnapshot;
+
+// Prepares the journal page; erases it when no free slot is left.
+// Must be called from normal context before any emergency save can happen.
+void snapshotStoreInit(void);
+
+// Appends a snapshot using four double-word writes and no page erase, so it
+// completes in bounded time and may be called from the low-voltage ISR.
+bool snapshotStoreSave(const WatchSnapshot *snapshot);
+
+// Returns the most recent complete snapshot, if any.
+bool snapshotStoreLoad(WatchSnapshot *snapshot);
+
+// Marks the loaded snapshot as restored, so the next boot without a newer
+// save starts from the defaults instead of the same stale state.
+bool snapshotStoreConsume(void);
+
+#endif // SNAPSHOT_STORE_H
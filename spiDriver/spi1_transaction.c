@@ -0,0 +1,311 @@
+/*
+ * File: spi1_transaction.c
+ * Project: Smart Watch - Final Version
+ * Description: Transactions and bus arbitration on top of spi1_driver.
+ *
+ * Ownership is taken with interrupts masked, so a client running in an
+ * interrupt never sees half of a hand-over. While steps or stream words
+ * are being clocked out the bus is busy and refused to everyone, the owner
+ * included: an interrupt that preempted them must not close the
+ * peripheral under them. Between calls only the owner, at the interrupt
+ * priority it took the bus at, may re-enter its open stream. The
+ * peripheral is only enabled while a client owns the bus.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "spi1_driver.h"
+#include "spi1_transaction.h"
+
+static const spi1_client_t *volatile owner = NULL;
+static uint16_t ownerIpl;              /* CPU priority the owner took the bus at */
+static volatile bool busy = false;
+static volatile bool streamOpen = false;
+static uint8_t streamTag;
+
+static void spi1_setDataMode(const spi1_client_t *client, bool data)
+{
+    if(client->dataMode)
+    {
+        client->dataMode(data);
+    }
+}
+
+static void spi1_deselect(const spi1_client_t *client)
+{
+    client->select(false);
+    spi1_setDataMode(client, false);
+    streamOpen = false;
+}
+
+static spi1_step_t *spi1_addStep(spi1_transaction_t *transaction, uint8_t kind)
+{
+    spi1_step_t *step;
+    if(transaction->stepCount >= SPI1_TRANSACTION_MAX_STEPS)
+    {
+        return NULL;
+    }
+    step = &transaction->steps[transaction->stepCount++];
+    step->kind = kind;
+    return step;
+}
+
+static void spi1_runScript(const spi1_client_t *client, const uint8_t *script, uint16_t size)
+{
+    uint16_t i = 0;
+    while(i + 2 <= size)
+    {
+        uint8_t argCount = script[i + 1];
+        spi1_setDataMode(client, false);
+        spi1_exchangeByte(script[i]);
+        i += 2;
+        if(argCount > size - i)
+        {
+            argCount = size - i;
+        }
+        if(argCount > 0)
+        {
+            spi1_setDataMode(client, true);
+            spi1_writeBlock((void *)&script[i], argCount);
+            i += argCount;
+        }
+    }
+}
+
+static void spi1_runSteps(const spi1_client_t *client, const spi1_transaction_t *transaction)
+{
+    uint8_t i;
+    client->select(true);
+    for(i = 0; i < transaction->stepCount; i++)
+    {
+        const spi1_step_t *step = &transaction->steps[i];
+        uint16_t count = step->count;
+        switch(step->kind)
+        {
+            case SPI1_STEP_COMMAND:
+                spi1_setDataMode(client, false);
+                spi1_exchangeByte(step->command);
+                if(step->argCount > 0)
+                {
+                    spi1_setDataMode(client, true);
+                    spi1_writeBlock((void *)step->args, step->argCount);
+                }
+                break;
+            case SPI1_STEP_DATA:
+                spi1_setDataMode(client, true);
+                spi1_writeBlock((void *)step->data, count);
+                break;
+            case SPI1_STEP_SCRIPT:
+                spi1_runScript(client, step->data, count);
+                break;
+            default:
+                spi1_setDataMode(client, true);
+                while(count--)
+                {
+                    spi1_exchangeByte(step->word >> 8);
+                    spi1_exchangeByte(step->word & 0xFF);
+                }
+                break;
+        }
+    }
+}
+
+void spi1_transactionInit(spi1_transaction_t *transaction)
+{
+    transaction->stepCount = 0;
+}
+
+bool spi1_transactionCommand(spi1_transaction_t *transaction, uint8_t command, const uint8_t *args, uint8_t argCount)
+{
+    uint8_t i;
+    spi1_step_t *step;
+    if(argCount > SPI1_TRANSACTION_MAX_ARGS || (step = spi1_addStep(transaction, SPI1_STEP_COMMAND)) == NULL)
+    {
+        return false;
+    }
+    step->command = command;
+    step->argCount = argCount;
+    for(i = 0; i < argCount; i++)
+    {
+        step->args[i] = args[i];
+    }
+    return true;
+}
+
+bool spi1_transactionData(spi1_transaction_t *transaction, const void *block, uint16_t size)
+{
+    spi1_step_t *step = spi1_addStep(transaction, SPI1_STEP_DATA);
+    if(step == NULL)
+    {
+        return false;
+    }
+    step->data = block;
+    step->count = size;
+    return true;
+}
+
+bool spi1_transactionFill16(spi1_transaction_t *transaction, uint16_t word, uint16_t count)
+{
+    spi1_step_t *step = spi1_addStep(transaction, SPI1_STEP_FILL16);
+    if(step == NULL)
+    {
+        return false;
+    }
+    step->word = word;
+    step->count = count;
+    return true;
+}
+
+bool spi1_transactionScript(spi1_transaction_t *transaction, const uint8_t *script, uint16_t size)
+{
+    spi1_step_t *step = spi1_addStep(transaction, SPI1_STEP_SCRIPT);
+    if(step == NULL)
+    {
+        return false;
+    }
+    step->data = script;
+    step->count = size;
+    return true;
+}
+
+/* Marks the bus busy for `client`. A free bus is taken; an owned one only
+ * by its owner from the same context, and only with a stream open if
+ * `needStream`. */
+static bool spi1_enter(const spi1_client_t *client, bool needStream)
+{
+    uint16_t savedIpl;
+    bool entered;
+
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    if(owner == NULL)
+    {
+        entered = !needStream;
+    }
+    else
+    {
+        entered = !busy && owner == client && ownerIpl == savedIpl && (streamOpen || !needStream);
+    }
+    if(entered)
+    {
+        owner = client;
+        ownerIpl = savedIpl;
+        busy = true;
+    }
+    RESTORE_CPU_IPL(savedIpl);
+    return entered;
+}
+
+/* enters, ends the owner's open stream and enables the peripheral */
+static bool spi1_begin(const spi1_client_t *client)
+{
+    if(!spi1_enter(client, false))
+    {
+        return false;
+    }
+    if(streamOpen)
+    {
+        spi1_deselect(client);
+    }
+    spi1_open();
+    return true;
+}
+
+static void spi1_finish(const spi1_client_t *client)
+{
+    if(streamOpen)
+    {
+        spi1_deselect(client);
+    }
+    spi1_close();
+    owner = NULL;
+    busy = false;
+}
+
+bool spi1_acquire(const spi1_client_t *client)
+{
+    if(!spi1_begin(client))
+    {
+        return false;
+    }
+    busy = false;
+    return true;
+}
+
+void spi1_release(const spi1_client_t *client)
+{
+    if(owner != client || !spi1_enter(client, false))
+    {
+        return;
+    }
+    spi1_finish(client);
+}
+
+const spi1_client_t *spi1_owner(void)
+{
+    return owner;
+}
+
+bool spi1_execute(const spi1_client_t *client, const spi1_transaction_t *transaction)
+{
+    if(!spi1_begin(client))
+    {
+        return false;
+    }
+    spi1_runSteps(client, transaction);
+    spi1_deselect(client);
+    spi1_finish(client);
+    return true;
+}
+
+bool spi1_streamBegin(const spi1_client_t *client, const spi1_transaction_t *transaction, uint8_t tag)
+{
+    if(!spi1_begin(client))
+    {
+        return false;
+    }
+    spi1_runSteps(client, transaction);
+    spi1_setDataMode(client, true);
+    streamTag = tag;
+    streamOpen = true;
+    busy = false;
+    return true;
+}
+
+bool spi1_streamIsOpen(const spi1_client_t *client, uint8_t tag)
+{
+    return owner == client && streamOpen && streamTag == tag && !busy && ownerIpl == SRbits.IPL;
+}
+
+uint16_t spi1_streamExchange16(const spi1_client_t *client, uint16_t word)
+{
+    uint8_t high;
+    uint8_t low;
+    if(!spi1_enter(client, true))
+    {
+        return 0xFFFF;
+    }
+    high = spi1_exchangeByte(word >> 8);
+    low = spi1_exchangeByte(word & 0xFF);
+    busy = false;
+    return ((uint16_t)high) << 8 | low;
+}
+
+void spi1_streamEnd(const spi1_client_t *client)
+{
+    spi1_release(client);
+}
+
+void spi1_abort(void)
+{
+    const spi1_client_t *client = owner;
+    if(client)
+    {
+        spi1_deselect(client);
+    }
+    streamOpen = false;
+    spi1_close();
+    owner = NULL;
+    busy = false;
+}
@@ -0,0 +1,90 @@
+/*
+ * File: spi1_transaction.h
+ * Project: Smart Watch - Final Version
+ * Description: Transactions and bus arbitration on top of spi1_driver.
+ *
+ * A client describes how to drive its own chip select and D/C lines; the
+ * layer drives them, so no caller touches the pins directly. A transaction
+ * is a short list of steps (command + arguments, raw data, a 16-bit word
+ * repeated N times, a script of commands) built on the stack and executed
+ * under one chip-select assertion with the peripheral enabled once.
+ *
+ * One client owns the bus at a time. A transaction can be left open as a
+ * stream (CS asserted, D/C on data) for data produced piecemeal; another
+ * client that tries to take the bus meanwhile is refused instead of
+ * corrupting the stream, and should retry from the main loop. So is the
+ * owner itself when an interrupt it runs in preempted one of its own
+ * transactions.
+ */
+
+#ifndef SPI1_TRANSACTION_H
+#define SPI1_TRANSACTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SPI1_TRANSACTION_MAX_STEPS  4
+#define SPI1_TRANSACTION_MAX_ARGS   4
+
+typedef struct
+{
+    void (*select)(bool active);    /* assert (true) / release the chip select */
+    void (*dataMode)(bool data);    /* D/C line, NULL if the device has none */
+} spi1_client_t;
+
+typedef enum
+{
+    SPI1_STEP_COMMAND,
+    SPI1_STEP_DATA,
+    SPI1_STEP_FILL16,
+    SPI1_STEP_SCRIPT
+} spi1_step_kind_t;
+
+typedef struct
+{
+    uint8_t kind;
+    uint8_t command;
+    uint8_t argCount;
+    uint8_t args[SPI1_TRANSACTION_MAX_ARGS];
+    const uint8_t *data;
+    uint16_t word;
+    uint16_t count;                 /* data or script bytes, or words for a fill */
+} spi1_step_t;
+
+typedef struct
+{
+    uint8_t stepCount;
+    spi1_step_t steps[SPI1_TRANSACTION_MAX_STEPS];
+} spi1_transaction_t;
+
+/* building; each returns false once the transaction is full */
+void spi1_transactionInit(spi1_transaction_t *transaction);
+bool spi1_transactionCommand(spi1_transaction_t *transaction, uint8_t command, const uint8_t *args, uint8_t argCount);
+bool spi1_transactionData(spi1_transaction_t *transaction, const void *block, uint16_t size);
+bool spi1_transactionFill16(spi1_transaction_t *transaction, uint16_t word, uint16_t count);
+/* script: { command, argument count, arguments... } repeated, usually a
+ * const table; any number of commands for the cost of one step */
+bool spi1_transactionScript(spi1_transaction_t *transaction, const uint8_t *script, uint16_t size);
+
+/* arbitration; the owner may re-acquire, which ends its open stream, but
+ * only at the interrupt priority it took the bus at and never while a
+ * transaction or stream word is in flight */
+bool spi1_acquire(const spi1_client_t *client);
+void spi1_release(const spi1_client_t *client);
+const spi1_client_t *spi1_owner(void);
+
+/* acquire, run every step under one CS assertion, release */
+bool spi1_execute(const spi1_client_t *client, const spi1_transaction_t *transaction);
+
+/* as spi1_execute, but CS stays asserted with D/C on data until streamEnd;
+ * tag identifies the stream (e.g. the command that opened it) */
+bool spi1_streamBegin(const spi1_client_t *client, const spi1_transaction_t *transaction, uint8_t tag);
+/* false too in another context than the one that opened it */
+bool spi1_streamIsOpen(const spi1_client_t *client, uint8_t tag);
+uint16_t spi1_streamExchange16(const spi1_client_t *client, uint16_t word);
+void spi1_streamEnd(const spi1_client_t *client);
+
+/* releases the bus whoever owns it; for shutdown paths in interrupts */
+void spi1_abort(void);
+
+#endif // SPI1_TRANSACTION_H
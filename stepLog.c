@@ -0,0 +1,98 @@
+/*
+ * File: stepLog.c
+ * Project: Smart Watch - Final Version
+ * Description: Per-minute step counts packed into compressed history
+ *              blocks.
+ *
+ * Minutes are fed to a historyCodec encoder; a block is written as one
+ * history blob once it is full or spans HISTORY_CODEC_MAX_MINUTES, and a
+ * block without a single step is not written at all. The open block lives
+ * only in RAM, so a reset loses at most its minutes.
+ *
+ * Records written while a block is open carry later timestamps than its
+ * first minute, so the blob is stamped with the minute after its last one
+ * to keep the log in time order, and its payload starts with the number of
+ * minutes it holds.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "historyCodec.h"
+#include "historyStore.h"
+#include "stepLog.h"
+
+#if 1 + HISTORY_CODEC_BLOCK_BYTES > HISTORY_BLOB_MAX_BYTES
+#error "a step block must fit in one history blob"
+#endif
+
+static HistoryCodecEncoder encoder;
+static uint32_t blockStart;
+static uint32_t nextMinute;
+static bool blockOpen;
+static bool blockHasSteps;
+
+static void flushBlock(void) {
+    HistoryRecord header;
+    uint8_t payload[1 + HISTORY_CODEC_BLOCK_BYTES];
+    uint8_t length;
+
+    if (!blockOpen)
+        return;
+    blockOpen = false;
+    if (!blockHasSteps)
+        return;
+    length = historyCodecEncoderFinish(&encoder);
+    payload[0] = encoder.minutes;
+    memcpy(&payload[1], encoder.data, length);
+    header.type = HISTORY_RECORD_STEP_BLOCK;
+    header.timestamp = blockStart + encoder.minutes;
+    header.value = 1 + length;
+    historyStoreAppendBlob(&header, payload);
+}
+
+static void startBlock(uint32_t timestamp) {
+    historyCodecEncoderStart(&encoder);
+    blockStart = timestamp;
+    nextMinute = timestamp;
+    blockOpen = true;
+    blockHasSteps = false;
+}
+
+// A fresh block always takes a minute, so the retry cannot fail
+static void addToBlock(uint16_t count) {
+    if (!historyCodecEncodeMinute(&encoder, count)) {
+        flushBlock();
+        startBlock(nextMinute);
+        historyCodecEncodeMinute(&encoder, count);
+    }
+    if (count > 0)
+        blockHasSteps = true;
+    nextMinute++;
+}
+
+void stepLogAddMinute(uint32_t timestamp, uint16_t count) {
+    // The clock was set backwards, or far enough ahead that the gap would
+    // only fill the block with idle minutes
+    if (blockOpen && (timestamp < nextMinute || timestamp - blockStart >= HISTORY_CODEC_MAX_MINUTES))
+        flushBlock();
+    if (!blockOpen)
+        startBlock(timestamp);
+
+    while (nextMinute < timestamp)
+        addToBlock(0);
+    addToBlock(count);
+}
+
+uint8_t stepLogPending(uint32_t *start, uint8_t *data) {
+    HistoryCodecEncoder copy;
+    uint8_t length;
+
+    if (!blockOpen || !blockHasSteps)
+        return 0;
+    copy = encoder;
+    length = historyCodecEncoderFinish(&copy);
+    memcpy(data, copy.data, length);
+    *start = blockStart;
+    return length;
+}
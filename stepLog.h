@@ -0,0 +1,24 @@
+/*
+ * File: stepLog.h
+ * Project: Smart Watch - Final Version
+ * Description: Per-minute step counts packed into compressed history
+ *              blocks.
+ */
+
+#ifndef STEP_LOG_H
+#define STEP_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Adds the step count of the minute starting at timestamp (a
+// historyTimestamp). Call once per minute, zero minutes included; skipped
+// minutes are taken as idle. Writes a HISTORY_RECORD_STEP_BLOCK when the
+// block under construction fills up, so call from the main loop only.
+void stepLogAddMinute(uint32_t timestamp, uint16_t count);
+
+// Copies the block still held in RAM into data (HISTORY_BLOB_MAX_BYTES)
+// and returns its payload length, 0 when there is none.
+uint8_t stepLogPending(uint32_t *start, uint8_t *data);
+
+#endif // STEP_LOG_H
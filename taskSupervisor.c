@@ -0,0 +1,212 @@
+/*
+ * File: taskSupervisor.c
+ * Project: Smart Watch - Final Version
+ * Description: Per-task deadline and budget monitoring, and the watchdog
+ *              heartbeat.
+ *
+ * The watchdog is under software control (FWDTEN = SWON) with a period of
+ * about 16 s, far beyond any legitimate pass but short enough to recover
+ * a watch stuck waiting on a bus or a sensor. Nothing runs when it fires,
+ * so the task being run, or failing that the first one not checked in, is
+ * kept up to date in RAM that start-up leaves alone and read back after
+ * the reset. The seconds since the last clear are counted from the Timer1
+ * interrupt, which still runs while the main line is stuck, so a reset
+ * handler can save state a few seconds before the watchdog fires.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "System/delay.h"
+#include "taskSupervisor.h"
+
+#define RETAINED_MAGIC          0x5AFE
+
+typedef struct {
+    TaskStats stats;
+    uint32_t lastStart;
+    uint32_t startedAt;
+    bool armed;                 // lastStart is valid
+} Task;
+
+// Survives a watchdog reset; only trusted when WDTO says one happened
+typedef struct {
+    uint16_t magic;
+    uint16_t watchdogResets;
+    uint8_t runningTask;
+    uint8_t awaitedTask;
+} Retained;
+
+static Retained retained __attribute__((persistent));
+
+static uint32_t (*readTicks)(void);
+static Task tasks[TASK_COUNT];
+static uint16_t activeMask;
+static uint16_t checkedIn;
+static SupervisorStats totals;
+static void (*resetHandler)(void);
+static volatile uint8_t secondsSinceClear;
+static bool averted;
+
+static void offence(TaskId task) {
+    totals.lastOffender = task;
+}
+
+static void noteAwaited(void) {
+    uint16_t missing = activeMask & ~checkedIn;
+
+    retained.awaitedTask = TASK_NONE;
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        if (missing & TASK_BIT(i)) {
+            retained.awaitedTask = i;
+            break;
+        }
+    }
+}
+
+static void clearWatchdog(void) {
+    ClrWdt();
+    if (secondsSinceClear >= TASK_SUPERVISOR_WARNING_SECONDS)
+        averted = true;
+    secondsSinceClear = 0;
+    checkedIn = 0;
+}
+
+void taskSupervisorInit(uint32_t (*ticks)(void)) {
+    readTicks = ticks;
+    memset(tasks, 0, sizeof(tasks));
+    activeMask = 0;
+    checkedIn = 0;
+    memset(&totals, 0, sizeof(totals));
+    totals.lastOffender = TASK_NONE;
+    totals.watchdogCulprit = TASK_NONE;
+
+    if (RCONbits.WDTO && retained.magic == RETAINED_MAGIC) {
+        retained.watchdogResets++;
+        totals.watchdogCulprit = (retained.runningTask != TASK_NONE) ?
+                                 (TaskId)retained.runningTask : (TaskId)retained.awaitedTask;
+    } else {
+        retained.watchdogResets = 0;
+    }
+    RCONbits.WDTO = 0;
+    totals.watchdogResets = retained.watchdogResets;
+    retained.magic = RETAINED_MAGIC;
+    retained.runningTask = TASK_NONE;
+    retained.awaitedTask = TASK_NONE;
+
+    averted = false;
+    clearWatchdog();
+    RCONbits.SWDTEN = 1;
+}
+
+void taskSupervisorAdd(TaskId task, uint32_t periodTicks, uint32_t budgetTicks, bool active) {
+    memset(&tasks[task], 0, sizeof(tasks[task]));
+    tasks[task].stats.periodTicks = periodTicks;
+    tasks[task].stats.budgetTicks = budgetTicks;
+    taskSupervisorSetActive(task, active);
+}
+
+void taskSupervisorSetActive(TaskId task, bool active) {
+    if (active == ((activeMask & TASK_BIT(task)) != 0))
+        return;
+    if (active) {
+        activeMask |= TASK_BIT(task);
+        tasks[task].armed = false;
+    } else {
+        activeMask &= ~TASK_BIT(task);
+        checkedIn &= ~TASK_BIT(task);
+    }
+}
+
+uint16_t taskSupervisorSelect(uint16_t mask) {
+    uint16_t previous = activeMask;
+
+    for (uint8_t i = 0; i < TASK_COUNT; i++)
+        taskSupervisorSetActive((TaskId)i, (mask & TASK_BIT(i)) != 0);
+    return previous;
+}
+
+void taskSupervisorBegin(TaskId task) {
+    Task *entry = &tasks[task];
+    uint32_t now = readTicks();
+
+    if (entry->armed && now - entry->lastStart > entry->stats.periodTicks) {
+        if (entry->stats.missedDeadlines < UINT16_MAX)
+            entry->stats.missedDeadlines++;
+        if (totals.missedDeadlines < UINT16_MAX)
+            totals.missedDeadlines++;
+        offence(task);
+    }
+    entry->lastStart = now;
+    entry->startedAt = now;
+    entry->armed = true;
+    retained.runningTask = task;
+}
+
+void taskSupervisorEnd(TaskId task) {
+    Task *entry = &tasks[task];
+    uint32_t run = readTicks() - entry->startedAt;
+
+    retained.runningTask = TASK_NONE;
+    if (entry->stats.runs < UINT16_MAX)
+        entry->stats.runs++;
+    if (run > entry->stats.worstTicks)
+        entry->stats.worstTicks = run;
+    if (entry->stats.budgetTicks != 0 && run > entry->stats.budgetTicks) {
+        if (entry->stats.overruns < UINT16_MAX)
+            entry->stats.overruns++;
+        if (totals.overruns < UINT16_MAX)
+            totals.overruns++;
+        offence(task);
+    }
+
+    checkedIn |= TASK_BIT(task);
+    if ((checkedIn & activeMask) == activeMask)
+        clearWatchdog();
+    noteAwaited();
+}
+
+void taskSupervisorCheckIn(TaskId task) {
+    taskSupervisorBegin(task);
+    taskSupervisorEnd(task);
+}
+
+void taskSupervisorIdle(void) {
+    for (uint8_t i = 0; i < TASK_COUNT; i++) {
+        if (activeMask & TASK_BIT(i))
+            tasks[i].armed = false;
+    }
+    clearWatchdog();
+    noteAwaited();
+}
+
+void taskSupervisorIdleDelay(uint16_t ms) {
+    taskSupervisorIdle();
+    DELAY_milliseconds(ms);
+}
+
+void taskSupervisorSetResetHandler(void (*handler)(void)) {
+    resetHandler = handler;
+}
+
+void taskSupervisorSecondTick(void) {
+    if (!RCONbits.SWDTEN || secondsSinceClear >= TASK_SUPERVISOR_WARNING_SECONDS)
+        return;
+    if (++secondsSinceClear == TASK_SUPERVISOR_WARNING_SECONDS && resetHandler != NULL)
+        resetHandler();
+}
+
+bool taskSupervisorTakeAverted(void) {
+    bool result = averted;
+    averted = false;
+    return result;
+}
+
+void taskSupervisorTaskStats(TaskId task, TaskStats *stats) {
+    *stats = tasks[task].stats;
+}
+
+void taskSupervisorStats(SupervisorStats *stats) {
+    *stats = totals;
+}
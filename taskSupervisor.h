@@ -0,0 +1,97 @@
+/*
+ * File: taskSupervisor.h
+ * Project: Smart Watch - Final Version
+ * Description: Per-task deadline and budget monitoring, and the watchdog
+ *              heartbeat.
+ *
+ * Each task declares a period (the longest allowed gap between two of its
+ * starts) and an execution budget. A start later than the period is a
+ * missed deadline, a run longer than the budget an overrun; both are
+ * counted per task and the offender remembered. The hardware watchdog is
+ * cleared only once every active task has checked in since the last
+ * clear, so a loop that never returns resets the watch instead of hanging
+ * it, and the task it was stuck in is reported after the reset.
+ */
+
+#ifndef TASK_SUPERVISOR_H
+#define TASK_SUPERVISOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    TASK_MAIN_LOOP,             // heartbeat at the top of every pass
+    TASK_ACCEL_EVENTS,
+    TASK_I2C_SCHEDULER,
+    TASK_HISTORY_EXPORT,
+    TASK_CLOCK_FACE,            // step detection and redraw, clock face only
+    TASK_UI_PAGE,               // blocking menu pages, while one is open
+    TASK_COUNT,
+    TASK_NONE = 0xFF
+} TaskId;
+
+#define TASK_BIT(task)          (1U << (task))
+
+// Well inside the watchdog period even with the LPRC at its slowest
+#define TASK_SUPERVISOR_WARNING_SECONDS 12
+
+typedef struct {
+    uint32_t periodTicks;
+    uint32_t budgetTicks;       // 0 for a heartbeat with no run time
+    uint32_t worstTicks;        // longest run
+    uint16_t runs;
+    uint16_t overruns;
+    uint16_t missedDeadlines;
+} TaskStats;
+
+typedef struct {
+    uint16_t overruns;          // all tasks
+    uint16_t missedDeadlines;
+    TaskId lastOffender;        // of the latest overrun or miss
+    uint16_t watchdogResets;    // since power-up
+    TaskId watchdogCulprit;     // blamed for the latest one
+} SupervisorStats;
+
+// Records a watchdog reset that just happened and enables the watchdog.
+// ticks returns a monotonic time in Timer1 ticks.
+void taskSupervisorInit(uint32_t (*ticks)(void));
+
+void taskSupervisorAdd(TaskId task, uint32_t periodTicks, uint32_t budgetTicks, bool active);
+
+// Only active tasks are waited for. A task made active again gets a fresh
+// deadline, so the time it was parked is not a miss.
+void taskSupervisorSetActive(TaskId task, bool active);
+
+// Makes exactly the tasks in activeMask active; returns the previous mask
+uint16_t taskSupervisorSelect(uint16_t activeMask);
+
+// Around one run of a task; End is the check-in
+void taskSupervisorBegin(TaskId task);
+void taskSupervisorEnd(TaskId task);
+
+// A run with no execution time of its own, for heartbeats and poll loops
+void taskSupervisorCheckIn(TaskId task);
+
+// For waits on the wearer, such as a button still held: counts as a
+// check-in of every active task, without a missed deadline after the
+// wait, so holding a button never trips the watchdog
+void taskSupervisorIdle(void);
+
+// One poll step of such a wait: taskSupervisorIdle, then ms of delay
+void taskSupervisorIdleDelay(uint16_t ms);
+
+// handler runs once, from the Timer1 interrupt, when the watchdog has
+// gone unserved for TASK_SUPERVISOR_WARNING_SECONDS and is about to reset
+// the watch, so state can be saved first
+void taskSupervisorSetResetHandler(void (*handler)(void));
+
+// Call once a second from the Timer1 interrupt
+void taskSupervisorSecondTick(void);
+
+// True once after a stall that ran the reset handler ended without a reset
+bool taskSupervisorTakeAverted(void);
+
+void taskSupervisorTaskStats(TaskId task, TaskStats *stats);
+void taskSupervisorStats(SupervisorStats *stats);
+
+#endif // TASK_SUPERVISOR_H
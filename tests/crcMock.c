@@ -0,0 +1,85 @@
+/*
+ * File: crcMock.c
+ * Project: Smart Watch - Final Version
+ * Description: Register model of the programmable CRC module.
+ *
+ * The shift register is augmented: every data bit enters at the low end
+ * and the polynomial is applied when a one leaves the top, LSb of the
+ * entry first with LENDIAN set.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests/crcMock.h"
+
+// Waits on a flag that stays put this long are taken as a hang
+#define CRC_MOCK_IDLE_LIMIT 1000000UL
+
+static CrcMockRegisters registers;
+static volatile uint16_t dataEntry;
+static bool entryWritten;
+static uint16_t entries;
+static uint32_t idleAccesses;
+
+static void shiftEntry(uint16_t entry) {
+    uint8_t width = registers.con2Bits.PLEN + 1;
+    uint8_t bits = registers.con2Bits.DWIDTH + 1;
+    uint32_t mask = (width >= 32) ? 0xFFFFFFFFUL : ((1UL << width) - 1);
+    uint32_t polynomial = ((uint32_t)registers.xorHigh << 16) | registers.xorLow;
+    uint32_t value = ((uint32_t)registers.shiftHigh << 16) | registers.shiftLow;
+
+    for (uint8_t i = 0; i < bits; i++) {
+        uint8_t bit = registers.con1Bits.LENDIAN ? (entry >> i) & 1 : (entry >> (bits - 1 - i)) & 1;
+        bool feedback = (value >> (width - 1)) & 1;
+        value = ((value << 1) | bit) & mask;
+        if (feedback)
+            value ^= polynomial & mask;
+    }
+    registers.shiftLow = (uint16_t)value;
+    registers.shiftHigh = (uint16_t)(value >> 16);
+    entries++;
+}
+
+// Completes a pending write before the register is touched
+static void settle(void) {
+    if (entryWritten) {
+        entryWritten = false;
+        idleAccesses = 0;
+        if (registers.con1Bits.CRCEN) {
+            shiftEntry(dataEntry);
+            if (registers.con1Bits.CRCISEL == 0)
+                registers.ifs4Bits.CRCIF = 1;
+        }
+    } else if (++idleAccesses > CRC_MOCK_IDLE_LIMIT) {
+        printf("crcMock: waiting on a flag that never changes\n");
+        exit(1);
+    }
+    registers.con1Bits.CRCFUL = 0;
+    registers.con1Bits.CRCMPT = 1;
+}
+
+CrcMockRegisters *crcMockRegisters(void) {
+    settle();
+    return &registers;
+}
+
+volatile uint16_t *crcMockData(void) {
+    settle();
+    dataEntry = 0;
+    entryWritten = true;
+    return &dataEntry;
+}
+
+void crcMockReset(void) {
+    memset(&registers, 0, sizeof(registers));
+    entryWritten = false;
+    entries = 0;
+    idleAccesses = 0;
+}
+
+uint16_t crcMockEntries(void) {
+    return entries;
+}
@@ -0,0 +1,54 @@
+/*
+ * File: crcMock.h
+ * Project: Smart Watch - Final Version
+ * Description: Register model of the programmable CRC module, so the host
+ *              tests can run System/crc.c itself. tests/host/xc.h maps the
+ *              CRC registers and IFS4 onto it.
+ *
+ * An entry written to CRCDATL is shifted in full before the next register
+ * access, so the FIFO is never seen full and CRCIF sets as soon as the
+ * shifter is done, the fastest the device can be. A loop that waits for a
+ * flag which can no longer change makes the test fail instead of hang.
+ */
+
+#ifndef CRC_MOCK_H
+#define CRC_MOCK_H
+
+#include <stdint.h>
+
+typedef struct {
+    unsigned CRCEN : 1;
+    unsigned CRCGO : 1;
+    unsigned CRCISEL : 1;
+    unsigned LENDIAN : 1;
+    unsigned CRCFUL : 1;
+    unsigned CRCMPT : 1;
+} CrcMockCon1Bits;
+
+typedef struct {
+    union {
+        uint16_t con1;
+        CrcMockCon1Bits con1Bits;
+    };
+    struct {
+        unsigned PLEN : 5;
+        unsigned DWIDTH : 5;
+    } con2Bits;
+    uint16_t xorLow;
+    uint16_t xorHigh;
+    uint16_t shiftLow;
+    uint16_t shiftHigh;
+    struct {
+        unsigned CRCIF : 1;
+    } ifs4Bits;
+} CrcMockRegisters;
+
+// Every register access goes through one of these
+CrcMockRegisters *crcMockRegisters(void);
+volatile uint16_t *crcMockData(void);
+
+// Clears the registers and the count of entries shifted
+void crcMockReset(void);
+uint16_t crcMockEntries(void);
+
+#endif // CRC_MOCK_H
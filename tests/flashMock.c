@@ -0,0 +1,66 @@
+/*
+ * File: flashMock.c
+ * Project: Smart Watch - Final Version
+ * Description: RAM-backed program flash for the host tests.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "System/crc.h"
+#include "tests/flashMock.h"
+
+#define FLASH_MOCK_WORDS    (FLASH_MOCK_PAGES * FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS)
+
+static uint16_t words[FLASH_MOCK_WORDS];
+
+void flashMockReset(void) {
+    for (uint32_t i = 0; i < FLASH_MOCK_WORDS; i++)
+        words[i] = FLASH_ERASED_WORD16;
+}
+
+void flashMockCorrupt(uint32_t address, uint16_t value) {
+    if (address / 2 < FLASH_MOCK_WORDS)
+        words[address / 2] = value;
+}
+
+bool FLASH_ErasePage(uint32_t address) {
+    uint32_t first = FLASH_GetErasePageAddress(address) / 2;
+
+    if (first >= FLASH_MOCK_WORDS)
+        return false;
+    for (uint32_t i = 0; i < FLASH_ERASE_PAGE_SIZE_IN_INSTRUCTIONS; i++)
+        words[first + i] = FLASH_ERASED_WORD16;
+    return true;
+}
+
+bool FLASH_WriteDoubleWord16(uint32_t address, uint16_t data0, uint16_t data1) {
+    uint32_t index = address / 2;
+
+    if ((address & 3) != 0 || index + 1 >= FLASH_MOCK_WORDS ||
+        words[index] != FLASH_ERASED_WORD16 || words[index + 1] != FLASH_ERASED_WORD16)
+        return false;
+    words[index] = data0;
+    words[index + 1] = data1;
+    return true;
+}
+
+uint16_t FLASH_ReadWord16(uint32_t address) {
+    return (address / 2 < FLASH_MOCK_WORDS) ? words[address / 2] : FLASH_ERASED_WORD16;
+}
+
+uint32_t FLASH_GetErasePageAddress(uint32_t address) {
+    return address & ~(uint32_t)(FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS - 1);
+}
+
+uint16_t FLASH_GetErasePageOffset(uint32_t address) {
+    return address & (FLASH_ERASE_PAGE_SIZE_IN_PC_UNITS - 1);
+}
+
+// The CRC engine is hardware too; the software path gives the same values
+uint32_t CRC_Calculate(const CRC_CONFIG *config, const uint8_t *data, uint16_t length) {
+    CRC_SOFT_STATE state;
+
+    CRC_SoftStart(&state, config);
+    CRC_SoftUpdate(&state, data, length);
+    return CRC_SoftFinish(&state);
+}
@@ -0,0 +1,26 @@
+/*
+ * File: flashMock.h
+ * Project: Smart Watch - Final Version
+ * Description: RAM-backed program flash for the host tests, implementing
+ *              System/flash.h and CRC_Calculate from System/crc.h.
+ *
+ * Like the device, a double-word can only be programmed once after an
+ * erase; a second write fails and leaves the words alone.
+ */
+
+#ifndef FLASH_MOCK_H
+#define FLASH_MOCK_H
+
+#include <stdint.h>
+#include "System/flash.h"
+
+#define FLASH_MOCK_PAGES    8
+
+// Erases every page, as on a freshly programmed part
+void flashMockReset(void);
+
+// Overwrites one instruction word, ignoring the write-once rule, to
+// simulate damage
+void flashMockCorrupt(uint32_t address, uint16_t value);
+
+#endif // FLASH_MOCK_H
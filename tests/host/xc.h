@@ -0,0 +1,36 @@
+/*
+ * File: xc.h
+ * Project: Smart Watch - Final Version
+ * Description: Host stand-in for the XC16 device header, enough for the
+ *              modules the host tests build. Put tests/host on the include
+ *              path ahead of the compiler's own headers.
+ */
+
+#ifndef HOST_XC_H
+#define HOST_XC_H
+
+#include <stdint.h>
+
+// Program-memory placement means nothing on the host: the flash mock
+// addresses its own array from zero
+#define space(section)
+#define noload
+#define __builtin_tbladdress(object)    ((void)(object), 0UL)
+
+// No interrupts on the host
+#define SET_AND_SAVE_CPU_IPL(saved, ipl)    ((saved) = 0)
+#define RESTORE_CPU_IPL(saved)              ((void)(saved))
+
+// The CRC module, modelled by tests/crcMock.c
+#include "tests/crcMock.h"
+#define CRCCON1L        (crcMockRegisters()->con1)
+#define CRCCON1Lbits    (crcMockRegisters()->con1Bits)
+#define CRCCON2Lbits    (crcMockRegisters()->con2Bits)
+#define CRCXORL         (crcMockRegisters()->xorLow)
+#define CRCXORH         (crcMockRegisters()->xorHigh)
+#define CRCWDATL        (crcMockRegisters()->shiftLow)
+#define CRCWDATH        (crcMockRegisters()->shiftHigh)
+#define CRCDATL         (*crcMockData())
+#define IFS4bits        (crcMockRegisters()->ifs4Bits)
+
+#endif // HOST_XC_H
@@ -0,0 +1,40 @@
+/*
+ * File: hostTest.h
+ * Project: Smart Watch - Final Version
+ * Description: Minimal checks for the host-side tests. Each test is one
+ *              program that prints its failures and exits non-zero if there
+ *              were any; runHostTests.sh builds and runs them all.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+static int hostTestFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            hostTestFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQUAL(actual, expected) \
+    do { \
+        unsigned long actualValue = (unsigned long)(actual); \
+        unsigned long expectedValue = (unsigned long)(expected); \
+        if (actualValue != expectedValue) { \
+            printf("%s:%d: %s is 0x%lX, expected 0x%lX\n", __FILE__, __LINE__, \
+                   #actual, actualValue, expectedValue); \
+            hostTestFailures++; \
+        } \
+    } while (0)
+
+static int hostTestResult(const char *name) {
+    printf("%s: %s\n", name, hostTestFailures ? "FAILED" : "passed");
+    return hostTestFailures ? 1 : 0;
+}
+
+#endif // HOST_TEST_H
@@ -0,0 +1,30 @@
+#!/bin/sh
+# Builds and runs the host tests. Run from the project root:
+#   sh tests/runHostTests.sh
+# Exits non-zero if any test fails to build or fails.
+
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:-"-O2 -Wall -I."}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+status=0
+
+run() {
+    name=$1
+    shift
+    if $CC $CFLAGS -o "$OUT/$name" "$@"; then
+        "$OUT/$name" || status=1
+    else
+        echo "$name: build FAILED"
+        status=1
+    fi
+}
+
+run testCrc tests/testCrc.c System/crc_soft.c
+run testCrcEngine -Itests/host tests/testCrcEngine.c System/crc.c System/crc_soft.c tests/crcMock.c
+run testFallDetector -DACCEL_SENSOR=2 tests/testFallDetector.c fallDetector.c accelMock.c
+run testHistoryStore -Itests/host tests/testHistoryStore.c historyStore.c tests/flashMock.c System/crc_soft.c
+run testHistoryCodec -Itests/host tests/testHistoryCodec.c historyCodec.c historyStore.c tests/flashMock.c System/crc_soft.c
+run testHistoryExport -Itests/host tests/testHistoryExport.c historyExport.c historyStore.c tests/flashMock.c tests/uartMock.c System/crc_soft.c
+
+exit $status
@@ -0,0 +1,80 @@
+/*
+ * File: testCrc.c
+ * Project: Smart Watch - Final Version
+ * Description: Host test of the software CRC, the fallback the firmware
+ *              uses whenever the CRC engine is busy.
+ *
+ * Build and run from the project root:
+ *   gcc -O2 -I. -o testCrc tests/testCrc.c System/crc_soft.c && ./testCrc
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "System/crc.h"
+#include "tests/hostTest.h"
+
+static const uint8_t CHECK_INPUT[] = "123456789";
+
+static uint32_t softCrc(const CRC_CONFIG *config, const uint8_t *data, uint16_t length) {
+    CRC_SOFT_STATE state;
+    CRC_SoftStart(&state, config);
+    CRC_SoftUpdate(&state, data, length);
+    return CRC_SoftFinish(&state);
+}
+
+// Feeding the data in pieces must give the one-shot result
+static uint32_t softCrcChunked(const CRC_CONFIG *config, const uint8_t *data, uint16_t length,
+                               uint16_t chunk) {
+    CRC_SOFT_STATE state;
+    CRC_SoftStart(&state, config);
+    while (length > 0) {
+        uint16_t part = length < chunk ? length : chunk;
+        CRC_SoftUpdate(&state, data, part);
+        data += part;
+        length -= part;
+    }
+    return CRC_SoftFinish(&state);
+}
+
+int main(void) {
+    uint8_t block[300];
+
+    // Catalogue check values over "123456789"
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CCITT16, CHECK_INPUT, 9), 0x29B1);
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CRC32, CHECK_INPUT, 9), 0xCBF43926UL);
+
+    // Nothing fed: the seed after the final XOR
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CCITT16, CHECK_INPUT, 0), 0xFFFF);
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CRC32, CHECK_INPUT, 0), 0x00000000UL);
+
+    // One-byte messages, which the engine finishes from a pending byte
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CCITT16, CHECK_INPUT, 1), 0xC782);
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CRC32, CHECK_INPUT, 1), 0x83DCEFB7UL);
+    block[0] = 0;
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CCITT16, block, 1), 0xE1F0);
+    CHECK_EQUAL(softCrc(&CRC_CONFIG_CRC32, block, 1), 0xD202EF8DUL);
+    CHECK_EQUAL(softCrcChunked(&CRC_CONFIG_CRC32, CHECK_INPUT, 9, 1), 0xCBF43926UL);
+
+    for (uint16_t i = 0; i < sizeof(block); i++)
+        block[i] = (uint8_t)(i * 37 + 11);
+    for (uint16_t chunk = 1; chunk <= 17; chunk += 4) {
+        CHECK_EQUAL(softCrcChunked(&CRC_CONFIG_CCITT16, block, sizeof(block), chunk),
+                    softCrc(&CRC_CONFIG_CCITT16, block, sizeof(block)));
+        CHECK_EQUAL(softCrcChunked(&CRC_CONFIG_CRC32, block, sizeof(block), chunk),
+                    softCrc(&CRC_CONFIG_CRC32, block, sizeof(block)));
+    }
+
+    // A single flipped bit changes both
+    {
+        uint32_t ccitt = softCrc(&CRC_CONFIG_CCITT16, block, sizeof(block));
+        uint32_t crc32 = softCrc(&CRC_CONFIG_CRC32, block, sizeof(block));
+        block[100] ^= 0x04;
+        CHECK(softCrc(&CRC_CONFIG_CCITT16, block, sizeof(block)) != ccitt);
+        CHECK(softCrc(&CRC_CONFIG_CRC32, block, sizeof(block)) != crc32);
+    }
+
+    CHECK_EQUAL(CRC_Reflect(0x1, 16), 0x8000);
+    CHECK_EQUAL(CRC_Reflect(0x04C11DB7UL, 32), 0xEDB88320UL);
+
+    return hostTestResult("testCrc");
+}
@@ -0,0 +1,92 @@
+/*
+ * File: testCrcEngine.c
+ * Project: Smart Watch - Final Version
+ * Description: Host test of the hardware CRC driver against a register
+ *              model of the module; it must match the software CRC for
+ *              any length and any split into chunks.
+ *
+ * Build and run from the project root:
+ *   gcc -O2 -I. -Itests/host -o testCrcEngine tests/testCrcEngine.c \
+ *       System/crc.c System/crc_soft.c tests/crcMock.c && ./testCrcEngine
+ */
+
+#include <stdint.h>
+#include "System/crc.h"
+#include "tests/crcMock.h"
+#include "tests/hostTest.h"
+
+static const uint8_t CHECK_INPUT[] = "123456789";
+
+static uint32_t softCrc(const CRC_CONFIG *config, const uint8_t *data, uint16_t length) {
+    CRC_SOFT_STATE state;
+    CRC_SoftStart(&state, config);
+    CRC_SoftUpdate(&state, data, length);
+    return CRC_SoftFinish(&state);
+}
+
+static uint32_t engineCrcChunked(const CRC_CONFIG *config, const uint8_t *data, uint16_t length,
+                                 uint16_t chunk) {
+    CHECK(CRC_Start(config));
+    while (length > 0) {
+        uint16_t part = length < chunk ? length : chunk;
+        CRC_Update(data, part);
+        data += part;
+        length -= part;
+    }
+    return CRC_Finish();
+}
+
+static void testCheckValues(void) {
+    crcMockReset();
+    CHECK_EQUAL(CRC_Calculate(&CRC_CONFIG_CCITT16, CHECK_INPUT, 9), 0x29B1);
+    CHECK_EQUAL(CRC_Calculate(&CRC_CONFIG_CRC32, CHECK_INPUT, 9), 0xCBF43926UL);
+    CHECK(crcMockEntries() > 0);            // the engine did the work
+}
+
+// A message of one byte leaves nothing shifted before the width change
+static void testOneByte(void) {
+    crcMockReset();
+    CHECK_EQUAL(CRC_Calculate(&CRC_CONFIG_CCITT16, CHECK_INPUT, 1), 0xC782);
+    CHECK_EQUAL(CRC_Calculate(&CRC_CONFIG_CRC32, CHECK_INPUT, 1), 0x83DCEFB7UL);
+}
+
+static void testEmpty(void) {
+    crcMockReset();
+    CHECK_EQUAL(CRC_Calculate(&CRC_CONFIG_CCITT16, CHECK_INPUT, 0), 0xFFFF);
+    CHECK_EQUAL(CRC_Calculate(&CRC_CONFIG_CRC32, CHECK_INPUT, 0), 0x00000000UL);
+}
+
+static void testMatchesSoftware(void) {
+    uint8_t block[40];
+
+    for (uint16_t i = 0; i < sizeof(block); i++)
+        block[i] = (uint8_t)(i * 37 + 11);
+    crcMockReset();
+    for (uint16_t length = 0; length <= sizeof(block); length++) {
+        for (uint16_t chunk = 1; chunk <= 5; chunk++) {
+            CHECK_EQUAL(engineCrcChunked(&CRC_CONFIG_CCITT16, block, length, chunk),
+                        softCrc(&CRC_CONFIG_CCITT16, block, length));
+            CHECK_EQUAL(engineCrcChunked(&CRC_CONFIG_CRC32, block, length, chunk),
+                        softCrc(&CRC_CONFIG_CRC32, block, length));
+        }
+    }
+}
+
+// An interrupt finding the engine taken falls back to software
+static void testBusyFallsBack(void) {
+    crcMockReset();
+    CHECK(CRC_Start(&CRC_CONFIG_CRC32));
+    CHECK(!CRC_Start(&CRC_CONFIG_CCITT16));
+    CHECK_EQUAL(CRC_Calculate(&CRC_CONFIG_CCITT16, CHECK_INPUT, 9), 0x29B1);
+    CRC_Update(CHECK_INPUT, 9);
+    CHECK_EQUAL(CRC_Finish(), 0xCBF43926UL);
+}
+
+int main(void) {
+    testCheckValues();
+    testOneByte();
+    testEmpty();
+    testMatchesSoftware();
+    testBusyFallsBack();
+    return hostTestResult("testCrcEngine");
+}
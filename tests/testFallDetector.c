@@ -0,0 +1,133 @@
+/*
+ * File: testFallDetector.c
+ * Project: Smart Watch - Final Version
+ * Description: Host test of the fall detector driven through accelSensor.h
+ *              with the scripted mock backend, in the order main.c's
+ *              serviceAccelerometerEvents feeds it: drain the FIFO, then
+ *              service the interrupt source, on every pass.
+ *
+ * Build and run from the project root:
+ *   gcc -O2 -I. -DACCEL_SENSOR=2 -o testFallDetector tests/testFallDetector.c \
+ *       fallDetector.c accelMock.c && ./testFallDetector
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "accelSensor.h"
+#include "fallDetector.h"
+#include "tests/hostTest.h"
+
+#define ONE_G_LSB       (1000 / ACCEL_MG_PER_LSB)
+
+static const AccelTapConfig TAP_CONFIG = {3000, 10, 100, 250, ACCEL_AXIS_Z};
+
+// One main-loop pass: drain the FIFO, then read the latched sources, so
+// whatever was queued when the free fall was reported counts before it
+static void servicePass(void) {
+    AccelSample sample;
+    uint8_t entries = accelSensorFifoEntries();
+
+    while (entries-- > 0 && accelSensorReadSample(&sample))
+        fallDetectorAddSample(&sample);
+    if (accelSensorInterruptPending() &&
+        (accelSensorReadInterruptSource() & ACCEL_INT_FREE_FALL))
+        fallDetectorTrigger();
+}
+
+static void pushSamples(uint8_t count, int16_t z) {
+    while (count-- > 0) {
+        accelMockPushSample(0, 0, z);
+        if (accelSensorFifoEntries() >= ACCEL_FIFO_DEPTH / 2)
+            servicePass();
+    }
+}
+
+static void setUp(void) {
+    CHECK(accelSensorInit());
+    CHECK(accelSensorConfigureFifo(ACCEL_FIFO_STREAM, 0));
+    CHECK(fallDetectorInit());
+    CHECK(accelSensorConfigureTap(&TAP_CONFIG));
+}
+
+static void testInterfaceEnablesDetectors(void) {
+    setUp();
+    CHECK(accelSensorEnabledInterrupts() & ACCEL_INT_FREE_FALL);
+    CHECK(accelSensorEnabledInterrupts() & ACCEL_INT_SINGLE_TAP);
+    CHECK(accelSensorEnabledInterrupts() & ACCEL_INT_DOUBLE_TAP);
+}
+
+static void testFallWithImpact(void) {
+    AccelSample capture[FALL_CAPTURE_SAMPLES];
+
+    setUp();
+    pushSamples(40, ONE_G_LSB);             // standing
+    pushSamples(10, 0);                     // falling
+    accelMockRaiseInterrupt(ACCEL_INT_FREE_FALL);
+    servicePass();
+    pushSamples(5, 0);
+    pushSamples(1, 3 * ONE_G_LSB);          // 3 g impact
+    pushSamples(FALL_POST_TRIGGER_SAMPLES, ONE_G_LSB);
+    servicePass();
+
+    CHECK(fallDetectorTakeConfirmed());
+    CHECK(!fallDetectorTakeConfirmed());    // reported once
+    CHECK_EQUAL(fallDetectorPeakMg(), 3000);
+
+    // The pre-trigger part ends with the free-fall samples
+    fallDetectorCopyCapture(capture);
+    CHECK_EQUAL(capture[FALL_PRE_TRIGGER_SAMPLES - 1].z, 0);
+    CHECK_EQUAL(capture[0].z, ONE_G_LSB);
+}
+
+// The whole fall is still queued when INT1 reports it
+static void testTriggerAfterQueuedFall(void) {
+    AccelSample capture[FALL_CAPTURE_SAMPLES];
+
+    setUp();
+    pushSamples(30, ONE_G_LSB);
+    servicePass();
+    for (uint8_t i = 0; i < 12; i++)
+        accelMockPushSample(0, 0, 0);
+    accelMockRaiseInterrupt(ACCEL_INT_FREE_FALL);
+    servicePass();
+    pushSamples(1, 3 * ONE_G_LSB);
+    pushSamples(FALL_POST_TRIGGER_SAMPLES, ONE_G_LSB);
+    servicePass();
+
+    CHECK(fallDetectorTakeConfirmed());
+    fallDetectorCopyCapture(capture);
+    CHECK_EQUAL(capture[FALL_PRE_TRIGGER_SAMPLES - 12].z, 0);
+    CHECK_EQUAL(capture[FALL_PRE_TRIGGER_SAMPLES - 13].z, ONE_G_LSB);
+    CHECK_EQUAL(capture[FALL_PRE_TRIGGER_SAMPLES].z, 3 * ONE_G_LSB);
+}
+
+static void testFallWithoutImpact(void) {
+    setUp();
+    pushSamples(40, ONE_G_LSB);
+    pushSamples(10, 0);
+    accelMockRaiseInterrupt(ACCEL_INT_FREE_FALL);
+    servicePass();
+    pushSamples(FALL_POST_TRIGGER_SAMPLES + 10, ONE_G_LSB);
+    servicePass();
+
+    CHECK(!fallDetectorTakeConfirmed());
+}
+
+static void testNoTriggerNoFall(void) {
+    setUp();
+    pushSamples(20, ONE_G_LSB);
+    pushSamples(1, 4 * ONE_G_LSB);          // a knock, but no free fall
+    pushSamples(FALL_POST_TRIGGER_SAMPLES, ONE_G_LSB);
+    servicePass();
+
+    CHECK(!fallDetectorTakeConfirmed());
+}
+
+int main(void) {
+    testInterfaceEnablesDetectors();
+    testFallWithImpact();
+    testTriggerAfterQueuedFall();
+    testFallWithoutImpact();
+    testNoTriggerNoFall();
+    return hostTestResult("testFallDetector");
+}
@@ -0,0 +1,224 @@
+/*
+ * File: testHistoryCodec.c
+ * Project: Smart Watch - Final Version
+ * Description: Host test of the step-count codec: round trips, token sizes
+ *              at the varint boundaries, full blocks, malformed payloads,
+ *              and a block stored as a history blob with its CRC damaged.
+ *
+ * Build and run from the project root:
+ *   gcc -O2 -Itests/host -I. -o testHistoryCodec tests/testHistoryCodec.c \
+ *       historyCodec.c historyStore.c tests/flashMock.c System/crc_soft.c && ./testHistoryCodec
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "historyCodec.h"
+#include "historyStore.h"
+#include "tests/flashMock.h"
+#include "tests/hostTest.h"
+
+#define BASE    1000UL
+
+// Expands the segments of a payload back into per-minute counts
+static uint16_t decodeAll(const uint8_t *data, uint8_t length, uint16_t *counts) {
+    HistoryCodecDecoder decoder;
+    HistoryCodecSegment segment;
+    uint32_t expected = BASE;
+    uint16_t minutes = 0;
+
+    historyCodecDecoderStart(&decoder, BASE, data, length);
+    while (historyCodecDecodeNext(&decoder, &segment)) {
+        CHECK_EQUAL(segment.timestamp, expected);
+        CHECK(segment.minutes == 1 || segment.count == 0);
+        for (uint16_t i = 0; i < segment.minutes && minutes < HISTORY_CODEC_MAX_MINUTES; i++)
+            counts[minutes++] = segment.count;
+        expected += segment.minutes;
+    }
+    CHECK_EQUAL(decoder.position, length);      // stopped at the end, not on an error
+    return minutes;
+}
+
+static void checkRoundTrip(const uint16_t *counts, uint16_t minutes) {
+    HistoryCodecEncoder encoder;
+    uint16_t decoded[HISTORY_CODEC_MAX_MINUTES];
+    uint8_t length;
+
+    historyCodecEncoderStart(&encoder);
+    for (uint16_t i = 0; i < minutes; i++)
+        CHECK(historyCodecEncodeMinute(&encoder, counts[i]));
+    length = historyCodecEncoderFinish(&encoder);
+    CHECK_EQUAL(encoder.minutes, minutes);
+    CHECK_EQUAL(decodeAll(encoder.data, length, decoded), minutes);
+    CHECK(memcmp(decoded, counts, minutes * sizeof(counts[0])) == 0);
+}
+
+// Bytes one more minute of count costs after a minute of previous
+static uint8_t literalSize(uint16_t previous, uint16_t count) {
+    HistoryCodecEncoder encoder;
+    uint8_t before;
+
+    historyCodecEncoderStart(&encoder);
+    CHECK(historyCodecEncodeMinute(&encoder, previous));
+    before = encoder.length;
+    CHECK(historyCodecEncodeMinute(&encoder, count));
+    return encoder.length - before;
+}
+
+// Bytes an idle run costs
+static uint8_t runSize(uint16_t minutes) {
+    HistoryCodecEncoder encoder;
+
+    historyCodecEncoderStart(&encoder);
+    for (uint16_t i = 0; i < minutes; i++)
+        CHECK(historyCodecEncodeMinute(&encoder, 0));
+    return historyCodecEncoderFinish(&encoder);
+}
+
+static void testEmptyBlock(void) {
+    HistoryCodecEncoder encoder;
+    uint16_t decoded[1];
+
+    historyCodecEncoderStart(&encoder);
+    CHECK_EQUAL(historyCodecEncoderFinish(&encoder), 0);
+    CHECK_EQUAL(decodeAll(encoder.data, 0, decoded), 0);
+}
+
+static void testLongestRun(void) {
+    static const uint16_t IDLE[HISTORY_CODEC_MAX_MINUTES];
+    HistoryCodecEncoder encoder;
+
+    checkRoundTrip(IDLE, HISTORY_CODEC_MAX_MINUTES);
+    CHECK_EQUAL(runSize(HISTORY_CODEC_MAX_MINUTES), 2);
+
+    // No block spans more minutes, idle or not
+    historyCodecEncoderStart(&encoder);
+    for (uint16_t i = 0; i < HISTORY_CODEC_MAX_MINUTES; i++)
+        CHECK(historyCodecEncodeMinute(&encoder, 0));
+    CHECK(!historyCodecEncodeMinute(&encoder, 0));
+    CHECK(!historyCodecEncodeMinute(&encoder, 7));
+    CHECK_EQUAL(historyCodecEncoderFinish(&encoder), 2);
+}
+
+static void testNegativeDeltas(void) {
+    static const uint16_t COUNTS[] = {500, 100, 3, 65535, 1, 0, 0, 90, 89, 60000, 2};
+    checkRoundTrip(COUNTS, sizeof(COUNTS) / sizeof(COUNTS[0]));
+}
+
+// A literal token is the zig-zagged delta shifted left once, so one byte
+// holds deltas of -32..31 and two bytes -4096..4095; a run token holds
+// runs of up to 64 minutes in one byte
+static void testVarintBoundaries(void) {
+    static const uint16_t COUNTS[] = {100, 131, 99, 67, 35, 4131, 35, 4131, 35};
+
+    CHECK_EQUAL(literalSize(100, 131), 1);
+    CHECK_EQUAL(literalSize(100, 132), 2);
+    CHECK_EQUAL(literalSize(100, 68), 1);
+    CHECK_EQUAL(literalSize(100, 67), 2);
+    CHECK_EQUAL(literalSize(100, 4195), 2);
+    CHECK_EQUAL(literalSize(100, 4196), 3);
+    CHECK_EQUAL(literalSize(5000, 904), 2);
+    CHECK_EQUAL(literalSize(5000, 903), 3);
+    CHECK_EQUAL(literalSize(1, 65535), 3);
+    CHECK_EQUAL(runSize(64), 1);
+    CHECK_EQUAL(runSize(65), 2);
+    checkRoundTrip(COUNTS, sizeof(COUNTS) / sizeof(COUNTS[0]));
+}
+
+// Counts changing wildly fill the block before its minutes run out
+static void testFullBlock(void) {
+    HistoryCodecEncoder encoder;
+    uint16_t counts[HISTORY_CODEC_MAX_MINUTES];
+    uint16_t decoded[HISTORY_CODEC_MAX_MINUTES];
+    uint16_t minutes = 0;
+    uint8_t length;
+
+    historyCodecEncoderStart(&encoder);
+    for (;;) {
+        uint16_t count = (minutes % 3 == 2) ? 0 : (uint16_t)(minutes * 7919U);
+        if (!historyCodecEncodeMinute(&encoder, count))
+            break;
+        counts[minutes++] = count;
+    }
+    CHECK(minutes < HISTORY_CODEC_MAX_MINUTES);
+    length = historyCodecEncoderFinish(&encoder);
+    CHECK(length <= HISTORY_CODEC_BLOCK_BYTES);
+    CHECK_EQUAL(decodeAll(encoder.data, length, decoded), minutes);
+    CHECK(memcmp(decoded, counts, minutes * sizeof(counts[0])) == 0);
+}
+
+static void testMalformedPayload(void) {
+    static const uint8_t TRUNCATED[] = {0x04, 0x80};            // varint cut short
+    static const uint8_t TOO_LONG[] = {0x80, 0x80, 0x80, 0x80, 0x01};
+    static const uint8_t NEGATIVE[] = {0x04, 0x0A};             // 1, then 1 - 3
+    HistoryCodecDecoder decoder;
+    HistoryCodecSegment segment;
+
+    historyCodecDecoderStart(&decoder, BASE, TRUNCATED, sizeof(TRUNCATED));
+    CHECK(historyCodecDecodeNext(&decoder, &segment));
+    CHECK_EQUAL(segment.count, 1);
+    CHECK(!historyCodecDecodeNext(&decoder, &segment));
+
+    historyCodecDecoderStart(&decoder, BASE, TOO_LONG, sizeof(TOO_LONG));
+    CHECK(!historyCodecDecodeNext(&decoder, &segment));
+
+    historyCodecDecoderStart(&decoder, BASE, NEGATIVE, sizeof(NEGATIVE));
+    CHECK(historyCodecDecodeNext(&decoder, &segment));
+    CHECK(!historyCodecDecodeNext(&decoder, &segment));
+}
+
+// The block as stepLog stores it: a blob whose payload starts with the
+// minute count. A damaged continuation slot fails its CRC.
+static void testStoredBlock(void) {
+    static const uint16_t COUNTS[] = {12, 40, 0, 0, 0, 7, 95, 96, 0, 3};
+    const uint8_t minutes = sizeof(COUNTS) / sizeof(COUNTS[0]);
+    HistoryCodecEncoder encoder;
+    HistoryRecord header, found;
+    HistoryCursor cursor;
+    uint8_t payload[1 + HISTORY_CODEC_BLOCK_BYTES];
+    uint8_t readBack[HISTORY_BLOB_MAX_BYTES];
+    uint16_t decoded[HISTORY_CODEC_MAX_MINUTES];
+    uint32_t address;
+    uint8_t length;
+
+    flashMockReset();
+    historyStoreInit();
+    historyCodecEncoderStart(&encoder);
+    for (uint8_t i = 0; i < minutes; i++)
+        CHECK(historyCodecEncodeMinute(&encoder, COUNTS[i]));
+    length = historyCodecEncoderFinish(&encoder);
+    payload[0] = minutes;
+    memcpy(&payload[1], encoder.data, length);
+    header.type = HISTORY_RECORD_STEP_BLOCK;
+    header.timestamp = BASE + minutes;
+    header.value = 1 + length;
+    CHECK(historyStoreAppendBlob(&header, payload));
+    CHECK(historyStoreAppendBlob(&header, payload));
+
+    historyCursorOldest(&cursor);
+    CHECK(historyCursorNext(&cursor, &found));
+    CHECK_EQUAL(found.type, HISTORY_RECORD_STEP_BLOCK);
+    CHECK_EQUAL(found.value, 1 + length);
+    CHECK(historyCursorReadBlob(&cursor, &found, readBack));
+    CHECK_EQUAL(readBack[0], minutes);
+    CHECK_EQUAL(decodeAll(&readBack[1], found.value - 1, decoded), minutes);
+    CHECK(memcmp(decoded, COUNTS, sizeof(COUNTS)) == 0);
+
+    // Flip one payload bit in the first continuation of the second copy.
+    // The log starts on the first page, eight program-memory units a slot.
+    CHECK(historyCursorNext(&cursor, &found));
+    address = (uint32_t)cursor.slot * 8 + 2;
+    flashMockCorrupt(address, FLASH_ReadWord16(address) ^ 0x0010);
+    CHECK(!historyCursorReadBlob(&cursor, &found, readBack));
+}
+
+int main(void) {
+    testEmptyBlock();
+    testLongestRun();
+    testNegativeDeltas();
+    testVarintBoundaries();
+    testFullBlock();
+    testMalformedPayload();
+    testStoredBlock();
+    return hostTestResult("testHistoryCodec");
+}
@@ -0,0 +1,276 @@
+/*
+ * File: testHistoryExport.c
+ * Project: Smart Watch - Final Version
+ * Description: Host test of the UART history export against a scripted
+ *              host: a full transfer with blobs, resends after a timeout
+ *              and a nak, resuming from a data frame's position, damaged
+ *              host frames and a session given up on.
+ *
+ * Build and run from the project root:
+ *   gcc -O2 -Itests/host -I. -o testHistoryExport tests/testHistoryExport.c \
+ *       historyExport.c historyStore.c tests/flashMock.c tests/uartMock.c \
+ *       System/crc_soft.c && ./testHistoryExport
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "System/crc.h"
+#include "historyStore.h"
+#include "historyExport.h"
+#include "tests/flashMock.h"
+#include "tests/uartMock.h"
+#include "tests/hostTest.h"
+
+#define RECORDS         40
+#define BLOB_EVERY      8           // every eighth record is a step block
+#define BLOB_BYTES      21
+#define MAX_FRAMES      64
+
+typedef struct {
+    uint8_t type;
+    uint16_t seq;
+    uint8_t length;
+    uint8_t payload[HISTORY_EXPORT_PAYLOAD_MAX];
+} Frame;
+
+static uint32_t now;
+
+static uint32_t getLe(const uint8_t *in, uint8_t bytes) {
+    uint32_t value = 0;
+    while (bytes--)
+        value = (value << 8) | in[bytes];
+    return value;
+}
+
+static void blobFor(uint8_t index, uint8_t *data) {
+    for (uint8_t i = 0; i < BLOB_BYTES; i++)
+        data[i] = index * 31 + i;
+}
+
+// Record i has timestamp 100 + i and value i, or is a blob of BLOB_BYTES
+static void fillLog(void) {
+    uint8_t data[BLOB_BYTES];
+
+    flashMockReset();
+    historyStoreInit();
+    for (uint8_t i = 0; i < RECORDS; i++) {
+        if (i % BLOB_EVERY == BLOB_EVERY - 1) {
+            HistoryRecord header = {HISTORY_RECORD_STEP_BLOCK, 100 + i, BLOB_BYTES};
+            blobFor(i, data);
+            CHECK(historyStoreAppendBlob(&header, data));
+        } else {
+            HistoryRecord record = {HISTORY_RECORD_STEPS, 100 + i, i};
+            CHECK(historyStoreAppend(&record));
+        }
+    }
+}
+
+static void sendFrame(uint8_t type, uint16_t seq, const uint8_t *payload, uint8_t length, bool damaged) {
+    uint8_t bytes[6 + HISTORY_EXPORT_PAYLOAD_MAX + 2];
+    uint16_t crc;
+
+    bytes[0] = HISTORY_EXPORT_SYNC0;
+    bytes[1] = HISTORY_EXPORT_SYNC1;
+    bytes[2] = type;
+    bytes[3] = seq & 0xFF;
+    bytes[4] = seq >> 8;
+    bytes[5] = length;
+    memcpy(&bytes[6], payload, length);
+    crc = (uint16_t)CRC_Calculate(&CRC_CONFIG_CCITT16, &bytes[2], 4 + length);
+    if (damaged)
+        crc ^= 1;
+    bytes[6 + length] = crc & 0xFF;
+    bytes[7 + length] = crc >> 8;
+    uartMockReceive(bytes, 8 + length);
+}
+
+static void sendStart(uint32_t position, bool damaged) {
+    uint8_t payload[4] = {position, position >> 8, position >> 16, position >> 24};
+    sendFrame(HISTORY_EXPORT_START, 0, payload, 4, damaged);
+}
+
+// Services the export until the line is quiet and parses what it sent.
+// Every frame must be well formed.
+static uint8_t service(Frame *frames) {
+    static uint8_t line[4096];
+    uint16_t length = 0, taken, offset = 0;
+    uint8_t count = 0;
+
+    do {
+        historyExportService(now);
+        taken = uartMockTakeSent(&line[length], sizeof(line) - length);
+        length += taken;
+    } while (taken > 0);
+
+    while (offset < length && count < MAX_FRAMES) {
+        Frame *frame = &frames[count++];
+        CHECK(length - offset >= 8);
+        CHECK_EQUAL(line[offset], HISTORY_EXPORT_SYNC0);
+        CHECK_EQUAL(line[offset + 1], HISTORY_EXPORT_SYNC1);
+        frame->type = line[offset + 2];
+        frame->seq = getLe(&line[offset + 3], 2);
+        frame->length = line[offset + 5];
+        CHECK(frame->length <= HISTORY_EXPORT_PAYLOAD_MAX);
+        memcpy(frame->payload, &line[offset + 6], frame->length);
+        CHECK_EQUAL(getLe(&line[offset + 6 + frame->length], 2),
+                    CRC_Calculate(&CRC_CONFIG_CCITT16, &line[offset + 2], 4 + frame->length));
+        offset += 8 + frame->length;
+    }
+    return count;
+}
+
+// Checks the records of a data frame against the log, starting at record
+// *next, and moves *next past them
+static void checkRecords(const Frame *frame, uint8_t *next) {
+    uint8_t data[BLOB_BYTES];
+    uint8_t offset = 4;
+
+    CHECK_EQUAL(frame->type, HISTORY_EXPORT_DATA);
+    while (offset < frame->length) {
+        uint8_t i = (*next)++;
+        bool blob = (i % BLOB_EVERY == BLOB_EVERY - 1);
+        uint16_t value = getLe(&frame->payload[offset + 4], 2);
+
+        CHECK_EQUAL(frame->payload[offset], blob ? HISTORY_RECORD_STEP_BLOCK : HISTORY_RECORD_STEPS);
+        CHECK_EQUAL(getLe(&frame->payload[offset + 1], 3), 100 + i);
+        CHECK_EQUAL(value, blob ? BLOB_BYTES : i);
+        offset += 6;
+        if (blob) {
+            blobFor(i, data);
+            CHECK(memcmp(&frame->payload[offset], data, BLOB_BYTES) == 0);
+            offset += BLOB_BYTES;
+        }
+    }
+    CHECK_EQUAL(offset, frame->length);
+}
+
+// Acks every frame as it arrives; returns the position in the end frame
+static uint32_t exportAll(uint32_t from, uint8_t firstRecord) {
+    Frame frames[MAX_FRAMES];
+    uint16_t expectedSeq = 0;
+    uint8_t next = firstRecord;
+
+    sendStart(from, false);
+    for (uint8_t pass = 0; pass < 50; pass++) {
+        uint8_t count = service(frames);
+        for (uint8_t i = 0; i < count; i++) {
+            CHECK_EQUAL(frames[i].seq, expectedSeq);
+            expectedSeq++;
+            sendFrame(HISTORY_EXPORT_ACK, expectedSeq, NULL, 0, false);
+            if (frames[i].type == HISTORY_EXPORT_END) {
+                CHECK_EQUAL(next, RECORDS);
+                CHECK_EQUAL(frames[i].length, 4);
+                service(frames);
+                return getLe(frames[i].payload, 4);
+            }
+            checkRecords(&frames[i], &next);
+        }
+        now++;
+    }
+    CHECK(!"the export never ended");
+    return 0;
+}
+
+static void testFullExport(void) {
+    Frame frames[MAX_FRAMES];
+    HistoryCursor cursor;
+    HistoryRecord record;
+    uint32_t end;
+
+    fillLog();
+    uartMockReset();
+    historyExportInit();
+    end = exportAll(0, 0);
+    historyCursorOldest(&cursor);
+    while (historyCursorNext(&cursor, &record))
+        ;
+    CHECK_EQUAL(end, historyCursorPosition(&cursor));
+
+    // Acknowledged to the end: the session is over and the line is quiet
+    now += HISTORY_EXPORT_RETRY_TICKS;
+    CHECK_EQUAL(service(frames), 0);
+}
+
+// Unacknowledged frames go again after the retry time, a nak resends
+// from its seq at once, and the session is dropped after too many retries
+static void testResends(void) {
+    Frame first[MAX_FRAMES], again[MAX_FRAMES];
+    uint8_t count;
+
+    fillLog();
+    uartMockReset();
+    historyExportInit();
+    sendStart(0, false);
+    count = service(first);
+    CHECK_EQUAL(count, HISTORY_EXPORT_WINDOW);
+
+    now += HISTORY_EXPORT_RETRY_TICKS - 1;
+    CHECK_EQUAL(service(again), 0);
+    now += 1;
+    CHECK_EQUAL(service(again), HISTORY_EXPORT_WINDOW);
+    for (uint8_t i = 0; i < HISTORY_EXPORT_WINDOW; i++) {
+        CHECK_EQUAL(again[i].seq, first[i].seq);
+        CHECK(again[i].length == first[i].length &&
+              memcmp(again[i].payload, first[i].payload, first[i].length) == 0);
+    }
+
+    // Frame 0 arrived, 1 did not: 1 to 3 go again, then the new frame 4
+    sendFrame(HISTORY_EXPORT_NAK, 1, NULL, 0, false);
+    count = service(again);
+    CHECK_EQUAL(count, HISTORY_EXPORT_WINDOW);
+    for (uint8_t i = 0; i < count; i++)
+        CHECK_EQUAL(again[i].seq, 1 + i);
+
+    for (uint8_t retry = 0; retry < HISTORY_EXPORT_MAX_RETRIES; retry++) {
+        now += HISTORY_EXPORT_RETRY_TICKS;
+        CHECK_EQUAL(service(again), HISTORY_EXPORT_WINDOW);
+    }
+    now += HISTORY_EXPORT_RETRY_TICKS;
+    CHECK_EQUAL(service(again), 0);
+
+    // A stale ack does not revive it
+    sendFrame(HISTORY_EXPORT_ACK, 2, NULL, 0, false);
+    CHECK_EQUAL(service(again), 0);
+}
+
+// A host that stored frame 1 resumes from the position it carries
+static void testResume(void) {
+    Frame frames[MAX_FRAMES];
+    uint8_t next = 0;
+
+    fillLog();
+    uartMockReset();
+    historyExportInit();
+    sendStart(0, false);
+    CHECK(service(frames) >= 2);
+    checkRecords(&frames[0], &next);
+    checkRecords(&frames[1], &next);
+
+    exportAll(getLe(frames[1].payload, 4), next);
+}
+
+static void testDamagedHostFrames(void) {
+    Frame frames[MAX_FRAMES];
+    static const uint8_t NOISE[] = {0x00, 0xA5, 0xA5, 0x13, 0x5A};
+
+    fillLog();
+    uartMockReset();
+    historyExportInit();
+    sendStart(0, true);
+    CHECK_EQUAL(service(frames), 0);
+
+    // Noise before a good start is skipped
+    uartMockReceive(NOISE, sizeof(NOISE));
+    sendStart(0, false);
+    CHECK_EQUAL(service(frames), HISTORY_EXPORT_WINDOW);
+    CHECK_EQUAL(frames[0].seq, 0);
+}
+
+int main(void) {
+    testFullExport();
+    testResends();
+    testResume();
+    testDamagedHostFrames();
+    return hostTestResult("testHistoryExport");
+}
@@ -0,0 +1,197 @@
+/*
+ * File: testHistoryStore.c
+ * Project: Smart Watch - Final Version
+ * Description: Host test of the history log on the flash mock: seeks across
+ *              the New Year wrap, a clock set back, a reboot and the ring
+ *              recycling its oldest pages.
+ *
+ * Build and run from the project root:
+ *   gcc -O2 -Itests/host -I. -o testHistoryStore tests/testHistoryStore.c \
+ *       historyStore.c tests/flashMock.c System/crc_soft.c && ./testHistoryStore
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "historyStore.h"
+#include "tests/flashMock.h"
+#include "tests/hostTest.h"
+
+#define MINUTES_PER_DAY     (24 * 60UL)
+
+static uint16_t appended;       // value of the next record: its place in the log
+
+static void freshLog(void) {
+    flashMockReset();
+    historyStoreInit();
+    appended = 0;
+}
+
+static void appendAt(uint32_t timestamp) {
+    HistoryRecord record = {HISTORY_RECORD_STEPS, timestamp, appended++};
+    CHECK(historyStoreAppend(&record));
+}
+
+// count records a minute apart from start
+static void appendMinutes(uint32_t start, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++)
+        appendAt(start + i);
+}
+
+// The record a seek lands on, or false at the end of the log
+static bool seekTo(uint32_t timestamp, HistoryRecord *record) {
+    HistoryCursor cursor;
+
+    historyCursorSeek(&cursor, timestamp);
+    return historyCursorNext(&cursor, record);
+}
+
+static void checkSeek(uint32_t timestamp, uint16_t value) {
+    HistoryRecord record;
+
+    CHECK(seekTo(timestamp, &record));
+    CHECK_EQUAL(record.value, value);
+}
+
+static void testEmptyLog(void) {
+    HistoryRecord record;
+
+    freshLog();
+    CHECK(!seekTo(0, &record));
+}
+
+static void testSortedLog(void) {
+    HistoryRecord record;
+    uint32_t start = historyTimestamp(3, 1, 8, 0);
+
+    freshLog();
+    appendMinutes(start, 500);
+    checkSeek(0, 0);
+    checkSeek(start + 1, 1);
+    checkSeek(start + 333, 333);
+    checkSeek(start + 499, 499);
+    CHECK(!seekTo(start + 500, &record));
+}
+
+// Daily totals are stamped with the day they close, so they go back a day
+// without starting a new stretch of the log
+static void testLateDailyTotals(void) {
+    uint32_t day = historyTimestamp(5, 10, 0, 0);
+
+    freshLog();
+    for (uint8_t i = 0; i < 3; i++) {
+        appendMinutes(day + i * MINUTES_PER_DAY, 100);      // values i * 101 ...
+        appendAt(day + i * MINUTES_PER_DAY);                // the day's total
+    }
+    checkSeek(day + MINUTES_PER_DAY + 50, 101 + 50);
+    checkSeek(day + 2 * MINUTES_PER_DAY, 202);
+}
+
+static void testNewYearWrap(void) {
+    uint32_t lastYear = historyTimestamp(12, 31, 20, 0);
+    uint32_t newYear = historyTimestamp(1, 1, 0, 0);
+
+    freshLog();
+    appendMinutes(lastYear, 240);           // to midnight
+    appendMinutes(newYear, 300);            // values 240 ...
+    checkSeek(lastYear + 100, 100);
+    checkSeek(newYear, 240);
+    checkSeek(newYear + 120, 360);
+    checkSeek(historyTimestamp(6, 1, 0, 0), 0);     // only last year reached June
+
+    // The index rebuilt at boot splits the log the same way
+    historyStoreInit();
+    checkSeek(lastYear + 100, 100);
+    checkSeek(newYear + 120, 360);
+}
+
+// After a reset the clock restarts on January 1st; a later stretch that
+// begins after the timestamp does not hide the older one
+static void testClockSetBack(void) {
+    uint32_t october = historyTimestamp(10, 2, 12, 0);
+    uint32_t reset = historyTimestamp(1, 1, 0, 0);
+    uint32_t march = historyTimestamp(3, 5, 9, 0);
+
+    freshLog();
+    appendMinutes(october, 400);
+    appendMinutes(reset, 200);              // values 400 ...
+    appendMinutes(march, 100);              // values 600 ...
+    checkSeek(october + 10, 10);
+    checkSeek(reset + 150, 550);
+    checkSeek(march + 20, 620);
+    checkSeek(historyTimestamp(2, 1, 0, 0), 400 + 200);
+
+    historyStoreInit();
+    checkSeek(october + 10, 10);
+    checkSeek(reset + 150, 550);
+    checkSeek(march + 20, 620);
+}
+
+// Set back by a few weeks: the newer stretch began after the timestamp
+static void testClockSetBackWeeks(void) {
+    uint32_t january = historyTimestamp(1, 15, 0, 0);
+    uint32_t march = historyTimestamp(3, 1, 0, 0);
+    uint32_t february = historyTimestamp(2, 10, 0, 0);
+
+    freshLog();
+    for (uint16_t day = 0; day < 45; day++)
+        appendMinutes(january + day * MINUTES_PER_DAY, 10);     // to the end of February
+    appendMinutes(march, 10);                                   // values 450 ...
+    appendMinutes(february, 50);                                // values 460 ...
+    checkSeek(historyTimestamp(1, 20, 0, 0), 50);
+    checkSeek(february + 5, 465);
+    checkSeek(march, 450);
+    checkSeek(historyTimestamp(2, 20, 0, 0), 360);
+}
+
+// The oldest stretch that had begun by a given day, as the history browser
+// asks for it; the January stretch starts inside the block of December's end
+static void testOldestRunStart(void) {
+    uint32_t lastYear = historyTimestamp(12, 30, 20, 0);
+    uint32_t newYear = historyTimestamp(1, 1, 0, 0);
+    uint32_t timestamp;
+
+    freshLog();
+    CHECK(!historyOldestRunStart(newYear, &timestamp));
+    appendMinutes(lastYear, 210);
+    appendMinutes(newYear + 30, 300);
+    CHECK(historyOldestRunStart(historyTimestamp(1, 5, 0, 0), &timestamp));
+    CHECK_EQUAL(timestamp, newYear + 30);
+    CHECK(historyOldestRunStart(historyTimestamp(12, 31, 0, 0), &timestamp));
+    CHECK_EQUAL(timestamp, lastYear);
+    CHECK(!historyOldestRunStart(newYear + 29, &timestamp));
+
+    historyStoreInit();
+    CHECK(historyOldestRunStart(historyTimestamp(1, 5, 0, 0), &timestamp));
+    CHECK_EQUAL(timestamp, newYear + 30);
+}
+
+// Enough records to recycle the oldest pages several times over
+static void testRecycledRing(void) {
+    uint32_t start = historyTimestamp(1, 1, 0, 0);
+    HistoryCursor cursor;
+    HistoryRecord oldest;
+
+    freshLog();
+    appendMinutes(start, 6000);
+    historyCursorOldest(&cursor);
+    CHECK(historyCursorNext(&cursor, &oldest));
+    CHECK(oldest.value > 0);
+    checkSeek(start, oldest.value);
+    checkSeek(start + 5000, 5000);
+    checkSeek(start + 5999, 5999);
+
+    historyStoreInit();
+    checkSeek(start + 4321, 4321);
+}
+
+int main(void) {
+    testEmptyLog();
+    testSortedLog();
+    testLateDailyTotals();
+    testNewYearWrap();
+    testClockSetBack();
+    testClockSetBackWeeks();
+    testOldestRunStart();
+    testRecycledRing();
+    return hostTestResult("testHistoryStore");
+}
@@ -0,0 +1,76 @@
+/*
+ * File: uartMock.c
+ * Project: Smart Watch - Final Version
+ * Description: Scripted UART1 for the host tests.
+ *
+ * The transmit side has the driver's ring size and refuses writes that do
+ * not fit whole, so callers see back-pressure until the test drains it.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "tests/uartMock.h"
+
+static uint8_t rx[UART1_RX_BUFFER_SIZE];
+static uint16_t rxHead, rxCount;
+static uint8_t tx[UART1_TX_BUFFER_SIZE];
+static uint16_t txCount;
+static bool open;
+
+void uartMockReset(void) {
+    rxHead = 0;
+    rxCount = 0;
+    txCount = 0;
+    open = false;
+}
+
+void uartMockReceive(const uint8_t *data, uint16_t length) {
+    while (length-- > 0 && rxCount < UART1_RX_BUFFER_SIZE) {
+        rx[(rxHead + rxCount) % UART1_RX_BUFFER_SIZE] = *data++;
+        rxCount++;
+    }
+}
+
+uint16_t uartMockTakeSent(uint8_t *out, uint16_t max) {
+    uint16_t count = (txCount < max) ? txCount : max;
+
+    memcpy(out, tx, count);
+    memmove(tx, &tx[count], txCount - count);
+    txCount -= count;
+    return count;
+}
+
+void uart1_open(uint32_t baud) {
+    (void)baud;
+    open = true;
+}
+
+void uart1_close(void) {
+    open = false;
+}
+
+bool uart1_write(const uint8_t *data, uint16_t length) {
+    if (!open || length > uart1_txFree())
+        return false;
+    memcpy(&tx[txCount], data, length);
+    txCount += length;
+    return true;
+}
+
+uint16_t uart1_txFree(void) {
+    return UART1_TX_BUFFER_SIZE - txCount;
+}
+
+bool uart1_isTxDone(void) {
+    return txCount == 0;
+}
+
+bool uart1_read(uint8_t *byte) {
+    if (rxCount == 0)
+        return false;
+    *byte = rx[rxHead];
+    rxHead = (rxHead + 1) % UART1_RX_BUFFER_SIZE;
+    rxCount--;
+    return true;
+}
@@ -0,0 +1,25 @@
+/*
+ * File: uartMock.h
+ * Project: Smart Watch - Final Version
+ * Description: Scripted UART1 for the host tests, implementing
+ *              uartDriver/uart1_driver.h. Bytes queued with
+ *              uartMockReceive come out of uart1_read; bytes written are
+ *              kept until uartMockTakeSent.
+ */
+
+#ifndef UART_MOCK_H
+#define UART_MOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uartDriver/uart1_driver.h"
+
+void uartMockReset(void);
+
+// Queues bytes from the host; bytes beyond the receive ring are dropped
+void uartMockReceive(const uint8_t *data, uint16_t length);
+
+// Moves up to max sent bytes to out and returns how many
+uint16_t uartMockTakeSent(uint8_t *out, uint16_t max);
+
+#endif // UART_MOCK_H
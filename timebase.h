@@ -0,0 +1,19 @@
+/*
+ * File: timebase.h
+ * Project: Smart Watch - Final Version
+ * Description: The Timer1 time base shared by everything measured in ticks.
+ *
+ * Timer1 counts FCY (4 MHz) through its 1:256 prescaler, 64 us per tick,
+ * and its period is one second; currentTicks() in main.c extends the count
+ * with the seconds elapsed.
+ */
+
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+#include <stdint.h>
+
+#define TIMER1_TICKS_PER_SECOND 15625UL
+#define TICKS_FROM_MS(ms)       (((uint32_t)(ms) * TIMER1_TICKS_PER_SECOND) / 1000)
+
+#endif // TIMEBASE_H
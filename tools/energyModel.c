@@ -0,0 +1,71 @@
+/*
+ * File: energyModel.c
+ * Project: Smart Watch - Final Version
+ * Description: Average supply current of the watch from what each part is
+ *              doing, for comparing power trade-offs off-target.
+ *
+ * Sources: PIC24FJ256GA705 IDD/IIDLE/IPD tables and ADXL345 Table 7
+ * (current against data rate). The OLED C click figures are SSD1351
+ * segment currents at master current 15 carried through the click's
+ * 3.3 V to 13 V boost, so they are the least certain entries. Panel
+ * current scales with the lit weight and the master current; the
+ * controller and an idle boost converter cost a fixed amount while on.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "energyModel.h"
+
+typedef struct {
+    float run;
+    float idle;
+} CpuCurrent;
+
+static const CpuCurrent CPU_CURRENT_MA[ENERGY_CLOCK_COUNT] = {
+    [ENERGY_CLOCK_FRC]    = {1.40f, 0.40f},
+    [ENERGY_CLOCK_FRCPLL] = {5.00f, 1.40f},
+    [ENERGY_CLOCK_FRCDIV] = {0.45f, 0.15f},
+    [ENERGY_CLOCK_LPRC]   = {0.030f, 0.015f},
+};
+
+#define CPU_SLEEP_MA            0.004f
+#define SPI_ACTIVE_MA           0.15f   // I/O switching into the panel inputs
+#define I2C_ACTIVE_MA           0.70f   // 4.7k pull-ups, each line low half the time
+
+#define DISPLAY_SLEEP_MA        0.02f
+#define DISPLAY_ON_BLACK_MA     0.90f
+#define DISPLAY_FULL_WHITE_MA   45.0f   // at master current 15
+#define DISPLAY_MAX_CONTRAST    15
+
+#define ACCEL_STANDBY_MA        0.0001f
+
+// Indexed by AccelRate: 12.5, 25, 50 and 100 Hz
+static const float ACCEL_NORMAL_MA[] = {0.050f, 0.060f, 0.090f, 0.140f};
+static const float ACCEL_LOW_POWER_MA[] = {0.034f, 0.040f, 0.045f, 0.050f};
+
+void energyModelCurrent(const EnergyProfile *profile, EnergyBreakdown *current) {
+    const CpuCurrent *cpu = &CPU_CURRENT_MA[profile->clock];
+    uint16_t sleepPermille = 1000 - profile->runPermille - profile->idlePermille;
+
+    current->cpu = (cpu->run * profile->runPermille + cpu->idle * profile->idlePermille +
+                    CPU_SLEEP_MA * sleepPermille) / 1000.0f;
+    current->spi = SPI_ACTIVE_MA * profile->spiPermille / 1000.0f;
+    current->i2c = I2C_ACTIVE_MA * profile->i2cPermille / 1000.0f;
+
+    if (profile->display == ENERGY_DISPLAY_ON)
+        current->display = DISPLAY_ON_BLACK_MA + DISPLAY_FULL_WHITE_MA * profile->litPermille / 1000.0f *
+                           profile->contrast / DISPLAY_MAX_CONTRAST;
+    else
+        current->display = DISPLAY_SLEEP_MA;
+
+    if (profile->accelMode == ENERGY_ACCEL_NORMAL)
+        current->accel = ACCEL_NORMAL_MA[profile->accelRate];
+    else if (profile->accelMode == ENERGY_ACCEL_LOW_POWER)
+        current->accel = ACCEL_LOW_POWER_MA[profile->accelRate];
+    else
+        current->accel = ACCEL_STANDBY_MA;
+}
+
+float energyModelTotal(const EnergyBreakdown *current) {
+    return current->cpu + current->spi + current->i2c + current->display + current->accel;
+}
@@ -0,0 +1,66 @@
+/*
+ * File: energyModel.h
+ * Project: Smart Watch - Final Version
+ * Description: Average supply current of the watch from what each part is
+ *              doing, for comparing power trade-offs off-target.
+ *
+ * A profile states, for a stretch of time, the CPU clock and how the CPU
+ * splits its time between running, idling and sleeping, how busy the two
+ * buses are, what the panel shows and how the accelerometer samples.
+ * Figures are typical datasheet values at 3.3 V and 25 degC, referred to
+ * the battery; they rank alternatives well but are no substitute for a
+ * measurement. No device dependencies: builds on a host compiler.
+ */
+
+#ifndef ENERGY_MODEL_H
+#define ENERGY_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "accelTypes.h"
+
+typedef enum {
+    ENERGY_CLOCK_FRC,           // 8 MHz FRC, 4 MIPS (the firmware's setting)
+    ENERGY_CLOCK_FRCPLL,        // 32 MHz FRC x4 PLL, 16 MIPS
+    ENERGY_CLOCK_FRCDIV,        // FRC / 4, 1 MIPS
+    ENERGY_CLOCK_LPRC,          // 31 kHz LPRC
+    ENERGY_CLOCK_COUNT
+} EnergyClock;
+
+typedef enum {
+    ENERGY_DISPLAY_OFF,         // panel in sleep (0xAE)
+    ENERGY_DISPLAY_ON
+} EnergyDisplay;
+
+typedef enum {
+    ENERGY_ACCEL_STANDBY,
+    ENERGY_ACCEL_NORMAL,
+    ENERGY_ACCEL_LOW_POWER
+} EnergyAccelMode;
+
+typedef struct {
+    EnergyClock clock;
+    uint16_t runPermille;       // CPU executing; the rest of the time not
+    uint16_t idlePermille;      // running or idling is spent in Sleep
+    uint16_t spiPermille;       // SPI1 clocking data to the panel
+    uint16_t i2cPermille;       // I2C1 transfer in progress
+    EnergyDisplay display;
+    uint16_t litPermille;       // lit-pixel weight, full white = 1000
+    uint8_t contrast;           // master current, 0..15 (0xC7)
+    EnergyAccelMode accelMode;
+    AccelRate accelRate;
+} EnergyProfile;
+
+// Average currents in mA
+typedef struct {
+    float cpu;
+    float spi;
+    float i2c;
+    float display;
+    float accel;
+} EnergyBreakdown;
+
+void energyModelCurrent(const EnergyProfile *profile, EnergyBreakdown *current);
+float energyModelTotal(const EnergyBreakdown *current);
+
+#endif // ENERGY_MODEL_H
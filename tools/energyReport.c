@@ -0,0 +1,406 @@
+/*
+ * File: energyReport.c
+ * Project: Smart Watch - Final Version
+ * Description: Host energy report. Runs day-long scenarios through
+ *              energyModel and prints mAh/day per part and battery life.
+ *
+ * Build from the project root:
+ *   gcc -O2 -I. -o energyReport tools/energyReport.c tools/energyModel.c \
+ *       oledDriver/oledC_litMap.c
+ * Usage:
+ *   energyReport                 the built-in scenarios below
+ *   energyReport day.txt ...     scenarios from files, same syntax
+ *
+ * Script lines ('#' starts a comment):
+ *   battery <mAh>
+ *   scenario <name>
+ *   phase <hours> [key=value ...]
+ *   frame <name>
+ *   fill <x0> <y0> <x1> <y1> <color>
+ * Each phase starts from the previous one of its scenario, so only what
+ * changes needs stating. Keys: clock=frc|frcpll|frcdiv|lprc, run=<%>,
+ * idle=<%> (the rest is Sleep), spi=<%>, i2c=<%>, display=on|off,
+ * lit=<%>|<frame> (lit-pixel weight, full white 100), contrast=<0..15>,
+ * accel=standby|12.5|25|50|100, with an "lp" suffix for low-power mode.
+ * A scenario's phases should add up to 24 hours; the report scales
+ * them to a day either way.
+ *
+ * A frame describes a screen as the rectangles the firmware fills, on a
+ * black panel; its lit weight comes from the same estimator the display
+ * driver keeps, so lit=<frame> prices a layout or a theme before it is
+ * flashed. Colors are RGB565 (0xffdf) or one of the names in parseColor.
+ * For example, the step graph's three gridlines in two colors:
+ *   frame grid-white
+ *   fill 5 27 90 27 ghostwhite
+ *   fill 5 51 90 51 ghostwhite
+ *   fill 5 66 90 66 ghostwhite
+ *   frame grid-dim
+ *   fill 5 27 90 27 dimgray
+ *   ...
+ *   phase 1 lit=grid-dim
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "energyModel.h"
+#include "oledDriver/oledC_colors.h"
+#include "oledDriver/oledC_litMap.h"
+
+#define LINE_MAX_CHARS  256
+#define NAME_MAX_CHARS  64
+#define FRAMES_MAX      16
+
+// Figures behind the current firmware: the main loop polls and busy-waits,
+// so the CPU never idles while awake; samples are read every ~20 ms (6
+// bytes at 100 kHz, about 0.9 ms each); the face redraws its digits once
+// a second. Sleep Mode idles the CPU and batches 12.5 Hz samples.
+static const char DEFAULT_SCRIPT[] =
+    "battery 200\n"
+    "\n"
+    "scenario Current firmware: face always on\n"
+    "phase 15   clock=frc run=100 idle=0 spi=3 i2c=5 display=on lit=6 contrast=15 accel=100\n"
+    "phase 1    spi=10 lit=15                           # menus and step graph\n"
+    "phase 8    run=2 idle=98 spi=0 i2c=0.5 display=off accel=12.5lp   # Sleep Mode\n"
+    "\n"
+    "scenario Display sleeps when not looked at\n"
+    "phase 1.5  clock=frc run=100 idle=0 spi=3 i2c=5 display=on lit=6 contrast=15 accel=100\n"
+    "phase 13.5 spi=0 display=off\n"
+    "phase 1    spi=10 display=on lit=15\n"
+    "phase 8    run=2 idle=98 spi=0 i2c=0.5 display=off accel=12.5lp\n"
+    "\n"
+    "scenario Main loop idles between events\n"
+    "phase 15   clock=frc run=10 idle=90 spi=3 i2c=5 display=on lit=6 contrast=15 accel=100\n"
+    "phase 1    run=30 idle=70 spi=10 lit=15\n"
+    "phase 8    run=2 idle=98 spi=0 i2c=0.5 display=off accel=12.5lp\n"
+    "\n"
+    "scenario Idle loop, display sleep, dimmer face\n"
+    "phase 1.5  clock=frc run=10 idle=90 spi=3 i2c=5 display=on lit=6 contrast=10 accel=100\n"
+    "phase 13.5 spi=0 display=off\n"
+    "phase 1    run=30 idle=70 spi=10 display=on lit=15\n"
+    "phase 8    run=2 idle=98 spi=0 i2c=0.5 display=off accel=12.5lp\n";
+
+typedef struct {
+    char name[NAME_MAX_CHARS];
+    EnergyProfile profile;      // of the last phase, the base of the next
+    EnergyBreakdown charge;     // mAh so far
+    float hours;
+    bool open;
+} Scenario;
+
+typedef struct {
+    char name[NAME_MAX_CHARS];
+    uint16_t litPermille;
+} Frame;
+
+static float batteryMah = 200.0f;
+static Frame frames[FRAMES_MAX];
+static uint8_t frameCount;
+static bool frameOpen;          // fills go to the last frame
+
+static void reportScenario(Scenario *scenario) {
+    EnergyBreakdown *charge = &scenario->charge;
+    float scale;
+    float total;
+
+    if (!scenario->open)
+        return;
+    scenario->open = false;
+    if (scenario->hours <= 0.0f)
+        return;
+    scale = 24.0f / scenario->hours;
+    total = energyModelTotal(charge) * scale;
+
+    printf("%s (%.1f h)\n", scenario->name, scenario->hours);
+    printf("  %-10s %8.2f mAh/day\n", "cpu", charge->cpu * scale);
+    printf("  %-10s %8.2f mAh/day\n", "spi", charge->spi * scale);
+    printf("  %-10s %8.2f mAh/day\n", "i2c", charge->i2c * scale);
+    printf("  %-10s %8.2f mAh/day\n", "display", charge->display * scale);
+    printf("  %-10s %8.2f mAh/day\n", "accel", charge->accel * scale);
+    printf("  %-10s %8.2f mAh/day, %.1f days on %.0f mAh\n\n", "total", total,
+           batteryMah / total, batteryMah);
+}
+
+static bool parsePermille(const char *text, uint16_t *permille) {
+    char *end;
+    double percent = strtod(text, &end);
+    if (*end != '\0' || percent < 0.0 || percent > 100.0)
+        return false;
+    *permille = (uint16_t)(percent * 10.0 + 0.5);
+    return true;
+}
+
+static bool parseColor(const char *text, uint16_t *color) {
+    // The colors the firmware draws with, and dim alternatives. Not static:
+    // the OLEDC_COLOR constants are not constant expressions.
+    const struct {
+        const char *name;
+        uint16_t color;
+    } COLORS[] = {
+        {"black", OLEDC_COLOR_BLACK}, {"white", OLEDC_COLOR_WHITE}, {"ghostwhite", OLEDC_COLOR_GHOSTWHITE},
+        {"lightgray", OLEDC_COLOR_LIGHTGRAY}, {"gray", OLEDC_COLOR_GRAY}, {"dimgray", OLEDC_COLOR_DIMGRAY},
+        {"darkslategray", OLEDC_COLOR_DARKSLATEGRAY}, {"red", OLEDC_COLOR_RED}, {"darkred", OLEDC_COLOR_DARKRED},
+        {"green", OLEDC_COLOR_GREEN}, {"darkgreen", OLEDC_COLOR_DARKGREEN}, {"blue", OLEDC_COLOR_BLUE},
+        {"skyblue", OLEDC_COLOR_SKYBLUE}, {"yellow", OLEDC_COLOR_YELLOW}
+    };
+    char *end;
+    unsigned long value = strtoul(text, &end, 16);
+
+    if (strncmp(text, "0x", 2) == 0 && *end == '\0' && value <= 0xFFFF) {
+        *color = value;
+        return true;
+    }
+    for (uint8_t i = 0; i < sizeof(COLORS) / sizeof(COLORS[0]); i++) {
+        if (strcmp(text, COLORS[i].name) == 0) {
+            *color = COLORS[i].color;
+            return true;
+        }
+    }
+    return false;
+}
+
+static Frame *findFrame(const char *name) {
+    for (uint8_t i = 0; i < frameCount; i++) {
+        if (strcmp(frames[i].name, name) == 0)
+            return &frames[i];
+    }
+    return NULL;
+}
+
+static void reportFrame(void) {
+    if (!frameOpen)
+        return;
+    frameOpen = false;
+    printf("frame %s: %.1f%% lit\n\n", frames[frameCount - 1].name,
+           frames[frameCount - 1].litPermille / 10.0);
+}
+
+static bool parseLit(const char *text, uint16_t *permille) {
+    Frame *frame = findFrame(text);
+    if (frame != NULL) {
+        *permille = frame->litPermille;
+        return true;
+    }
+    return parsePermille(text, permille);
+}
+
+// Starts a frame on a black panel; the fills that follow update its weight
+static bool parseFrame(const char *name, const char *source, int line) {
+    if (*name == '\0' || findFrame(name) != NULL || frameCount >= FRAMES_MAX) {
+        fprintf(stderr, "%s:%d: frame needs a new name (at most %d frames)\n", source, line, FRAMES_MAX);
+        return false;
+    }
+    snprintf(frames[frameCount].name, sizeof(frames[frameCount].name), "%s", name);
+    oledC_litMapClear(OLEDC_COLOR_BLACK);
+    frames[frameCount++].litPermille = 0;
+    frameOpen = true;
+    return true;
+}
+
+static bool parseFill(const char *arguments, const char *source, int line) {
+    unsigned x0, y0, x1, y1;
+    char colorName[NAME_MAX_CHARS];
+    uint16_t color;
+
+    if (!frameOpen) {
+        fprintf(stderr, "%s:%d: fill outside a frame\n", source, line);
+        return false;
+    }
+    if (sscanf(arguments, "%u %u %u %u %63s", &x0, &y0, &x1, &y1, colorName) != 5 ||
+        x0 > x1 || y0 > y1 || x1 > 95 || y1 > 95 || !parseColor(colorName, &color)) {
+        fprintf(stderr, "%s:%d: expected fill <x0> <y0> <x1> <y1> <color> within 0..95\n", source, line);
+        return false;
+    }
+    oledC_litMapFill(x0, y0, x1, y1, color);
+    frames[frameCount - 1].litPermille = oledC_litMapPermille();
+    return true;
+}
+
+static bool parseAccel(const char *text, EnergyProfile *profile) {
+    static const char *const RATES[] = {"12.5", "25", "50", "100"};
+    size_t length = strlen(text);
+    bool lowPower = length > 2 && strcmp(&text[length - 2], "lp") == 0;
+
+    if (strcmp(text, "standby") == 0) {
+        profile->accelMode = ENERGY_ACCEL_STANDBY;
+        return true;
+    }
+    if (lowPower)
+        length -= 2;
+    for (uint8_t i = 0; i < sizeof(RATES) / sizeof(RATES[0]); i++) {
+        if (strlen(RATES[i]) == length && strncmp(text, RATES[i], length) == 0) {
+            profile->accelRate = (AccelRate)i;
+            profile->accelMode = lowPower ? ENERGY_ACCEL_LOW_POWER : ENERGY_ACCEL_NORMAL;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parseSetting(const char *key, const char *value, EnergyProfile *profile) {
+    static const char *const CLOCKS[ENERGY_CLOCK_COUNT] = {"frc", "frcpll", "frcdiv", "lprc"};
+
+    if (strcmp(key, "clock") == 0) {
+        for (uint8_t i = 0; i < ENERGY_CLOCK_COUNT; i++) {
+            if (strcmp(value, CLOCKS[i]) == 0) {
+                profile->clock = (EnergyClock)i;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (strcmp(key, "run") == 0)
+        return parsePermille(value, &profile->runPermille);
+    if (strcmp(key, "idle") == 0)
+        return parsePermille(value, &profile->idlePermille);
+    if (strcmp(key, "spi") == 0)
+        return parsePermille(value, &profile->spiPermille);
+    if (strcmp(key, "i2c") == 0)
+        return parsePermille(value, &profile->i2cPermille);
+    if (strcmp(key, "lit") == 0)
+        return parseLit(value, &profile->litPermille);
+    if (strcmp(key, "display") == 0) {
+        if (strcmp(value, "on") != 0 && strcmp(value, "off") != 0)
+            return false;
+        profile->display = (strcmp(value, "on") == 0) ? ENERGY_DISPLAY_ON : ENERGY_DISPLAY_OFF;
+        return true;
+    }
+    if (strcmp(key, "contrast") == 0) {
+        int contrast = atoi(value);
+        if (contrast < 0 || contrast > 15)
+            return false;
+        profile->contrast = contrast;
+        return true;
+    }
+    if (strcmp(key, "accel") == 0)
+        return parseAccel(value, profile);
+    return false;
+}
+
+static bool parsePhase(char *arguments, Scenario *scenario, const char *source, int line) {
+    char *token = strtok(arguments, " \t");
+    EnergyBreakdown current;
+    float hours;
+
+    if (token == NULL || (hours = strtof(token, NULL)) <= 0.0f) {
+        fprintf(stderr, "%s:%d: phase needs a duration in hours\n", source, line);
+        return false;
+    }
+    while ((token = strtok(NULL, " \t")) != NULL) {
+        char *value = strchr(token, '=');
+        if (value == NULL) {
+            fprintf(stderr, "%s:%d: expected key=value, got '%s'\n", source, line, token);
+            return false;
+        }
+        *value++ = '\0';
+        if (!parseSetting(token, value, &scenario->profile)) {
+            fprintf(stderr, "%s:%d: bad setting %s=%s\n", source, line, token, value);
+            return false;
+        }
+    }
+    if (scenario->profile.runPermille + scenario->profile.idlePermille > 1000) {
+        fprintf(stderr, "%s:%d: run and idle exceed 100%%\n", source, line);
+        return false;
+    }
+
+    energyModelCurrent(&scenario->profile, &current);
+    scenario->charge.cpu += current.cpu * hours;
+    scenario->charge.spi += current.spi * hours;
+    scenario->charge.i2c += current.i2c * hours;
+    scenario->charge.display += current.display * hours;
+    scenario->charge.accel += current.accel * hours;
+    scenario->hours += hours;
+    return true;
+}
+
+static bool runScript(char *script, const char *source) {
+    Scenario scenario = {.open = false};
+    char *text = script;
+    int line = 0;
+
+    while (text != NULL && *text != '\0') {
+        char *next = strchr(text, '\n');
+        char *comment;
+        if (next != NULL)
+            *next++ = '\0';
+        line++;
+        if ((comment = strchr(text, '#')) != NULL)
+            *comment = '\0';
+        text += strspn(text, " \t");
+        if (strncmp(text, "fill", 4) != 0 && *text != '\0')
+            reportFrame();
+
+        if (strncmp(text, "battery", 7) == 0) {
+            batteryMah = strtof(&text[7], NULL);
+        } else if (strncmp(text, "scenario", 8) == 0) {
+            reportScenario(&scenario);
+            memset(&scenario, 0, sizeof(scenario));
+            snprintf(scenario.name, sizeof(scenario.name), "%s", &text[8 + strspn(&text[8], " \t")]);
+            scenario.open = true;
+        } else if (strncmp(text, "frame", 5) == 0) {
+            char *name = &text[5 + strspn(&text[5], " \t")];
+            name[strcspn(name, " \t\r")] = '\0';
+            if (!parseFrame(name, source, line))
+                return false;
+        } else if (strncmp(text, "fill", 4) == 0) {
+            if (!parseFill(&text[4], source, line))
+                return false;
+        } else if (strncmp(text, "phase", 5) == 0) {
+            if (!scenario.open) {
+                fprintf(stderr, "%s:%d: phase outside a scenario\n", source, line);
+                return false;
+            }
+            if (!parsePhase(&text[5], &scenario, source, line))
+                return false;
+        } else if (*text != '\0') {
+            fprintf(stderr, "%s:%d: unknown line\n", source, line);
+            return false;
+        }
+        text = next;
+    }
+    reportFrame();
+    reportScenario(&scenario);
+    return true;
+}
+
+static char *readFile(const char *path) {
+    FILE *file = fopen(path, "rb");
+    char *text;
+    long size;
+
+    if (file == NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    size = ftell(file);
+    rewind(file);
+    text = malloc(size + 1);
+    if (text != NULL) {
+        size = fread(text, 1, size, file);
+        text[size] = '\0';
+    }
+    fclose(file);
+    return text;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        char script[sizeof(DEFAULT_SCRIPT)];
+        memcpy(script, DEFAULT_SCRIPT, sizeof(script));
+        return runScript(script, "built-in") ? 0 : 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        char *script = readFile(argv[i]);
+        bool ok;
+        if (script == NULL) {
+            perror(argv[i]);
+            return 1;
+        }
+        ok = runScript(script, argv[i]);
+        free(script);
+        if (!ok)
+            return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,317 @@
+/*
+ * File: historyReceive.c
+ * Project: Smart Watch - Final Version
+ * Description: Linux host receiver for the history export (see
+ *              historyExport.h). Writes the records as CSV.
+ *
+ * Build from the project root:
+ *   gcc -O2 -I. -o historyReceive tools/historyReceive.c historyCodec.c System/crc_soft.c
+ * Usage:
+ *   historyReceive /dev/ttyUSB0 history.csv
+ *
+ * The log position after the last stored frame is kept next to the CSV
+ * (history.csv.pos). When it exists the export resumes from there and the
+ * CSV is appended to; delete both to export everything again. Step blocks
+ * are expanded to one row per minute that had steps.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "System/crc.h"
+#include "historyCodec.h"
+#include "historyExport.h"
+#include "historyStore.h"
+
+#define FRAME_HEADER_BYTES  6
+#define FRAME_MAX_BYTES     (FRAME_HEADER_BYTES + 255 + 2)
+#define SILENCE_RESTART_MS  2000    // no valid frame: send the start again
+#define SILENCE_GIVE_UP_MS  15000
+
+static const uint16_t DAYS_BEFORE_MONTH[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+static const char *const TYPE_NAMES[16] = {
+    [HISTORY_RECORD_STEPS] = "steps",
+    [HISTORY_RECORD_SLEEP] = "sleep",
+    [HISTORY_RECORD_ACTIVITY] = "activity",
+    [HISTORY_RECORD_DISTANCE] = "distance",
+    [HISTORY_RECORD_ENERGY] = "energy",
+    [HISTORY_RECORD_FALL] = "fall",
+};
+
+static int port = -1;
+static FILE *csv;
+static char positionPath[4096];
+
+static uint32_t getLe(const uint8_t *in, int bytes) {
+    uint32_t value = 0;
+    while (bytes--)
+        value = (value << 8) | in[bytes];
+    return value;
+}
+
+static uint16_t frameCrc(const uint8_t *frame, uint8_t payloadLength) {
+    CRC_SOFT_STATE state;
+    CRC_SoftStart(&state, &CRC_CONFIG_CCITT16);
+    CRC_SoftUpdate(&state, &frame[2], FRAME_HEADER_BYTES - 2 + payloadLength);
+    return (uint16_t)CRC_SoftFinish(&state);
+}
+
+static void sendFrame(uint8_t type, uint16_t seq, const uint8_t *payload, uint8_t length) {
+    uint8_t frame[FRAME_MAX_BYTES];
+    uint16_t crc;
+
+    frame[0] = HISTORY_EXPORT_SYNC0;
+    frame[1] = HISTORY_EXPORT_SYNC1;
+    frame[2] = type;
+    frame[3] = seq & 0xFF;
+    frame[4] = seq >> 8;
+    frame[5] = length;
+    memcpy(&frame[FRAME_HEADER_BYTES], payload, length);
+    crc = frameCrc(frame, length);
+    frame[FRAME_HEADER_BYTES + length] = crc & 0xFF;
+    frame[FRAME_HEADER_BYTES + length + 1] = crc >> 8;
+    if (write(port, frame, FRAME_HEADER_BYTES + length + 2) < 0)
+        perror("write");
+}
+
+static void sendStart(uint32_t position) {
+    uint8_t payload[4] = {position & 0xFF, (position >> 8) & 0xFF, (position >> 16) & 0xFF, position >> 24};
+    sendFrame(HISTORY_EXPORT_START, 0, payload, sizeof(payload));
+}
+
+static int openPort(const char *path) {
+    struct termios tty;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+        return -1;
+    if (tcgetattr(fd, &tty) != 0) {
+        close(fd);
+        return -1;
+    }
+    cfmakeraw(&tty);
+    cfsetispeed(&tty, B500000);
+    cfsetospeed(&tty, B500000);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        close(fd);
+        return -1;
+    }
+    tcflush(fd, TCIOFLUSH);
+    return fd;
+}
+
+static bool loadPosition(uint32_t *position) {
+    FILE *file = fopen(positionPath, "r");
+    unsigned long value;
+    bool ok;
+
+    if (file == NULL)
+        return false;
+    ok = (fscanf(file, "%lu", &value) == 1);
+    fclose(file);
+    *position = value;
+    return ok;
+}
+
+// Written after the rows are flushed, so a crash at worst repeats a frame
+static void storePosition(uint32_t position) {
+    char temporary[4096 + 4];
+    FILE *file;
+
+    snprintf(temporary, sizeof(temporary), "%s.tmp", positionPath);
+    file = fopen(temporary, "w");
+    if (file == NULL) {
+        perror(temporary);
+        return;
+    }
+    fprintf(file, "%lu\n", (unsigned long)position);
+    fclose(file);
+    rename(temporary, positionPath);
+}
+
+static void writeRow(const char *type, uint32_t timestamp, unsigned value) {
+    uint16_t dayOfYear = timestamp / (24 * 60);
+    uint16_t minuteOfDay = timestamp % (24 * 60);
+    int month = 12;
+
+    while (month > 1 && DAYS_BEFORE_MONTH[month - 1] > dayOfYear)
+        month--;
+    fprintf(csv, "%s,%lu,%02d-%02u,%02u:%02u,%u\n", type, (unsigned long)timestamp, month,
+            dayOfYear - DAYS_BEFORE_MONTH[month - 1] + 1, minuteOfDay / 60, minuteOfDay % 60, value);
+}
+
+static void writeStepBlock(uint32_t end, const uint8_t *blob, uint8_t length) {
+    HistoryCodecDecoder decoder;
+    HistoryCodecSegment segment;
+
+    if (length == 0 || blob[0] > end)
+        return;
+    historyCodecDecoderStart(&decoder, end - blob[0], &blob[1], length - 1);
+    while (historyCodecDecodeNext(&decoder, &segment)) {
+        if (segment.count > 0)
+            writeRow("steps", segment.timestamp, segment.count);
+    }
+}
+
+// False if the payload is malformed; nothing is written then
+static bool writeRecords(const uint8_t *payload, uint8_t length) {
+    uint8_t offset;
+
+    for (offset = 4; offset < length; ) {
+        uint8_t type = payload[offset];
+        uint16_t value = getLe(&payload[offset + 4], 2);
+        uint8_t blobBytes = (type == HISTORY_RECORD_STEP_BLOCK) ? value : 0;
+        if (offset + 6 + blobBytes > length)
+            return false;
+        offset += 6 + blobBytes;
+    }
+    for (offset = 4; offset < length; ) {
+        uint8_t type = payload[offset];
+        uint32_t timestamp = getLe(&payload[offset + 1], 3);
+        uint16_t value = getLe(&payload[offset + 4], 2);
+        if (type == HISTORY_RECORD_STEP_BLOCK) {
+            writeStepBlock(timestamp, &payload[offset + 6], value);
+            offset += 6 + value;
+            continue;
+        }
+        if (TYPE_NAMES[type & 0xF] != NULL)
+            writeRow(TYPE_NAMES[type & 0xF], timestamp, value);
+        offset += 6;
+    }
+    return true;
+}
+
+static long long nowMs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+int main(int argc, char **argv) {
+    uint8_t frame[FRAME_MAX_BYTES];
+    int frameCount = 0;
+    uint32_t position = 0;
+    uint16_t expected = 0;
+    int32_t nakSent = -1;           // expected seq a nak was last sent for
+    bool resuming;
+    long long lastFrame;
+    long long lastStart;
+    unsigned long frames = 0;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <serial device> <output.csv>\n", argv[0]);
+        return 2;
+    }
+    snprintf(positionPath, sizeof(positionPath), "%s.pos", argv[2]);
+    resuming = loadPosition(&position);
+
+    port = openPort(argv[1]);
+    if (port < 0) {
+        perror(argv[1]);
+        return 1;
+    }
+    csv = fopen(argv[2], resuming ? "a" : "w");
+    if (csv == NULL) {
+        perror(argv[2]);
+        return 1;
+    }
+    if (!resuming)
+        fprintf(csv, "type,timestamp,date,time,value\n");
+    fprintf(stderr, "%s from position %lu\n", resuming ? "resuming" : "starting", (unsigned long)position);
+
+    sendStart(position);
+    lastFrame = lastStart = nowMs();
+    for (;;) {
+        fd_set readable;
+        struct timeval timeout = {0, 100000};
+        uint8_t chunk[256];
+        ssize_t count;
+
+        if (nowMs() - lastFrame > SILENCE_GIVE_UP_MS) {
+            fprintf(stderr, "no answer from the watch, stopped at position %lu\n", (unsigned long)position);
+            return 1;
+        }
+        FD_ZERO(&readable);
+        FD_SET(port, &readable);
+        if (select(port + 1, &readable, NULL, NULL, &timeout) <= 0) {
+            // A watch that rebooted or dropped the session restarts from
+            // the last stored frame
+            if (nowMs() - lastFrame > SILENCE_RESTART_MS && nowMs() - lastStart > SILENCE_RESTART_MS) {
+                sendStart(position);
+                lastStart = nowMs();
+                expected = 0;
+                nakSent = -1;
+            }
+            continue;
+        }
+        count = read(port, chunk, sizeof(chunk));
+        if (count < 0 && errno != EINTR && errno != EAGAIN) {
+            perror("read");
+            return 1;
+        }
+
+        for (ssize_t i = 0; i < count; i++) {
+            uint8_t byte = chunk[i];
+            if ((frameCount == 0 && byte != HISTORY_EXPORT_SYNC0) ||
+                (frameCount == 1 && byte != HISTORY_EXPORT_SYNC1)) {
+                frameCount = (byte == HISTORY_EXPORT_SYNC0) ? 1 : 0;
+                frame[0] = byte;
+                continue;
+            }
+            frame[frameCount++] = byte;
+            if (frameCount < FRAME_HEADER_BYTES ||
+                frameCount < FRAME_HEADER_BYTES + frame[5] + 2)
+                continue;
+            frameCount = 0;
+
+            uint8_t length = frame[5];
+            uint8_t type = frame[2];
+            uint16_t seq = getLe(&frame[3], 2);
+            const uint8_t *payload = &frame[FRAME_HEADER_BYTES];
+            if (getLe(&payload[length], 2) != frameCrc(frame, length) || length < 4)
+                continue;
+            lastFrame = nowMs();
+
+            if (seq != expected) {
+                // Ahead: one was lost, ask for it once. Behind: a resend
+                // of a frame already stored, so the ack was lost
+                if ((int16_t)(seq - expected) > 0) {
+                    if (nakSent != expected) {
+                        sendFrame(HISTORY_EXPORT_NAK, expected, NULL, 0);
+                        nakSent = expected;
+                    }
+                } else {
+                    sendFrame(HISTORY_EXPORT_ACK, expected, NULL, 0);
+                }
+                continue;
+            }
+            // The CRC held, so a resend would carry the same bytes
+            if (type == HISTORY_EXPORT_DATA && !writeRecords(payload, length))
+                fprintf(stderr, "malformed frame %u skipped\n", seq);
+            fflush(csv);
+            position = getLe(payload, 4);
+            storePosition(position);
+            expected++;
+            frames++;
+            sendFrame(HISTORY_EXPORT_ACK, expected, NULL, 0);
+            if (type == HISTORY_EXPORT_END) {
+                fclose(csv);
+                fprintf(stderr, "done: %lu frames, log position %lu\n", frames, (unsigned long)position);
+                return 0;
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/*
+ * File: uart1_driver.c
+ * Project: Smart Watch - Final Version
+ * Description: Interrupt-driven UART1 with software ring buffers.
+ *
+ * Each ring has one writer and one reader: the main loop produces TX bytes
+ * and consumes RX bytes, the interrupts do the opposite, so the free-running
+ * 16-bit indices need no locking. The TX interrupt disables itself when
+ * the ring runs dry; a write re-enables it and raises the flag by hand,
+ * since an already empty FIFO would not raise it again.
+ */
+
+#include <xc.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../System/clock.h"
+#include "uart1_driver.h"
+
+#define UART1_TX_PPS_OUTPUT     RPOR10bits.RP20R
+#define UART1_RX_RP             21
+#define PPS_FN_U1TX             3
+
+static uint8_t txBuffer[UART1_TX_BUFFER_SIZE];
+static uint8_t rxBuffer[UART1_RX_BUFFER_SIZE];
+static volatile uint16_t txHead, txTail;
+static volatile uint16_t rxHead, rxTail;
+
+void uart1_open(uint32_t baud)
+{
+    txHead = txTail = 0;
+    rxHead = rxTail = 0;
+
+    TRISCbits.TRISC4 = 0;
+    TRISCbits.TRISC5 = 1;
+    __builtin_write_OSCCONL(OSCCON & 0xbf); // unlock PPS
+    UART1_TX_PPS_OUTPUT = PPS_FN_U1TX;
+    RPINR18bits.U1RXR = UART1_RX_RP;
+    __builtin_write_OSCCONL(OSCCON | 0x40); // lock PPS
+
+    U1MODE = 0;
+    U1MODEbits.BRGH = 1;
+    U1BRG = (CLOCK_PeripheralFrequencyGet() / 4 + baud / 2) / baud - 1;
+    U1STA = 0;
+    U1STAbits.UTXISEL1 = 1;                 // interrupt when the TX FIFO empties
+    U1STAbits.UTXISEL0 = 0;
+
+    IPC3bits.U1TXIP = 2;
+    IPC2bits.U1RXIP = 2;
+    IFS0bits.U1RXIF = 0;
+    IEC0bits.U1RXIE = 1;
+    IEC0bits.U1TXIE = 0;
+
+    U1MODEbits.UARTEN = 1;
+    U1STAbits.UTXEN = 1;
+}
+
+void uart1_close(void)
+{
+    IEC0bits.U1TXIE = 0;
+    IEC0bits.U1RXIE = 0;
+    U1MODEbits.UARTEN = 0;
+}
+
+uint16_t uart1_txFree(void)
+{
+    return UART1_TX_BUFFER_SIZE - (uint16_t)(txHead - txTail);
+}
+
+bool uart1_write(const uint8_t *data, uint16_t length)
+{
+    uint16_t head = txHead;
+
+    if(length > uart1_txFree())
+    {
+        return false;
+    }
+    while(length--)
+    {
+        txBuffer[head++ & (UART1_TX_BUFFER_SIZE - 1)] = *data++;
+    }
+    txHead = head;
+    IEC0bits.U1TXIE = 1;
+    IFS0bits.U1TXIF = 1;
+    return true;
+}
+
+bool uart1_isTxDone(void)
+{
+    return txHead == txTail && U1STAbits.TRMT;
+}
+
+bool uart1_read(uint8_t *byte)
+{
+    if(rxHead == rxTail)
+    {
+        return false;
+    }
+    *byte = rxBuffer[rxTail & (UART1_RX_BUFFER_SIZE - 1)];
+    rxTail++;
+    return true;
+}
+
+void __attribute__((__interrupt__, auto_psv)) _U1TXInterrupt(void)
+{
+    uint16_t tail = txTail;
+
+    IFS0bits.U1TXIF = 0;
+    while(tail != txHead && !U1STAbits.UTXBF)
+    {
+        U1TXREG = txBuffer[tail++ & (UART1_TX_BUFFER_SIZE - 1)];
+    }
+    txTail = tail;
+    if(tail == txHead)
+    {
+        IEC0bits.U1TXIE = 0;
+    }
+}
+
+void __attribute__((__interrupt__, auto_psv)) _U1RXInterrupt(void)
+{
+    IFS0bits.U1RXIF = 0;
+    while(U1STAbits.URXDA)
+    {
+        uint8_t byte = U1RXREG;
+        if((uint16_t)(rxHead - rxTail) < UART1_RX_BUFFER_SIZE)
+        {
+            rxBuffer[rxHead & (UART1_RX_BUFFER_SIZE - 1)] = byte;
+            rxHead++;
+        }
+    }
+    if(U1STAbits.OERR)
+    {
+        U1STAbits.OERR = 0;                 // reception stops until cleared
+    }
+}
@@ -0,0 +1,35 @@
+/*
+ * File: uart1_driver.h
+ * Project: Smart Watch - Final Version
+ * Description: Interrupt-driven UART1 with software ring buffers.
+ *
+ * Writes only copy into the transmit ring; the TX interrupt moves bytes
+ * into the hardware FIFO whenever it empties, so the main loop never waits
+ * on the line. Received bytes are queued by the RX interrupt the same way.
+ * TX is on RC4 (RP20), RX on RC5 (RP21), 8N1.
+ */
+
+#ifndef UART1_DRIVER_H
+#define UART1_DRIVER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART1_TX_BUFFER_SIZE    256     /* power of two */
+#define UART1_RX_BUFFER_SIZE    32      /* power of two */
+
+/* BRGH = 1: baud = FCY / (4 * (BRG + 1)), exact for FCY / 4n */
+void uart1_open(uint32_t baud);
+void uart1_close(void);
+
+/* Queues all length bytes, or none when the ring lacks room for them */
+bool uart1_write(const uint8_t *data, uint16_t length);
+uint16_t uart1_txFree(void);
+/* Ring and shift register both empty */
+bool uart1_isTxDone(void);
+
+/* False when nothing has been received. Bytes arriving while the ring is
+   full are dropped; the protocol above is expected to notice. */
+bool uart1_read(uint8_t *byte);
+
+#endif // UART1_DRIVER_H